@@ -0,0 +1,335 @@
+# #%L
+# OME C++ libraries (cmake build infrastructure)
+# %%
+# Copyright © 2006 - 2026 Open Microscopy Environment:
+#   - Massachusetts Institute of Technology
+#   - National Institutes of Health
+#   - University of Dundee
+#   - Board of Regents of the University of Wisconsin-Madison
+#   - Glencoe Software, Inc.
+# %%
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+#    this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+# The views and conclusions contained in the software and documentation are
+# those of the authors and should not be interpreted as representing official
+# policies, either expressed or implied, of any organization.
+# #L%
+
+# Decode an XML attribute value.
+#
+# value - the raw attribute value, without quotes
+# var - the variable to set to the decoded value
+# context - description of the value for error messages
+#
+# Whitespace is normalised, and the predefined entities and character
+# references are replaced.  Other entities, non-ASCII character
+# references, and values containing a semicolon (which can't be
+# represented in a CMake list) are rejected.
+function(_ome_catalog_decode value var context)
+  string(REGEX REPLACE "[\t\r\n]" " " value "${value}")
+  string(REPLACE "&lt;" "<" value "${value}")
+  string(REPLACE "&gt;" ">" value "${value}")
+  string(REPLACE "&quot;" "\"" value "${value}")
+  string(REPLACE "&apos;" "'" value "${value}")
+
+  while(value MATCHES "&#(x[0-9a-fA-F]+|[0-9]+);")
+    set(ref "${CMAKE_MATCH_1}")
+    if(ref MATCHES "^x(.*)$")
+      string(TOLOWER "${CMAKE_MATCH_1}" digits)
+      set(code 0)
+      string(LENGTH "${digits}" length)
+      math(EXPR last "${length} - 1")
+      foreach(index RANGE ${last})
+        string(SUBSTRING "${digits}" ${index} 1 digit)
+        string(FIND "0123456789abcdef" "${digit}" digit)
+        math(EXPR code "${code} * 16 + ${digit}")
+      endforeach()
+    else()
+      set(code "${ref}")
+    endif()
+    if(code LESS 32 OR code GREATER 126)
+      message(FATAL_ERROR "${context}: character reference &#${ref}; is not supported in embedded catalogs")
+    endif()
+    string(ASCII ${code} char)
+    string(REPLACE "&#${ref};" "${char}" value "${value}")
+  endwhile()
+
+  string(REPLACE "&amp;" "&amp" value "${value}")
+  if(value MATCHES "&[^a]|&a[^m]|&am[^p]|&$|&a$|&am$")
+    message(FATAL_ERROR "${context}: entity references are not supported in embedded catalogs")
+  endif()
+  string(REPLACE "&amp" "&" value "${value}")
+
+  if(value MATCHES ";")
+    message(FATAL_ERROR "${context}: semicolons are not supported in embedded catalogs")
+  endif()
+
+  set(${var} "${value}" PARENT_SCOPE)
+endfunction()
+
+# Parse the entries of an XML catalog.
+#
+# file - the catalog to parse
+# entries_var - the variable to set to the list of uri entries, as
+#               alternating system IDs and raw filenames
+# catalogs_var - the variable to set to the list of nested catalog
+#                raw filenames
+#
+# This implements the same subset of the catalog format as
+# EntityResolver::registerCatalog(): only uri and nextCatalog
+# elements which are direct children of the root element are used,
+# matched by local name, with unprefixed name, uri and catalog
+# attributes.  Catalogs containing a DOCTYPE, CDATA sections or
+# malformed markup are rejected, rather than risk resolving
+# differently from the runtime parser.
+function(_ome_catalog_parse file entries_var catalogs_var)
+  file(READ "${file}" content)
+  string(REGEX REPLACE "<!--([^-]|-[^-])*-->" "" content "${content}")
+  if(content MATCHES "<!")
+    message(FATAL_ERROR "XML catalog ${file}: DOCTYPE declarations and CDATA sections are not supported in embedded catalogs")
+  endif()
+
+  set(tag_regex "<[^<>\"']*((\"[^\"]*\"|'[^']*')[^<>\"']*)*>")
+  set(attr_regex "^[ \t\r\n]+([^ \t\r\n=/>]+)[ \t\r\n]*=[ \t\r\n]*(\"[^\"]*\"|'[^']*')")
+
+  set(entries)
+  set(catalogs)
+  set(depth 0)
+
+  # Walk the tags in order, without using a list (which would split
+  # on semicolons in the content).
+  string(FIND "${content}" "<" start)
+  while(NOT start EQUAL -1)
+    string(SUBSTRING "${content}" ${start} -1 content)
+    string(REGEX MATCH "^${tag_regex}" tag "${content}")
+    if(NOT tag)
+      message(FATAL_ERROR "XML catalog ${file}: malformed markup")
+    endif()
+    string(LENGTH "${tag}" length)
+    string(SUBSTRING "${content}" ${length} -1 content)
+    string(FIND "${content}" "<" start)
+
+    if(tag MATCHES "^<[?]")
+      continue() # XML declaration or processing instruction
+    elseif(tag MATCHES "^</")
+      math(EXPR depth "${depth} - 1")
+      continue()
+    endif()
+
+    if(depth EQUAL 1)
+      string(REGEX MATCH "^<([^ \t\r\n/>]+)" qname "${tag}")
+      string(REGEX REPLACE "^<([^ \t\r\n/>]+:)?" "" local "${qname}")
+      string(LENGTH "${qname}" length)
+      string(SUBSTRING "${tag}" ${length} -1 attrs)
+
+      foreach(attr name uri catalog)
+        unset(attr_${attr})
+      endforeach()
+      while(attrs MATCHES "${attr_regex}")
+        set(attr "${CMAKE_MATCH_1}")
+        set(value "${CMAKE_MATCH_2}")
+        string(LENGTH "${CMAKE_MATCH_0}" length)
+        string(SUBSTRING "${attrs}" ${length} -1 attrs)
+        if(attr MATCHES "^(name|uri|catalog)$")
+          string(LENGTH "${value}" length)
+          math(EXPR length "${length} - 2")
+          string(SUBSTRING "${value}" 1 ${length} value)
+          _ome_catalog_decode("${value}" attr_${attr} "XML catalog ${file}: ${attr} attribute")
+        endif()
+      endwhile()
+      if(NOT attrs MATCHES "^[ \t\r\n]*/?>$")
+        message(FATAL_ERROR "XML catalog ${file}: malformed element ${qname}")
+      endif()
+
+      if(local MATCHES "^uri$")
+        if(DEFINED attr_uri AND DEFINED attr_name)
+          list(APPEND entries "${attr_name}" "${attr_uri}")
+        endif()
+      elseif(local MATCHES "^nextCatalog$")
+        if(DEFINED attr_catalog)
+          list(APPEND catalogs "${attr_catalog}")
+        endif()
+      endif()
+    endif()
+
+    if(NOT tag MATCHES "/>$")
+      math(EXPR depth "${depth} + 1")
+    endif()
+  endwhile()
+
+  set(${entries_var} "${entries}" PARENT_SCOPE)
+  set(${catalogs_var} "${catalogs}" PARENT_SCOPE)
+endfunction()
+
+# Generate a C++ source file embedding the XML schemas registered in
+# an XML catalog, and any catalogs it references with nextCatalog.
+#
+# catalog - the XML catalog to embed
+# output - the C++ source file to generate
+#
+# The catalogs are walked here, at configure time, so that no catalog
+# parsing or filesystem access is needed at run time.  The catalogs
+# and schemas are added to the configure dependencies, so that
+# changing any of them regenerates the source.  Catalogs which can't
+# be read in exactly the same way as by the runtime catalog parser
+# are rejected; see _ome_catalog_parse().
+function(ome_embed_schema_catalog catalog output)
+  get_filename_component(catalog "${catalog}" REALPATH)
+  if(catalog MATCHES ";")
+    message(FATAL_ERROR "XML catalog ${catalog}: semicolons are not supported in embedded catalog filenames")
+  endif()
+
+  set(pending "${catalog}")
+  set(visited)
+  set(ids)
+  set(files)
+
+  while(pending)
+    list(GET pending 0 current)
+    list(REMOVE_AT pending 0)
+
+    list(FIND visited "${current}" seen)
+    if(NOT seen EQUAL -1)
+      message(WARNING "XML catalog ${current} contains a recursive reference")
+      continue()
+    endif()
+    list(APPEND visited "${current}")
+
+    if(NOT EXISTS "${current}")
+      message(FATAL_ERROR "Failed to load XML catalog from file ${current}")
+    endif()
+
+    get_filename_component(currentdir "${current}" DIRECTORY)
+    _ome_catalog_parse("${current}" entries catalogs)
+
+    while(entries)
+      list(GET entries 0 id)
+      list(GET entries 1 uri)
+      list(REMOVE_AT entries 0 1)
+
+      get_filename_component(file "${currentdir}/${uri}" REALPATH)
+      if(NOT EXISTS "${file}")
+        message(FATAL_ERROR "XML schema id ${id} in catalog ${current}: file ${file} does not exist")
+      endif()
+      list(FIND ids "${id}" existing)
+      if(existing EQUAL -1)
+        list(APPEND ids "${id}")
+        list(APPEND files "${file}")
+      else()
+        list(GET files ${existing} existing_file)
+        if(NOT existing_file STREQUAL file)
+          message(FATAL_ERROR "Mismatch registering entity id ${id}: File ${file} does not match existing file ${existing_file}")
+        endif()
+      endif()
+    endwhile()
+
+    foreach(nextcatalog ${catalogs})
+      get_filename_component(nextcatalog "${currentdir}/${nextcatalog}" REALPATH)
+      list(APPEND pending "${nextcatalog}")
+    endforeach()
+  endwhile()
+
+  list(LENGTH ids count)
+  if(count EQUAL 0)
+    message(FATAL_ERROR "XML catalog ${catalog} does not register any schemas")
+  endif()
+
+  # Match 16 bytes per line of the generated arrays.
+  set(line_pattern "")
+  foreach(byte RANGE 1 16)
+    set(line_pattern "${line_pattern}0x[0-9a-f][0-9a-f],")
+  endforeach()
+
+  # Each file is embedded once, even if registered under several IDs.
+  set(data "")
+  set(table "")
+  set(embedded)
+  set(sizes)
+  math(EXPR last "${count} - 1")
+  foreach(index RANGE ${last})
+    list(GET ids ${index} id)
+    list(GET files ${index} file)
+
+    list(FIND embedded "${file}" schema)
+    if(schema EQUAL -1)
+      list(LENGTH embedded schema)
+      list(APPEND embedded "${file}")
+
+      file(READ "${file}" hex HEX)
+      string(LENGTH "${hex}" length)
+      math(EXPR size "${length} / 2")
+      list(APPEND sizes ${size})
+      # Terminate with a null byte (not included in the size), which
+      # also ensures the array is never empty.
+      string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}00")
+      string(REGEX REPLACE "(${line_pattern})" "\\1\n    " bytes "${bytes}")
+      string(REGEX REPLACE "\n +$" "" bytes "${bytes}")
+
+      set(data "${data}  // ${file}\n  const unsigned char schema${schema}[] =\n    {\n    ${bytes}\n    };\n\n")
+    endif()
+
+    list(GET sizes ${schema} size)
+    string(REPLACE "\\" "\\\\" cid "${id}")
+    string(REPLACE "\"" "\\\"" cid "${cid}")
+
+    set(table "${table}          { \"${cid}\", schema${schema}, ${size} },\n")
+  endforeach()
+
+  set(source "// Generated from ${catalog}; do not edit.
+
+#include <ome/common/xml/EmbeddedSchemas.h>
+
+namespace
+{
+
+${data}}
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace detail
+      {
+
+        const embedded_schema embedded_schemas[] =
+          {
+${table}          };
+
+        const std::size_t embedded_schema_count = ${count};
+
+      }
+    }
+  }
+}
+")
+
+  # Only replace the output when changed, to avoid needless rebuilds.
+  file(WRITE "${output}.tmp" "${source}")
+  configure_file("${output}.tmp" "${output}" COPYONLY)
+  file(REMOVE "${output}.tmp")
+
+  set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${visited} ${files})
+
+  message(STATUS "Embedding ${count} XML schemas from ${catalog}")
+endfunction()
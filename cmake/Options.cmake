@@ -22,6 +22,16 @@ if(relocatable-install)
   set(OME_COMMON_INSTALL_PREFIX "")
 endif()
 
+# XML schemas to embed in the library.  If set to an XML catalog, the
+# schemas it registers (including those of any nested catalogs) are
+# compiled into the library, and may be registered with an
+# EntityResolver without any filesystem access.
+set(embedded-schema-catalog "" CACHE FILEPATH "XML catalog of schemas to embed in the library (empty to disable)")
+set(OME_HAVE_EMBEDDED_SCHEMAS OFF)
+if(embedded-schema-catalog)
+  set(OME_HAVE_EMBEDDED_SCHEMAS ON)
+endif()
+
 # Doxygen documentation
 find_package(Doxygen)
 set(DOXYGEN_DEFAULT OFF)
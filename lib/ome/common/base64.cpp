@@ -0,0 +1,1008 @@
+/*
+ * #%L
+ * OME-COMMON C++ library for C++ compatibility/portability
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#include <ome/common/base64.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  define OME_COMMON_BASE64_X86 1
+#  include <immintrin.h>
+#endif
+
+namespace
+{
+
+  using ome::common::detail::base64_kernel;
+
+  /// Base64 alphabet.
+  const char base64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz"
+    "0123456789+/";
+
+  /// URL and filename safe Base64 alphabet.
+  const char base64_url_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz"
+    "0123456789-_";
+
+  /**
+   * Full character to value mapping for the scalar kernel.
+   *
+   * Values 0-63 are valid; 255 is used for all other characters,
+   * including whitespace and padding, so that a single test for the
+   * high bit detects the end of a run of valid input.
+   */
+  struct base64_decode_table
+  {
+    uint8_t values[256];
+    /// As values, for the URL and filename safe alphabet.
+    uint8_t url_values[256];
+    /// 1 for whitespace, 0 otherwise.
+    uint8_t space[256];
+
+    base64_decode_table()
+    {
+      std::memset(values, 255, sizeof(values));
+      std::memset(url_values, 255, sizeof(url_values));
+      for (uint8_t i = 0; i < 64; ++i)
+        {
+          values[static_cast<unsigned char>(base64_chars[i])] = i;
+          url_values[static_cast<unsigned char>(base64_url_chars[i])] = i;
+        }
+      for (int i = 0; i < 256; ++i)
+        space[i] = std::isspace(i) ? 1U : 0U;
+    }
+  };
+
+  const base64_decode_table decode_table;
+
+  std::size_t
+  count_whitespace(const unsigned char *begin,
+                   const unsigned char *end)
+  {
+    std::size_t whitespace = 0U;
+    for (const unsigned char *c = begin; c != end; ++c)
+      whitespace += decode_table.space[*c];
+    return whitespace;
+  }
+
+  std::size_t
+  encode_scalar(const uint8_t *input,
+                std::size_t    size,
+                char          *output,
+                const char    *chars = base64_chars)
+  {
+    const uint8_t *in = input;
+    const uint8_t *end = input + ((size / 3U) * 3U);
+    char *out = output;
+
+    for (; in != end; in += 3, out += 4)
+      {
+        uint32_t group = (static_cast<uint32_t>(in[0]) << 16) |
+          (static_cast<uint32_t>(in[1]) << 8) |
+          static_cast<uint32_t>(in[2]);
+        out[0] = chars[(group >> 18) & 0x3F];
+        out[1] = chars[(group >> 12) & 0x3F];
+        out[2] = chars[(group >> 6) & 0x3F];
+        out[3] = chars[group & 0x3F];
+      }
+
+    return static_cast<std::size_t>(out - output);
+  }
+
+  std::size_t
+  decode_scalar(const char    *input,
+                std::size_t    size,
+                uint8_t       *output,
+                const uint8_t *values = decode_table.values)
+  {
+    const unsigned char *in = reinterpret_cast<const unsigned char *>(input);
+    const unsigned char *end = in + ((size / 4U) * 4U);
+    uint8_t *out = output;
+
+    for (; in != end; in += 4, out += 3)
+      {
+        uint8_t a = values[in[0]];
+        uint8_t b = values[in[1]];
+        uint8_t c = values[in[2]];
+        uint8_t d = values[in[3]];
+        if ((a | b | c | d) & 0x80)
+          break; // Whitespace, padding or invalid; leave for caller.
+        out[0] = static_cast<uint8_t>(a << 2 | b >> 4);
+        out[1] = static_cast<uint8_t>(b << 4 | c >> 2);
+        out[2] = static_cast<uint8_t>(c << 6 | d);
+      }
+
+    return static_cast<std::size_t>(reinterpret_cast<const char *>(in) - input);
+  }
+
+#ifdef OME_COMMON_BASE64_X86
+
+  // The vector kernels use the approach described by Wojciech Muła
+  // ("Base64 encoding and decoding with SIMD instructions"): bytes
+  // are split into sextets with multiplies and shuffles, and the
+  // alphabet is translated and validated using nibble lookup tables.
+
+  __attribute__((target("sse4.1")))
+  inline __m128i
+  encode_translate_sse41(__m128i indices)
+  {
+    // Offsets from sextet value to character, selected by range.
+    const __m128i offsets = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4,
+                                          -4, -4, -4, -4, -19, -16, 0, 0);
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    range = _mm_sub_epi8(range, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range));
+  }
+
+  __attribute__((target("sse4.1")))
+  inline __m128i
+  encode_split_sse41(__m128i in)
+  {
+    // Duplicate bytes so each 32-bit lane holds one three-byte group.
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                           4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+  }
+
+  __attribute__((target("sse4.1")))
+  std::size_t
+  encode_sse41(const uint8_t *input,
+               std::size_t    size,
+               char          *output)
+  {
+    const uint8_t *in = input;
+    char *out = output;
+
+    // 16 bytes are loaded, of which 12 are used.
+    while (size >= 16U)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+        v = encode_translate_sse41(encode_split_sse41(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), v);
+        in += 12;
+        out += 16;
+        size -= 12U;
+      }
+
+    return static_cast<std::size_t>(out - output) + encode_scalar(in, size, out);
+  }
+
+  __attribute__((target("sse4.1")))
+  inline bool
+  decode_translate_sse41(__m128i& v)
+  {
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                           0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2F = _mm_set1_epi8(0x2F);
+
+    const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(v, 4), mask_2F);
+    const __m128i lo_nibbles = _mm_and_si128(v, mask_2F);
+    const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    if (!_mm_testz_si128(lo, hi))
+      return false; // Not in the alphabet.
+    const __m128i eq_2F = _mm_cmpeq_epi8(v, mask_2F);
+    const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2F, hi_nibbles));
+    v = _mm_add_epi8(v, roll);
+    return true;
+  }
+
+  __attribute__((target("sse4.1")))
+  inline __m128i
+  decode_pack_sse41(__m128i v)
+  {
+    const __m128i merged = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+    v = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                             8, 14, 13, 12, -1, -1, -1, -1));
+  }
+
+  __attribute__((target("sse4.1")))
+  std::size_t
+  decode_sse41(const char  *input,
+               std::size_t  size,
+               uint8_t     *output)
+  {
+    const char *in = input;
+    uint8_t *out = output;
+    // 16 bytes are stored, of which 12 are used; don't overrun.
+    const uint8_t *out_end = output + ((size / 4U) * 3U);
+
+    while (size >= 16U && out + 16 <= out_end)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+        if (!decode_translate_sse41(v))
+          break;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), decode_pack_sse41(v));
+        in += 16;
+        out += 12;
+        size -= 16U;
+      }
+
+    return static_cast<std::size_t>(in - input) + decode_scalar(in, size, out);
+  }
+
+  __attribute__((target("avx2")))
+  std::size_t
+  encode_avx2(const uint8_t *input,
+              std::size_t    size,
+              char          *output)
+  {
+    const uint8_t *in = input;
+    char *out = output;
+
+    const __m256i split = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                           7, 6, 8, 7, 10, 9, 11, 10,
+                                           1, 0, 2, 1, 4, 3, 5, 4,
+                                           7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i offsets = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4,
+                                             -4, -4, -4, -4, -19, -16, 0, 0,
+                                             65, 71, -4, -4, -4, -4, -4, -4,
+                                             -4, -4, -4, -4, -19, -16, 0, 0);
+
+    // Two 12-byte groups are loaded into separate lanes; 28 bytes
+    // must be readable.
+    while (size >= 28U)
+      {
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in))),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 12)), 1);
+        v = _mm256_shuffle_epi8(v, split);
+        const __m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0FC0FC00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003F03F0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+        __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        range = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)));
+        v = _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), v);
+        in += 24;
+        out += 32;
+        size -= 24U;
+      }
+
+    // Avoid AVX-SSE transition penalties in the tail and the caller.
+    _mm256_zeroupper();
+
+    return static_cast<std::size_t>(out - output) + encode_sse41(in, size, out);
+  }
+
+  __attribute__((target("avx2")))
+  std::size_t
+  decode_avx2(const char  *input,
+              std::size_t  size,
+              uint8_t     *output)
+  {
+    const char *in = input;
+    uint8_t *out = output;
+    // 32 bytes are stored, of which 24 are used; don't overrun.
+    const uint8_t *out_end = output + ((size / 4U) * 3U);
+
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2F = _mm256_set1_epi8(0x2F);
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                          8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9,
+                                          8, 14, 13, 12, -1, -1, -1, -1);
+
+    while (size >= 32U && out + 32 <= out_end)
+      {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+        const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(v, 4), mask_2F);
+        const __m256i lo_nibbles = _mm256_and_si256(v, mask_2F);
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm256_testz_si256(lo, hi))
+          break; // Not in the alphabet.
+        const __m256i eq_2F = _mm256_cmpeq_epi8(v, mask_2F);
+        const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2F, hi_nibbles));
+        v = _mm256_add_epi8(v, roll);
+        const __m256i merged = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+        v = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        v = _mm256_shuffle_epi8(v, pack);
+        v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), v);
+        in += 32;
+        out += 24;
+        size -= 32U;
+      }
+
+    // Avoid AVX-SSE transition penalties in the tail and the caller.
+    _mm256_zeroupper();
+
+    return static_cast<std::size_t>(in - input) + decode_sse41(in, size, out);
+  }
+
+#endif // OME_COMMON_BASE64_X86
+
+  base64_kernel
+  detect_kernel()
+  {
+#ifdef OME_COMMON_BASE64_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+      return base64_kernel::AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+      return base64_kernel::SSE41;
+#endif
+    return base64_kernel::SCALAR;
+  }
+
+  /**
+   * Run a task for each index in a range, one thread per index.
+   *
+   * If a thread can't be created, the remaining indices are run
+   * serially on the calling thread.  All started threads are joined
+   * on every exit path, including when the task throws on the
+   * calling thread.
+   *
+   * @param count the number of indices.
+   * @param task the task to run; called as @c task(i).
+   */
+  template<typename Task>
+  void
+  run_parallel(std::size_t count,
+               const Task& task)
+  {
+    struct joiner
+    {
+      ~joiner()
+      {
+        for (auto& thread : threads)
+          thread.join();
+      }
+
+      std::vector<std::thread> threads;
+    } workers;
+
+    std::size_t i = 0U;
+    try
+      {
+        workers.threads.reserve(count);
+        for (; i < count; ++i)
+          workers.threads.emplace_back([&task, i]() { task(i); });
+      }
+    catch (const std::system_error&)
+      {
+        // Out of threads; fall through to run the rest here.
+      }
+    catch (const std::bad_alloc&)
+      {
+      }
+
+    for (; i < count; ++i)
+      task(i);
+  }
+
+}
+
+namespace ome
+{
+  namespace common
+  {
+    namespace detail
+    {
+
+      bool
+      base64_kernel_supported(base64_kernel kernel)
+      {
+        switch(kernel)
+          {
+          case base64_kernel::SCALAR:
+            return true;
+          case base64_kernel::SSE41:
+            return base64_default_kernel() != base64_kernel::SCALAR;
+          case base64_kernel::AVX2:
+            return base64_default_kernel() == base64_kernel::AVX2;
+          default:
+            break;
+          }
+        return false;
+      }
+
+      base64_kernel
+      base64_default_kernel()
+      {
+        static const base64_kernel kernel = detect_kernel();
+        return kernel;
+      }
+
+      std::size_t
+      base64_encode_block(base64_kernel  kernel,
+                          const uint8_t *input,
+                          std::size_t    size,
+                          char          *output)
+      {
+        switch(kernel)
+          {
+#ifdef OME_COMMON_BASE64_X86
+          case base64_kernel::AVX2:
+            return encode_avx2(input, size, output);
+          case base64_kernel::SSE41:
+            return encode_sse41(input, size, output);
+#endif
+          default:
+            break;
+          }
+        return encode_scalar(input, size, output);
+      }
+
+      std::size_t
+      base64_encode_block(const uint8_t *input,
+                          std::size_t    size,
+                          char          *output)
+      {
+        return base64_encode_block(base64_default_kernel(), input, size, output);
+      }
+
+      std::size_t
+      base64_decode_block(base64_kernel  kernel,
+                          const char    *input,
+                          std::size_t    size,
+                          uint8_t       *output)
+      {
+        switch(kernel)
+          {
+#ifdef OME_COMMON_BASE64_X86
+          case base64_kernel::AVX2:
+            return decode_avx2(input, size, output);
+          case base64_kernel::SSE41:
+            return decode_sse41(input, size, output);
+#endif
+          default:
+            break;
+          }
+        return decode_scalar(input, size, output);
+      }
+
+      std::size_t
+      base64_decode_block(const char  *input,
+                          std::size_t  size,
+                          uint8_t     *output)
+      {
+        return base64_decode_block(base64_default_kernel(), input, size, output);
+      }
+
+      std::size_t
+      base64_url_encode_block(const uint8_t *input,
+                              std::size_t    size,
+                              char          *output)
+      {
+        return encode_scalar(input, size, output, base64_url_chars);
+      }
+
+      std::size_t
+      base64_url_decode_block(const char  *input,
+                              std::size_t  size,
+                              uint8_t     *output)
+      {
+        return decode_scalar(input, size, output, decode_table.url_values);
+      }
+
+      void
+      base64_invalid_group(const char *group)
+      {
+        if (std::find(group, group + 4, '=') != group + 4)
+          throw std::runtime_error("Invalid Base64 input: padding only permitted at end of input");
+        throw std::runtime_error("Invalid Base64 input: character outside permitted range");
+      }
+
+      std::size_t
+      base64_compact(const char*& input,
+                     const char*  end,
+                     char        *output,
+                     std::size_t  capacity)
+      {
+        const char *in = input;
+        char *out = output;
+        char *out_end = output + capacity;
+        for (; in != end && out != out_end; ++in)
+          {
+            *out = *in;
+            out += !decode_table.space[static_cast<unsigned char>(*in)];
+          }
+        while (in != end && decode_table.space[static_cast<unsigned char>(*in)])
+          ++in;
+        input = in;
+        return static_cast<std::size_t>(out - output);
+      }
+
+      std::string
+      base64_encode_contiguous(const uint8_t *data,
+                               std::size_t    size,
+                               uint8_t        linebreak)
+      {
+        // Encode buffer size (characters); a multiple of four.
+        const std::size_t block_size = 4096U;
+
+        std::string encoded;
+        std::size_t length = ((size + 2U) / 3U) * 4U;
+        encoded.reserve(length + (linebreak ? length / linebreak : 0U));
+
+        char block[block_size];
+        uint64_t chars = 0U;
+        std::size_t groups = size / 3U;
+        while (groups)
+          {
+            std::size_t count = std::min(groups, block_size / 4U);
+            std::size_t written = base64_encode_block(data, count * 3U, block);
+            data += count * 3U;
+            groups -= count;
+
+            // Append encoded characters, breaking lines as required.
+            const char *pos = block;
+            while (written)
+              {
+                std::size_t line = written;
+                if (linebreak)
+                  line = std::min(line, static_cast<std::size_t>(linebreak - (chars % linebreak)));
+                encoded.append(pos, line);
+                pos += line;
+                written -= line;
+                chars += line;
+                if (linebreak && chars % linebreak == 0)
+                  encoded += '\n';
+              }
+          }
+
+        // Trailing partial group (with padding).
+        switch (size % 3U)
+          {
+          case 1:
+            output_base64_char(encoded, data[0] >> 2, chars++, linebreak);
+            output_base64_char(encoded, (data[0] & 0x3) << 4, chars++, linebreak);
+            encoded += "==";
+            break;
+          case 2:
+            output_base64_char(encoded, data[0] >> 2, chars++, linebreak);
+            output_base64_char(encoded, ((data[0] & 0x3) << 4) | ((data[1] & 0xF0) >> 4), chars++, linebreak);
+            output_base64_char(encoded, (data[1] & 0x0F) << 2, chars++, linebreak);
+            encoded += '=';
+            break;
+          default:
+            break;
+          }
+
+        return encoded;
+      }
+
+    }
+
+    base64_encoder::base64_encoder(uint8_t linebreak):
+      linebreak(linebreak),
+      chars(0U),
+      group(),
+      group_size(0U),
+      pending(),
+      pending_begin(0U),
+      pending_end(0U),
+      finished(false)
+    {
+    }
+
+    void
+    base64_encoder::encode(const uint8_t*& in,
+                           const uint8_t*  in_end,
+                           char*&          out,
+                           char*           out_end)
+    {
+      if (finished && in != in_end)
+        throw std::logic_error("Base64 encoder already finished");
+
+      if (!flush(out, out_end))
+        return;
+
+      // Complete any group left over from the previous call.
+      if (group_size)
+        {
+          while (group_size < 3U && in != in_end)
+            group[group_size++] = *in++;
+          if (group_size < 3U)
+            return;
+          put(group[0] >> 2);
+          put(((group[0] & 0x3) << 4) | ((group[1] & 0xF0) >> 4));
+          put(((group[1] & 0x0F) << 2) | ((group[2] & 0xC0) >> 6));
+          put(group[2] & 0x3F);
+          group_size = 0U;
+          if (!flush(out, out_end))
+            return;
+        }
+
+      while (in_end - in >= 3)
+        {
+          // Encode as many groups as fit in the output and the
+          // current line directly with the block kernel.
+          std::size_t groups = std::min(static_cast<std::size_t>(in_end - in) / 3U,
+                                        static_cast<std::size_t>(out_end - out) / 4U);
+          if (linebreak)
+            groups = std::min(groups, static_cast<std::size_t>(linebreak - (chars % linebreak)) / 4U);
+
+          if (groups)
+            {
+              std::size_t written = detail::base64_encode_block(in, groups * 3U, out);
+              in += groups * 3U;
+              out += written;
+              chars += written;
+              if (linebreak && chars % linebreak == 0)
+                pending[pending_end++] = '\n';
+            }
+          else
+            {
+              // The group straddles a line break, or the output is
+              // full; encode it into the pending output.
+              put(in[0] >> 2);
+              put(((in[0] & 0x3) << 4) | ((in[1] & 0xF0) >> 4));
+              put(((in[1] & 0x0F) << 2) | ((in[2] & 0xC0) >> 6));
+              put(in[2] & 0x3F);
+              in += 3;
+            }
+
+          if (!flush(out, out_end))
+            return;
+        }
+
+      // Keep any trailing partial group for the next call.
+      while (in != in_end)
+        group[group_size++] = *in++;
+    }
+
+    bool
+    base64_encoder::finish(char*& out,
+                           char*  out_end)
+    {
+      if (!finished)
+        {
+          if (!flush(out, out_end))
+            return false;
+
+          switch (group_size)
+            {
+            case 1:
+              put(group[0] >> 2);
+              put((group[0] & 0x3) << 4);
+              pending[pending_end++] = '=';
+              pending[pending_end++] = '=';
+              break;
+            case 2:
+              put(group[0] >> 2);
+              put(((group[0] & 0x3) << 4) | ((group[1] & 0xF0) >> 4));
+              put((group[1] & 0x0F) << 2);
+              pending[pending_end++] = '=';
+              break;
+            default:
+              break;
+            }
+          group_size = 0U;
+          finished = true;
+        }
+
+      return flush(out, out_end);
+    }
+
+    void
+    base64_encoder::reset()
+    {
+      chars = 0U;
+      group_size = 0U;
+      pending_begin = pending_end = 0U;
+      finished = false;
+    }
+
+    bool
+    base64_encoder::flush(char*& out,
+                          char*  out_end)
+    {
+      while (pending_begin != pending_end && out != out_end)
+        *out++ = pending[pending_begin++];
+      if (pending_begin != pending_end)
+        return false;
+      pending_begin = pending_end = 0U;
+      return true;
+    }
+
+    void
+    base64_encoder::put(uint8_t value)
+    {
+      pending[pending_end++] = base64_chars[value];
+      ++chars;
+      if (linebreak && chars % linebreak == 0)
+        pending[pending_end++] = '\n';
+    }
+
+    base64_decoder::base64_decoder():
+      group(),
+      group_size(0U),
+      pad_seen(false),
+      pending(),
+      pending_begin(0U),
+      pending_end(0U)
+    {
+    }
+
+    void
+    base64_decoder::decode(const char*& in,
+                           const char*  in_end,
+                           uint8_t*&    out,
+                           uint8_t*     out_end)
+    {
+      while (flush(out, out_end))
+        {
+          // Decode runs of complete groups which contain no
+          // whitespace or padding directly with the block kernel.
+          // This will typically consume a whole line of input.
+          if (!group_size && !pad_seen)
+            {
+              std::size_t groups = std::min(static_cast<std::size_t>(in_end - in) / 4U,
+                                            static_cast<std::size_t>(out_end - out) / 3U);
+              std::size_t consumed = detail::base64_decode_block(in, groups * 4U, out);
+              in += consumed;
+              out += (consumed / 4U) * 3U;
+            }
+
+          // Collect the next group one character at a time, skipping
+          // whitespace.
+          while (group_size < 4U && in != in_end)
+            {
+              char c = *in++;
+              if (!decode_table.space[static_cast<unsigned char>(c)])
+                group[group_size++] = detail::base64_value(c);
+            }
+          if (group_size < 4U) // End of input (for this call)
+            return;
+          group_size = 0U;
+
+          if (group[0] < 64 && group[1] < 64) // Valid input
+            {
+              if(pad_seen) // Padding only allowed at end.
+                throw std::runtime_error("Invalid Base64 input: padding only permitted at end of input");
+
+              pending[pending_end++] = static_cast<uint8_t>(group[0] << 2 | group[1] >> 4); // Byte 1
+              if (group[2] < 64) // Skip if padded
+                {
+                  pending[pending_end++] = static_cast<uint8_t>(group[1] << 4 | group[2] >> 2); // Byte 2
+                  if (group[3] < 64) // Skip if padded
+                    pending[pending_end++] = static_cast<uint8_t>(group[2] << 6 | group[3]); // Byte 3
+                  else
+                    pad_seen = true;
+                }
+              else
+                {
+                  pad_seen = true;
+                }
+            }
+          else
+            {
+              throw std::runtime_error("Invalid Base64 input: padding encountered unexpectedly");
+            }
+        }
+    }
+
+    bool
+    base64_decoder::finish(uint8_t*& out,
+                           uint8_t*  out_end)
+    {
+      if (group_size) // End of input (unexpected)
+        throw std::runtime_error("Invalid Base64 input: unexpected end of input");
+      return flush(out, out_end);
+    }
+
+    void
+    base64_decoder::reset()
+    {
+      group_size = 0U;
+      pad_seen = false;
+      pending_begin = pending_end = 0U;
+    }
+
+    bool
+    base64_decoder::flush(uint8_t*& out,
+                          uint8_t*  out_end)
+    {
+      while (pending_begin != pending_end && out != out_end)
+        *out++ = pending[pending_begin++];
+      if (pending_begin != pending_end)
+        return false;
+      pending_begin = pending_end = 0U;
+      return true;
+    }
+
+
+    std::size_t
+    base64_decoded_size(const char  *base64,
+                        std::size_t  size)
+    {
+      const unsigned char *in = reinterpret_cast<const unsigned char *>(base64);
+      std::size_t whitespace = count_whitespace(in, in + size);
+
+      // Count trailing padding.
+      std::size_t padding = 0U;
+      for (const char *c = base64 + size; c != base64; --c)
+        {
+          if (c[-1] == '=')
+            ++padding;
+          else if (!decode_table.space[static_cast<unsigned char>(c[-1])])
+            break;
+        }
+
+      return ((size - whitespace - padding) * 3U) / 4U;
+    }
+
+    std::size_t
+    base64_decode_into(const char  *base64,
+                       std::size_t  size,
+                       uint8_t     *output,
+                       std::size_t  capacity)
+    {
+      const char *in = base64;
+      const char *in_end = base64 + size;
+      uint8_t *out = output;
+      uint8_t *out_end = output + capacity;
+
+      base64_decoder decoder;
+      decoder.decode(in, in_end, out, out_end);
+      if (in != in_end || !decoder.finish(out, out_end))
+        throw std::runtime_error("Insufficient space for decoded Base64 output");
+
+      return static_cast<std::size_t>(out - output);
+    }
+
+
+    std::size_t
+    base64_decode_parallel(const char   *base64,
+                           std::size_t   size,
+                           uint8_t      *output,
+                           std::size_t   capacity,
+                           unsigned int  threads)
+    {
+      // Minimum input size per thread; smaller segments are not
+      // worth the cost of starting a thread.
+      const std::size_t min_segment = 65536U;
+
+      if (!threads)
+        threads = std::max(std::thread::hardware_concurrency(), 1U);
+      std::size_t segments = std::min(static_cast<std::size_t>(threads),
+                                      size / min_segment);
+      if (segments < 2U)
+        return base64_decode_into(base64, size, output, capacity);
+
+      const unsigned char *in = reinterpret_cast<const unsigned char *>(base64);
+
+      // Raw segment boundaries, and the number of significant
+      // (non-whitespace) characters in each raw segment.
+      std::vector<std::size_t> bounds(segments + 1U);
+      for (std::size_t i = 0U; i <= segments; ++i)
+        bounds[i] = (size / segments) * i;
+      bounds[segments] = size;
+
+      std::vector<std::size_t> significant(segments);
+      run_parallel(segments,
+                   [&](std::size_t i)
+                   {
+                     significant[i] = bounds[i + 1U] - bounds[i] -
+                       count_whitespace(in + bounds[i], in + bounds[i + 1U]);
+                   });
+
+      // Move each boundary forward to the next group boundary, and
+      // compute where its output starts (assuming no padding before
+      // the end of the input).
+      std::vector<std::size_t> offsets(segments + 1U);
+      offsets[segments] = capacity;
+      std::size_t preceding = 0U;
+      for (std::size_t i = 1U; i < segments; ++i)
+        {
+          preceding += significant[i - 1U];
+          std::size_t skip = (4U - (preceding % 4U)) % 4U;
+          std::size_t pos = bounds[i];
+          while (skip && pos != bounds[i + 1U])
+            {
+              if (!decode_table.space[in[pos]])
+                --skip;
+              ++pos;
+            }
+          if (skip) // Segment too small to contain a group boundary.
+            return base64_decode_into(base64, size, output, capacity);
+          bounds[i] = pos;
+          offsets[i] = ((preceding + 3U) / 4U) * 3U;
+          if (offsets[i] > capacity)
+            return base64_decode_into(base64, size, output, capacity);
+        }
+      offsets[0] = 0U;
+
+      // Decode each segment.  Every segment but the last must be
+      // completely filled; if not, the input contains padding before
+      // the end.
+      std::vector<char> failed(segments, 0);
+      std::size_t last_size = 0U;
+      run_parallel(segments,
+                   [&](std::size_t i)
+                   {
+                     try
+                       {
+                         std::size_t decoded =
+                           base64_decode_into(base64 + bounds[i], bounds[i + 1U] - bounds[i],
+                                              output + offsets[i], offsets[i + 1U] - offsets[i]);
+                         if (i == segments - 1U)
+                           last_size = decoded;
+                         else if (decoded != offsets[i + 1U] - offsets[i])
+                           failed[i] = 1;
+                       }
+                     catch (const std::exception&)
+                       {
+                         failed[i] = 1;
+                       }
+                   });
+
+      // On any failure, decode serially to get the same result or
+      // exception as base64_decode_into().
+      if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+        return base64_decode_into(base64, size, output, capacity);
+
+      return offsets[segments - 1U] + last_size;
+    }
+
+  }
+}
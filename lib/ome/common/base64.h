@@ -39,11 +39,14 @@
 #ifndef OME_COMMON_BASE64_H
 #define OME_COMMON_BASE64_H
 
-#include <cctype>
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace ome
 {
@@ -122,34 +125,1157 @@ namespace ome
       }
 
       /**
-       * Get the next character value from a Base64-encoded string.
+       * Base64 encoding and decoding kernels.
        *
-       * Any whitespace in the string will be automatically skipped.
+       * The vector kernels are only usable if supported by both the
+       * compiler and the CPU in use at runtime.  The scalar kernel is
+       * always available.
+       */
+      enum class base64_kernel
+        {
+          SCALAR, ///< Portable scalar implementation.
+          SSE41,  ///< SSE4.1 implementation (12 bytes per iteration).
+          AVX2    ///< AVX2 implementation (24 bytes per iteration).
+        };
+
+      /**
+       * Check if a Base64 kernel is usable on this system.
+       *
+       * @param kernel the kernel to check.
+       * @returns @c true if supported, @c false otherwise.
+       */
+      bool
+      base64_kernel_supported(base64_kernel kernel);
+
+      /**
+       * Get the fastest Base64 kernel usable on this system.
        *
-       * The returned value will be in the range 0-63 for valid Base64
-       * characters.  98 is used for padding. 255 is used if the end
-       * of the string was reached (used to detect end of valid input
-       * in the presence of trailing whitespace).
+       * The kernel is detected once, upon first use.
        *
-       * @param pos the current position in the string.
-       * @param end the end of the string.
-       * @returns the character value, padding or end of string marker.
-       * @throws std::runtime_error if an invalid character is encountered.
+       * @returns the kernel used by default.
        */
-      inline uint8_t
-      next_base64_value(std::string::const_iterator& pos,
-                        std::string::const_iterator  end)
+      base64_kernel
+      base64_default_kernel();
+
+      /**
+       * Base64-encode a block of complete three-byte groups.
+       *
+       * No padding or line breaks are output.  Any trailing bytes
+       * which do not make up a complete group are not encoded.
+       *
+       * @param kernel the kernel to use.
+       * @param input the bytes to encode.
+       * @param size the number of bytes to encode.
+       * @param output the destination; must have space for
+       * <tt>(size / 3) * 4</tt> characters.
+       * @returns the number of characters written.
+       */
+      std::size_t
+      base64_encode_block(base64_kernel  kernel,
+                          const uint8_t *input,
+                          std::size_t    size,
+                          char          *output);
+
+      /**
+       * Base64-encode a block of complete three-byte groups.
+       *
+       * As for base64_encode_block(base64_kernel, const uint8_t *,
+       * std::size_t, char *), using the default kernel.
+       *
+       * @param input the bytes to encode.
+       * @param size the number of bytes to encode.
+       * @param output the destination; must have space for
+       * <tt>(size / 3) * 4</tt> characters.
+       * @returns the number of characters written.
+       */
+      std::size_t
+      base64_encode_block(const uint8_t *input,
+                          std::size_t    size,
+                          char          *output);
+
+      /**
+       * Base64-decode a block of complete four-character groups.
+       *
+       * Decoding stops at the first group containing a character
+       * which is not part of the Base64 alphabet, including
+       * whitespace and padding.  Such groups, and any trailing
+       * characters which do not make up a complete group, are left
+       * for the caller to handle.
+       *
+       * @param kernel the kernel to use.
+       * @param input the characters to decode.
+       * @param size the number of characters to decode.
+       * @param output the destination; must have space for
+       * <tt>(size / 4) * 3</tt> bytes.
+       * @returns the number of characters consumed (a multiple of
+       * four); three bytes are written for every four characters.
+       */
+      std::size_t
+      base64_decode_block(base64_kernel  kernel,
+                          const char    *input,
+                          std::size_t    size,
+                          uint8_t       *output);
+
+      /**
+       * Base64-decode a block of complete four-character groups.
+       *
+       * As for base64_decode_block(base64_kernel, const char *,
+       * std::size_t, uint8_t *), using the default kernel.
+       *
+       * @param input the characters to decode.
+       * @param size the number of characters to decode.
+       * @param output the destination; must have space for
+       * <tt>(size / 4) * 3</tt> bytes.
+       * @returns the number of characters consumed (a multiple of
+       * four); three bytes are written for every four characters.
+       */
+      std::size_t
+      base64_decode_block(const char  *input,
+                          std::size_t  size,
+                          uint8_t     *output);
+
+      /**
+       * Base64-encode a block of complete three-byte groups using
+       * the URL and filename safe alphabet.
+       *
+       * As for base64_encode_block(const uint8_t *, std::size_t,
+       * char *), using a scalar kernel.
+       *
+       * @param input the bytes to encode.
+       * @param size the number of bytes to encode.
+       * @param output the destination; must have space for
+       * <tt>(size / 3) * 4</tt> characters.
+       * @returns the number of characters written.
+       */
+      std::size_t
+      base64_url_encode_block(const uint8_t *input,
+                              std::size_t    size,
+                              char          *output);
+
+      /**
+       * Base64-decode a block of complete four-character groups
+       * using the URL and filename safe alphabet.
+       *
+       * As for base64_decode_block(const char *, std::size_t,
+       * uint8_t *), using a scalar kernel.
+       *
+       * @param input the characters to decode.
+       * @param size the number of characters to decode.
+       * @param output the destination; must have space for
+       * <tt>(size / 4) * 3</tt> bytes.
+       * @returns the number of characters consumed (a multiple of
+       * four); three bytes are written for every four characters.
+       */
+      std::size_t
+      base64_url_decode_block(const char  *input,
+                              std::size_t  size,
+                              uint8_t     *output);
+
+      /**
+       * Throw an exception for an invalid group.
+       *
+       * @param group the four characters of the invalid group.
+       * @throws std::runtime_error always.
+       */
+      [[noreturn]]
+      void
+      base64_invalid_group(const char *group);
+
+      /**
+       * Copy Base64 input, removing whitespace.
+       *
+       * Copying stops when the output is full or the input is
+       * exhausted.  Any whitespace following the copied input is
+       * then skipped, so that @p input is equal to @p end if no
+       * further significant input remains.
+       *
+       * @param input the start of the input; updated to the first
+       * unconsumed character.
+       * @param end the end of the input.
+       * @param output the destination.
+       * @param capacity the size of the destination.
+       * @returns the number of characters copied.
+       */
+      std::size_t
+      base64_compact(const char*& input,
+                     const char*  end,
+                     char        *output,
+                     std::size_t  capacity);
+
+      /**
+       * Base64-encode a contiguous range of bytes.
+       *
+       * @param data the bytes to encode.
+       * @param size the number of bytes to encode.
+       * @param linebreak the position at which to break a line; zero
+       * to disable line breaks.
+       * @returns a Base64-encoded string.
+       */
+      std::string
+      base64_encode_contiguous(const uint8_t *data,
+                               std::size_t    size,
+                               uint8_t        linebreak);
+
+      /**
+       * Check if an iterator type refers to contiguous byte storage.
+       *
+       * Ranges of these types may be encoded with the block kernels.
+       */
+      template<typename Iterator>
+      struct base64_contiguous : std::false_type
+      {};
+
+      /// Pointer to bytes.
+      template<>
+      struct base64_contiguous<uint8_t *> : std::true_type
+      {};
+
+      /// Pointer to constant bytes.
+      template<>
+      struct base64_contiguous<const uint8_t *> : std::true_type
+      {};
+
+      /// Byte vector iterator.
+      template<>
+      struct base64_contiguous<std::vector<uint8_t>::iterator> : std::true_type
+      {};
+
+      /// Byte vector constant iterator.
+      template<>
+      struct base64_contiguous<std::vector<uint8_t>::const_iterator> : std::true_type
+      {};
+
+      /**
+       * Base64-encode a contiguous range of bytes.
+       *
+       * @param begin the start of the byte range.
+       * @param end the end of the byte range.
+       * @param linebreak the position at which to break a line; zero
+       * to disable line breaks.
+       * @returns a Base64-encoded string.
+       */
+      template<typename Iterator>
+      std::string
+      base64_encode(Iterator begin,
+                    Iterator end,
+                    uint8_t  linebreak,
+                    std::true_type)
       {
-        while (pos != end)
+        std::size_t size = static_cast<std::size_t>(std::distance(begin, end));
+        return base64_encode_contiguous(size ? &*begin : nullptr, size, linebreak);
+      }
+
+      /**
+       * Base64-encode a range of bytes.
+       *
+       * @param begin the start of the byte range.
+       * @param end the end of the byte range.
+       * @param linebreak the position at which to break a line; zero
+       * to disable line breaks.
+       * @returns a Base64-encoded string.
+       */
+      template<typename Iterator>
+      std::string
+      base64_encode(Iterator begin,
+                    Iterator end,
+                    uint8_t  linebreak,
+                    std::false_type)
+      {
+        std::string encoded;
+        encoded.reserve((std::distance(begin, end) * 4) / 3);
+
+        uint64_t bytes = 0U;
+        uint64_t chars = 0U;
+        uint8_t accum = 0U;
+        for (Iterator i = begin; i != end; ++bytes)
           {
-            if (!std::isspace(*pos))
+            uint8_t byte = *i; // Byte 1
+            ++i;
+            accum = byte >> 2;
+            output_base64_char(encoded, accum, chars++, linebreak); // Char 1
+            accum = (byte & 0x3) << 4;
+            if (i != end)
+              {
+                byte = *i; // Byte 2
+                ++i;
+                accum |= (byte & 0xF0) >> 4;
+                output_base64_char(encoded, accum, chars++, linebreak); // Char 2
+                accum = (byte & 0x0F) << 2;
+                if (i != end)
+                  {
+                    byte = *i; // Byte 3
+                    ++i;
+                    accum |= (byte & 0xC0) >> 6;
+                    output_base64_char(encoded, accum, chars++, linebreak); // Char 3
+                    accum = byte & 0x3F;
+                    output_base64_char(encoded, accum, chars++, linebreak); // Char 4
+                  }
+                else
+                  {
+                    output_base64_char(encoded, accum, chars++, linebreak); // Char 3 (+pad)
+                    encoded += '='; // Char 4 (pad)
+                  }
+              }
+            else
               {
-                uint8_t value = base64_value(*pos++);
-                return value;
+                output_base64_char(encoded, accum, chars++, linebreak); // Char 2 (+pad)
+                encoded += "=="; // Chars 3 and 4
               }
-            ++pos;
           }
-        return 255;
+
+        return encoded;
+      }
+
+    }
+
+    /**
+     * Incremental Base64 encoder.
+     *
+     * Bytes may be supplied in chunks of any size, and the encoded
+     * characters are written into caller-provided buffers of any
+     * size.  Incomplete three-byte groups and the line-breaking
+     * state are carried over between calls, so the output is
+     * identical to base64_encode() for the concatenated input.
+     * Memory use is constant, independent of the input size.
+     *
+     * Call encode() until all input has been consumed, then call
+     * finish() until it returns @c true to write the final group
+     * and any padding.
+     */
+    class base64_encoder
+    {
+    public:
+      /**
+       * Constructor.
+       *
+       * @param linebreak the position at which to break a line; zero
+       * to disable line breaks.
+       */
+      explicit
+      base64_encoder(uint8_t linebreak = 76);
+
+      /**
+       * Encode bytes.
+       *
+       * Encoding stops when all input is consumed or when the
+       * output buffer is full.
+       *
+       * @param in the start of the input; updated to the first
+       * unconsumed byte.
+       * @param in_end the end of the input.
+       * @param out the start of the output buffer; updated to one
+       * past the last character written.
+       * @param out_end the end of the output buffer.
+       */
+      void
+      encode(const uint8_t*& in,
+             const uint8_t*  in_end,
+             char*&          out,
+             char*           out_end);
+
+      /**
+       * Finish encoding.
+       *
+       * Write the final (padded) group and any remaining output.
+       * No further input may be encoded until reset() is called.
+       *
+       * @param out the start of the output buffer; updated to one
+       * past the last character written.
+       * @param out_end the end of the output buffer.
+       * @returns @c true if all output has been written, or @c false
+       * if more output space is needed.
+       */
+      bool
+      finish(char*& out,
+             char*  out_end);
+
+      /**
+       * Reset to the initial state, discarding any pending input
+       * and output.
+       */
+      void
+      reset();
+
+    private:
+      /**
+       * Write pending output.
+       *
+       * @param out the start of the output buffer.
+       * @param out_end the end of the output buffer.
+       * @returns @c true if no pending output remains.
+       */
+      bool
+      flush(char*& out,
+            char*  out_end);
+
+      /**
+       * Add an encoded character to the pending output.
+       *
+       * @param value the value to encode.
+       */
+      void
+      put(uint8_t value);
+
+      /// Line break position.
+      uint8_t linebreak;
+      /// Number of Base64 characters written (used for linebreaking).
+      uint64_t chars;
+      /// Incomplete input group.
+      uint8_t group[3];
+      /// Number of bytes in the incomplete input group.
+      uint8_t group_size;
+      /// Pending output (one group, each character followed by a possible line break).
+      char pending[8];
+      /// Start of pending output.
+      uint8_t pending_begin;
+      /// End of pending output.
+      uint8_t pending_end;
+      /// Set once the final group has been encoded.
+      bool finished;
+    };
+
+    /**
+     * Incremental Base64 decoder.
+     *
+     * Characters may be supplied in chunks of any size, and the
+     * decoded bytes are written into caller-provided buffers of any
+     * size.  Incomplete four-character groups are carried over
+     * between calls, so the output and any errors are identical to
+     * base64_decode() for the concatenated input.  Memory use is
+     * constant, independent of the input size.
+     *
+     * Newlines and other whitespace breaking up the input are
+     * permitted.  Call decode() until all input has been consumed,
+     * then call finish() until it returns @c true to check the input
+     * was complete and write any remaining output.
+     */
+    class base64_decoder
+    {
+    public:
+      /**
+       * Constructor.
+       */
+      base64_decoder();
+
+      /**
+       * Decode characters.
+       *
+       * Decoding stops when all input is consumed or when the
+       * output buffer is full.
+       *
+       * @param in the start of the input; updated to the first
+       * unconsumed character.
+       * @param in_end the end of the input.
+       * @param out the start of the output buffer; updated to one
+       * past the last byte written.
+       * @param out_end the end of the output buffer.
+       * @throws std::runtime_error on invalid input.
+       */
+      void
+      decode(const char*& in,
+             const char*  in_end,
+             uint8_t*&    out,
+             uint8_t*     out_end);
+
+      /**
+       * Finish decoding.
+       *
+       * @param out the start of the output buffer; updated to one
+       * past the last byte written.
+       * @param out_end the end of the output buffer.
+       * @returns @c true if all output has been written, or @c false
+       * if more output space is needed.
+       * @throws std::runtime_error if the input ended part way
+       * through a group.
+       */
+      bool
+      finish(uint8_t*& out,
+             uint8_t*  out_end);
+
+      /**
+       * Reset to the initial state, discarding any pending input
+       * and output.
+       */
+      void
+      reset();
+
+    private:
+      /**
+       * Write pending output.
+       *
+       * @param out the start of the output buffer.
+       * @param out_end the end of the output buffer.
+       * @returns @c true if no pending output remains.
+       */
+      bool
+      flush(uint8_t*& out,
+            uint8_t*  out_end);
+
+      /// Incomplete input group (character values).
+      uint8_t group[4];
+      /// Number of values in the incomplete input group.
+      uint8_t group_size;
+      /// Set once padding has been seen.
+      bool pad_seen;
+      /// Pending output (one group).
+      uint8_t pending[3];
+      /// Start of pending output.
+      uint8_t pending_begin;
+      /// End of pending output.
+      uint8_t pending_end;
+    };
+
+    /**
+     * Compute the size of decoded Base64 input.
+     *
+     * Whitespace is skipped, and trailing padding is subtracted.
+     * The input is not validated.  For valid input, the exact
+     * decoded size is returned; for any input which may be decoded
+     * successfully, the returned size is never smaller than the
+     * decoded size.
+     *
+     * @param base64 the Base64-encoded characters.
+     * @param size the number of characters.
+     * @returns the decoded size, in bytes.
+     */
+    std::size_t
+    base64_decoded_size(const char  *base64,
+                        std::size_t  size);
+
+    /**
+     * Decode Base64 input into a caller-provided buffer.
+     *
+     * The decoded bytes are written directly into @p output, with
+     * no intermediate copies.  Use base64_decoded_size() to
+     * determine the space required.  Newlines and other whitespace
+     * breaking up the input are permitted.
+     *
+     * @param base64 the Base64-encoded characters.
+     * @param size the number of characters.
+     * @param output the destination.
+     * @param capacity the size of the destination, in bytes.
+     * @returns the number of bytes written.
+     * @throws std::runtime_error on invalid input, or if the
+     * destination is too small.
+     */
+    std::size_t
+    base64_decode_into(const char  *base64,
+                       std::size_t  size,
+                       uint8_t     *output,
+                       std::size_t  capacity);
+
+    /**
+     * Decode Base64 input into a caller-provided buffer using
+     * multiple threads.
+     *
+     * The input is pre-scanned in parallel to locate whitespace, and
+     * then split into segments at group boundaries.  Each segment is
+     * decoded by a separate thread into its own region of @p output.
+     * The output, return value and any errors are identical to
+     * base64_decode_into().  Small inputs, and inputs which can not
+     * be split (for example, with padding before the end), are
+     * decoded by the calling thread.  If threads can't be created,
+     * the remaining segments are decoded by the calling thread.
+     *
+     * @param base64 the Base64-encoded characters.
+     * @param size the number of characters.
+     * @param output the destination.
+     * @param capacity the size of the destination, in bytes.
+     * @param threads the number of threads to use; zero to use the
+     * number of hardware threads.
+     * @returns the number of bytes written.
+     * @throws std::runtime_error on invalid input, or if the
+     * destination is too small.
+     */
+    std::size_t
+    base64_decode_parallel(const char   *base64,
+                           std::size_t   size,
+                           uint8_t      *output,
+                           std::size_t   capacity,
+                           unsigned int  threads = 0U);
+
+    /**
+     * @name Base64 policies
+     *
+     * Policy types which select the Base64 variant used by the
+     * policy-based base64_encode(), base64_decode() and
+     * base64_decode_into() templates.  Each combination is
+     * instantiated separately, so that unused features (for example,
+     * whitespace handling) cost nothing.
+     */
+    ///@{
+
+    /// Base class of Base64 alphabet policies.
+    struct base64_alphabet
+    {
+    };
+
+    /// Standard Base64 alphabet, using "+" and "/" (RFC 4648 section 4).
+    struct base64_standard_alphabet : base64_alphabet
+    {
+      /**
+       * Encode a block of complete three-byte groups.
+       *
+       * @param input the bytes to encode.
+       * @param size the number of bytes to encode.
+       * @param output the destination.
+       * @returns the number of characters written.
+       */
+      static std::size_t
+      encode_block(const uint8_t *input,
+                   std::size_t    size,
+                   char          *output)
+      {
+        return detail::base64_encode_block(input, size, output);
+      }
+
+      /**
+       * Decode a block of complete four-character groups.
+       *
+       * @param input the characters to decode.
+       * @param size the number of characters to decode.
+       * @param output the destination.
+       * @returns the number of characters consumed.
+       */
+      static std::size_t
+      decode_block(const char  *input,
+                   std::size_t  size,
+                   uint8_t     *output)
+      {
+        return detail::base64_decode_block(input, size, output);
+      }
+    };
+
+    /// URL and filename safe Base64 alphabet, using "-" and "_" (RFC 4648 section 5).
+    struct base64_url_alphabet : base64_alphabet
+    {
+      /**
+       * Encode a block of complete three-byte groups.
+       *
+       * @param input the bytes to encode.
+       * @param size the number of bytes to encode.
+       * @param output the destination.
+       * @returns the number of characters written.
+       */
+      static std::size_t
+      encode_block(const uint8_t *input,
+                   std::size_t    size,
+                   char          *output)
+      {
+        return detail::base64_url_encode_block(input, size, output);
+      }
+
+      /**
+       * Decode a block of complete four-character groups.
+       *
+       * @param input the characters to decode.
+       * @param size the number of characters to decode.
+       * @param output the destination.
+       * @returns the number of characters consumed.
+       */
+      static std::size_t
+      decode_block(const char  *input,
+                   std::size_t  size,
+                   uint8_t     *output)
+      {
+        return detail::base64_url_decode_block(input, size, output);
+      }
+    };
+
+    /// Padding is written when encoding, and required when decoding.
+    struct base64_padding_required
+    {
+      /// Write padding when encoding.
+      static const bool write = true;
+      /// Require padding when decoding.
+      static const bool required = true;
+    };
+
+    /// Padding is not written when encoding, and optional when decoding.
+    struct base64_padding_optional
+    {
+      /// Write padding when encoding.
+      static const bool write = false;
+      /// Require padding when decoding.
+      static const bool required = false;
+    };
+
+    /**
+     * No whitespace.
+     *
+     * No line breaks are written when encoding.  Any whitespace is
+     * an error when decoding.
+     */
+    struct base64_whitespace_none
+    {
+    };
+
+    /**
+     * MIME line breaks (RFC 2045).
+     *
+     * Lines of 76 characters are separated by CRLF when encoding.
+     * When decoding, the same layout is required, optionally with a
+     * trailing CRLF.
+     */
+    struct base64_whitespace_mime
+    {
+    };
+
+    /**
+     * Arbitrary whitespace.
+     *
+     * Lines of 76 characters are separated by LF when encoding.  Any
+     * whitespace is skipped when decoding.
+     */
+    struct base64_whitespace_any
+    {
+    };
+
+    ///@}
+
+    namespace detail
+    {
+
+      /**
+       * Decode a Base64-encoded string.
+       *
+       * Newlines and other whitespace breaking up the input are
+       * permitted.  Decoded bytes are passed to @p sink in blocks
+       * rather than one byte at a time.
+       *
+       * @param begin the start of the Base64-encoded string.
+       * @param end the end of the Base64-encoded string.
+       * @param sink a callable taking a <tt>const uint8_t *</tt>
+       * and a <tt>std::size_t</tt> length, to receive the decoded
+       * bytes.
+       * @throws std::runtime_error on invalid input.
+       */
+      template<typename Sink>
+      void
+      base64_decode(const char *begin,
+                    const char *end,
+                    Sink        sink)
+      {
+        // Decode buffer size (bytes).
+        const std::size_t block_size = 3072U;
+
+        base64_decoder decoder;
+        uint8_t block[block_size];
+        bool done = false;
+        while (!done)
+          {
+            uint8_t *out = block;
+            if (begin != end)
+              decoder.decode(begin, end, out, block + block_size);
+            else
+              done = decoder.finish(out, block + block_size);
+            if (out != block)
+              sink(static_cast<const uint8_t *>(block),
+                   static_cast<std::size_t>(out - block));
+          }
+      }
+
+      /**
+       * Decode a group-aligned span of Base64 input without
+       * whitespace.
+       *
+       * Complete groups are decoded with a single block kernel call.
+       * If @p last is @c true, the span may end with padding or (if
+       * permitted by @p Padding) an unpadded partial group.
+       *
+       * @param input the Base64-encoded characters.
+       * @param size the number of characters.
+       * @param output the destination.
+       * @param capacity the size of the destination, in bytes.
+       * @param last @c true if this is the end of the input.
+       * @returns the number of bytes written.
+       * @throws std::runtime_error on invalid input, or if the
+       * destination is too small.
+       */
+      template<typename Alphabet, typename Padding>
+      std::size_t
+      base64_decode_span(const char  *input,
+                         std::size_t  size,
+                         uint8_t     *output,
+                         std::size_t  capacity,
+                         bool         last)
+      {
+        std::size_t pad = 0U;
+        if (last)
+          while (pad < 2U && pad < size && input[size - 1U - pad] == '=')
+            ++pad;
+
+        std::size_t body = size - pad;
+        std::size_t tail = body % 4U;
+        if (tail == 1U || (pad && tail + pad != 4U) || (Padding::required && size % 4U))
+          throw std::runtime_error("Invalid Base64 input: unexpected end of input");
+
+        std::size_t full = body - tail;
+        std::size_t decoded_size = (full / 4U) * 3U + (tail ? tail - 1U : 0U);
+        if (decoded_size > capacity)
+          throw std::runtime_error("Insufficient space for decoded Base64 output");
+
+        std::size_t consumed = Alphabet::decode_block(input, full, output);
+        if (consumed != full)
+          base64_invalid_group(input + consumed);
+
+        if (tail)
+          {
+            // Decode the partial group by completing it with zero
+            // values ('A' in all alphabets).
+            char group[4] = { input[full], input[full + 1U], 'A', 'A' };
+            if (tail == 3U)
+              group[2] = input[full + 2U];
+            uint8_t bytes[3];
+            if (Alphabet::decode_block(group, 4U, bytes) != 4U)
+              base64_invalid_group(group);
+            std::copy(bytes, bytes + (tail - 1U), output + (full / 4U) * 3U);
+          }
+
+        return decoded_size;
+      }
+
+      /**
+       * Decode Base64 input without whitespace.
+       *
+       * @param input the Base64-encoded characters.
+       * @param size the number of characters.
+       * @param output the destination.
+       * @param capacity the size of the destination, in bytes.
+       * @returns the number of bytes written.
+       * @throws std::runtime_error on invalid input, or if the
+       * destination is too small.
+       */
+      template<typename Alphabet, typename Padding>
+      std::size_t
+      base64_decode_policy(const char  *input,
+                           std::size_t  size,
+                           uint8_t     *output,
+                           std::size_t  capacity,
+                           Alphabet,
+                           Padding,
+                           base64_whitespace_none)
+      {
+        return base64_decode_span<Alphabet, Padding>(input, size, output, capacity, true);
+      }
+
+      /**
+       * Decode Base64 input with MIME line breaks.
+       *
+       * @param input the Base64-encoded characters.
+       * @param size the number of characters.
+       * @param output the destination.
+       * @param capacity the size of the destination, in bytes.
+       * @returns the number of bytes written.
+       * @throws std::runtime_error on invalid input, or if the
+       * destination is too small.
+       */
+      template<typename Alphabet, typename Padding>
+      std::size_t
+      base64_decode_policy(const char  *input,
+                           std::size_t  size,
+                           uint8_t     *output,
+                           std::size_t  capacity,
+                           Alphabet,
+                           Padding,
+                           base64_whitespace_mime)
+      {
+        const std::size_t line = 76U;
+
+        if (size >= 2U && input[size - 2U] == '\r' && input[size - 1U] == '\n')
+          size -= 2U;
+
+        std::size_t written = 0U;
+        while (size > line)
+          {
+            if (size < line + 2U || input[line] != '\r' || input[line + 1U] != '\n')
+              throw std::runtime_error("Invalid Base64 input: expected CRLF line break");
+            written += base64_decode_span<Alphabet, Padding>(input, line, output + written,
+                                                             capacity - written, false);
+            input += line + 2U;
+            size -= line + 2U;
+          }
+
+        return written + base64_decode_span<Alphabet, Padding>(input, size, output + written,
+                                                               capacity - written, true);
+      }
+
+      /**
+       * Decode Base64 input with arbitrary whitespace.
+       *
+       * Whitespace is removed from blocks of input, which are then
+       * decoded without whitespace.
+       *
+       * @param input the Base64-encoded characters.
+       * @param size the number of characters.
+       * @param output the destination.
+       * @param capacity the size of the destination, in bytes.
+       * @returns the number of bytes written.
+       * @throws std::runtime_error on invalid input, or if the
+       * destination is too small.
+       */
+      template<typename Alphabet, typename Padding>
+      std::size_t
+      base64_decode_policy(const char  *input,
+                           std::size_t  size,
+                           uint8_t     *output,
+                           std::size_t  capacity,
+                           Alphabet,
+                           Padding,
+                           base64_whitespace_any)
+      {
+        // Compaction buffer size (characters); a multiple of four.
+        const std::size_t block_size = 4096U;
+
+        const char *end = input + size;
+        char block[block_size];
+        std::size_t written = 0U;
+        while (true)
+          {
+            std::size_t filled = base64_compact(input, end, block, block_size);
+            bool last = input == end;
+            written += base64_decode_span<Alphabet, Padding>(block, filled, output + written,
+                                                             capacity - written, last);
+            if (last)
+              break;
+          }
+        return written;
+      }
+
+      /**
+       * Decode standard Base64 input with arbitrary whitespace.
+       *
+       * This is the default variant, handled by
+       * ome::common::base64_decode_into().
+       *
+       * @param input the Base64-encoded characters.
+       * @param size the number of characters.
+       * @param output the destination.
+       * @param capacity the size of the destination, in bytes.
+       * @returns the number of bytes written.
+       * @throws std::runtime_error on invalid input, or if the
+       * destination is too small.
+       */
+      inline std::size_t
+      base64_decode_policy(const char  *input,
+                           std::size_t  size,
+                           uint8_t     *output,
+                           std::size_t  capacity,
+                           base64_standard_alphabet,
+                           base64_padding_required,
+                           base64_whitespace_any)
+      {
+        return ome::common::base64_decode_into(input, size, output, capacity);
+      }
+
+      /**
+       * Decode a Base64-encoded string into a contiguous container.
+       *
+       * The container is sized to the maximum possible decoded size
+       * (avoiding a separate pass to compute the exact size), decoded
+       * into directly, and then truncated to the decoded size.
+       *
+       * @param base64 the Base64-encoded string.
+       * @param decoded the container to fill.
+       * @param alphabet the alphabet policy.
+       * @param padding the padding policy.
+       * @param whitespace the whitespace policy.
+       * @throws std::runtime_error on invalid input.
+       */
+      template<typename Container, typename Alphabet, typename Padding, typename Whitespace>
+      void
+      base64_decode(const std::string& base64,
+                    Container&         decoded,
+                    Alphabet           alphabet,
+                    Padding            padding,
+                    Whitespace         whitespace,
+                    std::true_type)
+      {
+        decoded.resize((base64.size() * 3) / 4);
+        decoded.resize(base64_decode_policy(base64.data(), base64.size(),
+                                            decoded.empty() ? nullptr : &decoded[0],
+                                            decoded.size(),
+                                            alphabet, padding, whitespace));
+      }
+
+      /**
+       * Decode a Base64-encoded string into a container.
+       *
+       * The string is decoded into a temporary byte vector, which is
+       * then inserted into the container.
+       *
+       * @param base64 the Base64-encoded string.
+       * @param decoded the container to fill.
+       * @param alphabet the alphabet policy.
+       * @param padding the padding policy.
+       * @param whitespace the whitespace policy.
+       * @throws std::runtime_error on invalid input.
+       */
+      template<typename Container, typename Alphabet, typename Padding, typename Whitespace>
+      void
+      base64_decode(const std::string& base64,
+                    Container&         decoded,
+                    Alphabet           alphabet,
+                    Padding            padding,
+                    Whitespace         whitespace,
+                    std::false_type)
+      {
+        std::vector<uint8_t> buffer;
+        base64_decode(base64, buffer, alphabet, padding, whitespace, std::true_type());
+        decoded.insert(decoded.end(), buffer.begin(), buffer.end());
+      }
+
+      /**
+       * Decode a standard Base64-encoded string into a container.
+       *
+       * @param base64 the Base64-encoded string.
+       * @param decoded the container to fill.
+       * @throws std::runtime_error on invalid input.
+       */
+      template<typename Container>
+      void
+      base64_decode(const std::string& base64,
+                    Container&         decoded,
+                    base64_standard_alphabet,
+                    base64_padding_required,
+                    base64_whitespace_any,
+                    std::false_type)
+      {
+        base64_decode(base64.data(), base64.data() + base64.size(),
+                      [&decoded](const uint8_t *data, std::size_t size)
+                      {
+                        decoded.insert(decoded.end(), data, data + size);
+                      });
+      }
+
+      /**
+       * Base64-encode a contiguous range of bytes using the
+       * specified policies.
+       *
+       * @param data the bytes to encode.
+       * @param size the number of bytes to encode.
+       * @param line_end the line separator; null to disable line
+       * breaks.
+       * @returns a Base64-encoded string.
+       */
+      template<typename Alphabet, typename Padding>
+      std::string
+      base64_encode_policy(const uint8_t *data,
+                           std::size_t    size,
+                           const char    *line_end)
+      {
+        // Bytes per line (76 characters).
+        const std::size_t line = 57U;
+
+        std::size_t tail = size % 3U;
+        std::size_t chars = (size / 3U) * 4U + (tail ? (Padding::write ? 4U : tail + 1U) : 0U);
+        std::size_t line_end_size = line_end ? std::char_traits<char>::length(line_end) : 0U;
+        std::size_t lines = line_end ? (chars + 75U) / 76U : 1U;
+
+        std::string encoded(chars + (lines ? lines - 1U : 0U) * line_end_size, '\0');
+        char *out = &encoded[0];
+        std::size_t remaining = size - tail;
+        while (remaining)
+          {
+            std::size_t count = line_end ? std::min(remaining, line) : remaining;
+            out += Alphabet::encode_block(data, count, out);
+            data += count;
+            remaining -= count;
+            if (line_end && count == line && (remaining || tail))
+              out = std::copy(line_end, line_end + line_end_size, out);
+          }
+
+        if (tail)
+          {
+            // Encode the partial group by completing it with zero
+            // bytes.
+            uint8_t group[3] = { data[0], 0U, 0U };
+            if (tail == 2U)
+              group[1] = data[1];
+            char group_chars[4];
+            Alphabet::encode_block(group, 3U, group_chars);
+            out = std::copy(group_chars, group_chars + tail + 1U, out);
+            if (Padding::write)
+              out = std::fill_n(out, 3U - tail, '=');
+          }
+
+        return encoded;
+      }
+
+      /**
+       * Base64-encode a contiguous range of bytes using the
+       * specified policies.
+       *
+       * @param begin the start of the byte range.
+       * @param end the end of the byte range.
+       * @param line_end the line separator; null to disable line
+       * breaks.
+       * @returns a Base64-encoded string.
+       */
+      template<typename Alphabet, typename Padding, typename Iterator>
+      std::string
+      base64_encode_policy(Iterator    begin,
+                           Iterator    end,
+                           const char *line_end,
+                           std::true_type)
+      {
+        std::size_t size = static_cast<std::size_t>(std::distance(begin, end));
+        return base64_encode_policy<Alphabet, Padding>(size ? &*begin : nullptr, size, line_end);
+      }
+
+      /**
+       * Base64-encode a range of bytes using the specified policies.
+       *
+       * The bytes are copied into a temporary contiguous buffer.
+       *
+       * @param begin the start of the byte range.
+       * @param end the end of the byte range.
+       * @param line_end the line separator; null to disable line
+       * breaks.
+       * @returns a Base64-encoded string.
+       */
+      template<typename Alphabet, typename Padding, typename Iterator>
+      std::string
+      base64_encode_policy(Iterator    begin,
+                           Iterator    end,
+                           const char *line_end,
+                           std::false_type)
+      {
+        std::vector<uint8_t> buffer(begin, end);
+        return base64_encode_policy<Alphabet, Padding>(buffer.data(), buffer.size(), line_end);
+      }
+
+      /**
+       * Get the line separator for a whitespace policy.
+       *
+       * @returns the line separator, or null for no line breaks.
+       */
+      inline const char *
+      base64_line_end(base64_whitespace_none)
+      {
+        return nullptr;
+      }
+
+      /**
+       * Get the line separator for a whitespace policy.
+       *
+       * @returns the line separator, or null for no line breaks.
+       */
+      inline const char *
+      base64_line_end(base64_whitespace_mime)
+      {
+        return "\r\n";
+      }
+
+      /**
+       * Get the line separator for a whitespace policy.
+       *
+       * @returns the line separator, or null for no line breaks.
+       */
+      inline const char *
+      base64_line_end(base64_whitespace_any)
+      {
+        return "\n";
       }
 
     }
@@ -161,6 +1287,10 @@ namespace ome
      * a range in a container, raw pointers or any other compatible
      * type.
      *
+     * Contiguous ranges of bytes (pointers and vector iterators)
+     * are encoded using the fastest block kernel supported by the
+     * CPU; other ranges are encoded one byte at a time.
+     *
      * @param begin the start of the byte range.
      * @param end the end of the byte range.
      * @param linebreak the position at which to break a line; zero
@@ -173,49 +1303,8 @@ namespace ome
                   Iterator end,
                   uint8_t  linebreak = 76)
     {
-      std::string encoded;
-      encoded.reserve((std::distance(begin, end) * 4) / 3);
-
-      uint64_t bytes = 0U;
-      uint64_t chars = 0U;
-      uint8_t accum = 0U;
-      for (Iterator i = begin; i != end; ++bytes)
-        {
-          uint8_t byte = *i; // Byte 1
-          ++i;
-          accum = byte >> 2;
-          detail::output_base64_char(encoded, accum, chars++, linebreak); // Char 1
-          accum = (byte & 0x3) << 4;
-          if (i != end)
-            {
-              byte = *i; // Byte 2
-              ++i;
-              accum |= (byte & 0xF0) >> 4;
-              detail::output_base64_char(encoded, accum, chars++, linebreak); // Char 2
-              accum = (byte & 0x0F) << 2;
-              if (i != end)
-                {
-                  byte = *i; // Byte 3
-                  ++i;
-                  accum |= (byte & 0xC0) >> 6;
-                  detail::output_base64_char(encoded, accum, chars++, linebreak); // Char 3
-                  accum = byte & 0x3F;
-                  detail::output_base64_char(encoded, accum, chars++, linebreak); // Char 4
-                }
-              else
-                {
-                  detail::output_base64_char(encoded, accum, chars++, linebreak); // Char 3 (+pad)
-                  encoded += '='; // Char 4 (pad)
-                }
-            }
-          else
-            {
-              detail::output_base64_char(encoded, accum, chars++, linebreak); // Char 2 (+pad)
-              encoded += "=="; // Chars 3 and 4
-            }
-        }
-
-      return encoded;
+      return detail::base64_encode(begin, end, linebreak,
+                                   detail::base64_contiguous<Iterator>());
     }
 
     /**
@@ -230,86 +1319,117 @@ namespace ome
      */
     template<typename InsertIterator>
     void
-    base64_decode(std::string    base64,
-                  InsertIterator dest)
+    base64_decode(const std::string& base64,
+                  InsertIterator     dest)
     {
-      bool pad_seen = false;
-      uint8_t bytes[4];
-      uint8_t output;
-      for (std::string::const_iterator i = base64.begin();
-           i != base64.end();)
-        {
-          // Get next 4 bytes.  If only whitespace remains, the first
-          // byte will be 255.  Since the input is blocked into groups
-          // of four characters, fetch four at once.
-          for (int j = 0; j < 4; ++j)
-            {
-              bytes[j] = detail::next_base64_value(i, base64.end());
-              if(j == 0 && bytes[j] == 255)
-                break;
-            }
-
-          if (bytes[0] == 255) // End of input (expected)
-            break;
-          if (bytes[1] == 255 || bytes[2] == 255 || bytes[3] == 255) // End of input (unexpected)
-            throw std::runtime_error("Invalid Base64 input: unexpected end of input");
-
-          if (bytes[0] < 64 && bytes[1] < 64) // Valid input
-            {
-              if(pad_seen) // Padding only allowed at end.
-                throw std::runtime_error("Invalid Base64 input: padding only permitted at end of input");
-
-              output = bytes[0] << 2 | bytes[1] >> 4;
-              *dest = output; // Byte 1
-              if (bytes[2] < 64) // Skip if padded
-                {
-                  output = bytes[1] << 4 | bytes[2] >> 2;
-                  *dest = output; // Byte 2
-                  if (bytes[3] < 64) // Skip if padded
-                    {
-                      output = bytes[2] << 6 | bytes[3];
-                      *dest = output; // Byte 3
-                    }
-                  else
-                    {
-                      pad_seen = true;
-                    }
-                }
-              else
-                {
-                  pad_seen = true;
-                }
-            }
-          else
-            {
-              throw(std::runtime_error("Invalid Base64 input: padding encountered unexpectedly"));
-            }
-        }
+      detail::base64_decode(base64.data(), base64.data() + base64.size(),
+                            [&dest](const uint8_t *data, std::size_t size)
+                            {
+                              dest = std::copy(data, data + size, dest);
+                            });
     }
 
     /**
      * Decode a Base64-encoded string into a container.
      *
      * Newlines and other whitespace breaking up the input are
-     * permitted.
+     * permitted.  Byte vectors are sized to the maximum possible
+     * decoded size, decoded into directly, and then truncated to
+     * the decoded size (their capacity may exceed their size if the
+     * input contains whitespace or padding); other containers are
+     * filled by insertion.
+     *
+     * The Base64 variant may be selected with policy types; by
+     * default, the standard alphabet is used, padding is required
+     * and any whitespace is skipped.
      *
+     * @tparam Container the container type.
+     * @tparam Alphabet the alphabet policy.
+     * @tparam Padding the padding policy.
+     * @tparam Whitespace the whitespace policy.
      * @param base64 the Base64-encoded string.
      * @returns a container filled with the decoded bytes.
      * @throws std::runtime_error on invalid input.
      */
-    template<typename Container>
+    template<typename Container,
+             typename Alphabet = base64_standard_alphabet,
+             typename Padding = base64_padding_required,
+             typename Whitespace = base64_whitespace_any>
     Container
     base64_decode(const std::string& base64)
     {
       Container decoded;
 
-      decoded.reserve((base64.size() * 3) / 4);
-
-      base64_decode(base64, std::back_inserter(decoded));
+      detail::base64_decode(base64, decoded, Alphabet(), Padding(), Whitespace(),
+                            detail::base64_contiguous<typename Container::iterator>());
 
       return decoded;
     }
 
+    /**
+     * Base64-encode a range of bytes using the specified policies.
+     *
+     * For example, to encode with the URL and filename safe
+     * alphabet, without padding or line breaks:
+     *
+     * @code
+     * std::string encoded =
+     *   base64_encode<base64_url_alphabet,
+     *                 base64_padding_optional>(data.begin(), data.end());
+     * @endcode
+     *
+     * @tparam Alphabet the alphabet policy.
+     * @tparam Padding the padding policy.
+     * @tparam Whitespace the whitespace policy.
+     * @param begin the start of the byte range.
+     * @param end the end of the byte range.
+     * @returns a Base64-encoded string.
+     */
+    template<typename Alphabet,
+             typename Padding = base64_padding_required,
+             typename Whitespace = base64_whitespace_none,
+             typename Iterator>
+    typename std::enable_if<std::is_base_of<base64_alphabet, Alphabet>::value, std::string>::type
+    base64_encode(Iterator begin,
+                  Iterator end)
+    {
+      return detail::base64_encode_policy<Alphabet, Padding>(begin, end,
+                                                             detail::base64_line_end(Whitespace()),
+                                                             detail::base64_contiguous<Iterator>());
+    }
+
+    /**
+     * Decode Base64 input into a caller-provided buffer using the
+     * specified policies.
+     *
+     * With base64_whitespace_none, complete groups are decoded
+     * with a single block kernel call, without testing for
+     * whitespace.
+     *
+     * @tparam Alphabet the alphabet policy.
+     * @tparam Padding the padding policy.
+     * @tparam Whitespace the whitespace policy.
+     * @param base64 the Base64-encoded characters.
+     * @param size the number of characters.
+     * @param output the destination.
+     * @param capacity the size of the destination, in bytes.
+     * @returns the number of bytes written.
+     * @throws std::runtime_error on invalid input, or if the
+     * destination is too small.
+     */
+    template<typename Alphabet,
+             typename Padding = base64_padding_required,
+             typename Whitespace = base64_whitespace_none>
+    std::size_t
+    base64_decode_into(const char  *base64,
+                       std::size_t  size,
+                       uint8_t     *output,
+                       std::size_t  capacity)
+    {
+      return detail::base64_decode_policy(base64, size, output, capacity,
+                                          Alphabet(), Padding(), Whitespace());
+    }
+
   }
 }
 
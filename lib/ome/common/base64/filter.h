@@ -0,0 +1,230 @@
+/*
+ * #%L
+ * OME-COMMON C++ library for C++ compatibility/portability
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+/**
+ * @file ome/common/base64/filter.h Base64 stream filters.
+ *
+ * Boost.Iostreams filters wrapping base64_encoder and
+ * base64_decoder, for encoding and decoding streams of any size in
+ * constant memory.  For example, to decode a Base64-encoded file:
+ *
+ * @code
+ * boost::iostreams::filtering_istream in;
+ * in.push(ome::common::base64_decode_filter());
+ * in.push(boost::iostreams::file_source(path));
+ * in.read(reinterpret_cast<char *>(buffer), size);
+ * @endcode
+ */
+
+#ifndef OME_COMMON_BASE64_FILTER_H
+#define OME_COMMON_BASE64_FILTER_H
+
+#include <ome/common/config.h>
+#include <ome/common/base64.h>
+
+#include <boost/iostreams/constants.hpp>
+#include <boost/iostreams/filter/symmetric.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+
+    namespace detail
+    {
+
+      /// Symmetric filter implementation for Base64 encoding.
+      class base64_encode_filter_impl
+      {
+      public:
+        /// Character type.
+        typedef char char_type;
+
+        /**
+         * Constructor.
+         *
+         * @param linebreak the position at which to break a line;
+         * zero to disable line breaks.
+         */
+        explicit
+        base64_encode_filter_impl(uint8_t linebreak = 76):
+          encoder(linebreak)
+        {
+        }
+
+        /**
+         * Encode a block of input.
+         *
+         * @param src_begin the start of the input.
+         * @param src_end the end of the input.
+         * @param dest_begin the start of the output.
+         * @param dest_end the end of the output.
+         * @param flush @c true if there is no more input.
+         * @returns @c false when all output has been written.
+         */
+        bool
+        filter(const char*& src_begin,
+               const char*  src_end,
+               char*&       dest_begin,
+               char*        dest_end,
+               bool         flush)
+        {
+          const uint8_t *in = reinterpret_cast<const uint8_t *>(src_begin);
+          encoder.encode(in, reinterpret_cast<const uint8_t *>(src_end),
+                         dest_begin, dest_end);
+          src_begin = reinterpret_cast<const char *>(in);
+          if (flush && src_begin == src_end)
+            return !encoder.finish(dest_begin, dest_end);
+          return true;
+        }
+
+        /// Reset for reuse.
+        void
+        close()
+        {
+          encoder.reset();
+        }
+
+      private:
+        /// Encoder state.
+        base64_encoder encoder;
+      };
+
+      /// Symmetric filter implementation for Base64 decoding.
+      class base64_decode_filter_impl
+      {
+      public:
+        /// Character type.
+        typedef char char_type;
+
+        /**
+         * Decode a block of input.
+         *
+         * @param src_begin the start of the input.
+         * @param src_end the end of the input.
+         * @param dest_begin the start of the output.
+         * @param dest_end the end of the output.
+         * @param flush @c true if there is no more input.
+         * @returns @c false when all output has been written.
+         * @throws std::runtime_error on invalid input.
+         */
+        bool
+        filter(const char*& src_begin,
+               const char*  src_end,
+               char*&       dest_begin,
+               char*        dest_end,
+               bool         flush)
+        {
+          uint8_t *out = reinterpret_cast<uint8_t *>(dest_begin);
+          decoder.decode(src_begin, src_end,
+                         out, reinterpret_cast<uint8_t *>(dest_end));
+          bool more = true;
+          if (flush && src_begin == src_end)
+            more = !decoder.finish(out, reinterpret_cast<uint8_t *>(dest_end));
+          dest_begin = reinterpret_cast<char *>(out);
+          return more;
+        }
+
+        /// Reset for reuse.
+        void
+        close()
+        {
+          decoder.reset();
+        }
+
+      private:
+        /// Decoder state.
+        base64_decoder decoder;
+      };
+
+    }
+
+    /**
+     * Base64 encoding filter.
+     *
+     * Usable as both an input and an output filter.
+     */
+    class base64_encode_filter : public boost::iostreams::symmetric_filter<detail::base64_encode_filter_impl>
+    {
+    public:
+      /**
+       * Constructor.
+       *
+       * @param linebreak the position at which to break a line; zero
+       * to disable line breaks.
+       * @param buffer_size the size of the internal buffer.
+       */
+      explicit
+      base64_encode_filter(uint8_t         linebreak = 76,
+                           std::streamsize buffer_size = boost::iostreams::default_filter_buffer_size):
+        boost::iostreams::symmetric_filter<detail::base64_encode_filter_impl>(buffer_size, linebreak)
+      {
+      }
+    };
+
+    /**
+     * Base64 decoding filter.
+     *
+     * Usable as both an input and an output filter.  Newlines and
+     * other whitespace breaking up the input are permitted.
+     */
+    class base64_decode_filter : public boost::iostreams::symmetric_filter<detail::base64_decode_filter_impl>
+    {
+    public:
+      /**
+       * Constructor.
+       *
+       * @param buffer_size the size of the internal buffer.
+       */
+      explicit
+      base64_decode_filter(std::streamsize buffer_size = boost::iostreams::default_filter_buffer_size):
+        boost::iostreams::symmetric_filter<detail::base64_decode_filter_impl>(buffer_size)
+      {
+      }
+    };
+
+  }
+}
+
+#endif // OME_COMMON_BASE64_FILTER_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
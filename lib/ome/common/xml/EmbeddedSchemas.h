@@ -0,0 +1,91 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_EMBEDDEDSCHEMAS_H
+#define OME_COMMON_XML_EMBEDDEDSCHEMAS_H
+
+#include <cstddef>
+
+#include <ome/common/config.h>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace detail
+      {
+
+        /**
+         * An XML schema embedded in the library at build time.
+         *
+         * The table of embedded schemas is generated from the XML
+         * catalog set with the @c embedded-schema-catalog build
+         * option, and is only present in the library if @c
+         * OME_HAVE_EMBEDDED_SCHEMAS is defined.  Otherwise, the
+         * tests generate and link their own table from the test
+         * catalog.  This header is internal and not installed.
+         */
+        struct embedded_schema
+        {
+          /// XML system ID.
+          const char *id;
+          /// Schema content (null terminated).
+          const unsigned char *data;
+          /// Schema content size, in bytes (excluding the terminator).
+          std::size_t size;
+        };
+
+        /// Embedded schemas, in catalog order.
+        extern const embedded_schema embedded_schemas[];
+        /// Number of embedded schemas.
+        extern const std::size_t embedded_schema_count;
+
+      }
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_EMBEDDEDSCHEMAS_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
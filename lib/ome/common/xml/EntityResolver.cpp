@@ -36,11 +36,18 @@
  * #L%
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <deque>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <new>
 #include <set>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 
 #include <boost/filesystem/operations.hpp>
@@ -49,16 +56,175 @@
 
 #include <ome/common/filesystem.h>
 
+#include <ome/common/xml/EmbeddedSchemas.h>
 #include <ome/common/xml/EntityResolver.h>
+#include <ome/common/xml/InputSource.h>
+#include <ome/common/xml/Name.h>
 #include <ome/common/xml/String.h>
 
-#include <ome/common/xml/Platform.h>
 #include <ome/common/xml/dom/Document.h>
-#include <ome/common/xml/dom/Element.h>
-#include <ome/common/xml/dom/NodeList.h>
+#include <ome/common/xml/sax/Handler.h>
+#include <ome/common/xml/sax/Reader.h>
 
 #include <xercesc/sax/InputSource.hpp>
-#include <xercesc/framework/MemBufInputSource.hpp>
+
+namespace
+{
+
+  using ome::common::xml::StringView;
+  using ome::common::xml::sax::Attributes;
+
+  // The registrations of a parsed XML catalog.
+  struct catalog_info
+  {
+    // Content of the catalog file when parsed.
+    std::string content;
+    // System IDs and canonical filenames of the registered entities.
+    std::vector<std::pair<std::string, boost::filesystem::path>> entities;
+    // Canonical filenames of the nested catalogs.
+    std::vector<boost::filesystem::path> catalogs;
+  };
+
+  // Collect the uri and nextCatalog entries of an XML catalog.
+  class CatalogHandler : public ome::common::xml::sax::Handler
+  {
+  public:
+    CatalogHandler(catalog_info&                  info,
+                   const boost::filesystem::path& dir):
+      info(info),
+      dir(dir),
+      depth(0)
+    {
+    }
+
+    void
+    startElement(const StringView& /* uri */,
+                 const StringView& localName,
+                 const StringView& /* qName */,
+                 const Attributes& attributes)
+    {
+      // Only children of the root catalog element are entries.
+      if (depth++ != 1)
+        return;
+
+      if (localName == "uri")
+        {
+          if (attributes.has("uri") && attributes.has("name"))
+            info.entities.emplace_back(attributes.get("name").str(),
+                                       ome::common::canonical(dir / attributes.get("uri").str()));
+        }
+      else if (localName == "nextCatalog")
+        {
+          if (attributes.has("catalog"))
+            info.catalogs.push_back(ome::common::canonical(dir / attributes.get("catalog").str()));
+        }
+    }
+
+    void
+    endElement(const StringView& /* uri */,
+               const StringView& /* localName */,
+               const StringView& /* qName */)
+    {
+      --depth;
+    }
+
+  private:
+    catalog_info& info;
+    const boost::filesystem::path& dir;
+    unsigned int depth;
+  };
+
+  // Reader for parsing catalogs, without validation.
+  struct catalog_reader
+  {
+    catalog_reader():
+      resolver(),
+      reader(resolver, params())
+    {
+    }
+
+    static ome::common::xml::dom::ParseParameters
+    params()
+    {
+      ome::common::xml::dom::ParseParameters params;
+      params.validationScheme = xercesc::XercesDOMParser::Val_Never;
+      params.doSchema = false;
+      params.handleMultipleImports = false;
+      params.validationSchemaFullChecking = false;
+      return params;
+    }
+
+    ome::common::xml::EntityResolver resolver; // Does nothing.
+    ome::common::xml::sax::Reader reader;
+  };
+
+  // Source of unique resolver serial numbers.
+  std::atomic<uint64_t> next_serial(1);
+
+  /**
+   * The snapshot most recently used by this thread.
+   *
+   * Resolvers are identified by serial number rather than address,
+   * so that a new resolver allocated at the address of a destroyed
+   * resolver will not match.  The snapshot type is private to
+   * EntityResolver, so it is held as an untyped pointer.
+   */
+  struct ThreadSnapshot
+  {
+    /// Serial number of the owning resolver.
+    uint64_t serial;
+    /// Generation of the snapshot.
+    uint64_t generation;
+    /// The snapshot.
+    std::shared_ptr<const void> state;
+  };
+
+  thread_local ThreadSnapshot current_snapshot = { 0, 0, std::shared_ptr<const void>() };
+
+  // Parsed catalogs, shared by all resolvers, keyed on canonical
+  // filename.
+  std::mutex catalog_cache_mutex;
+  std::unordered_map<std::string, std::shared_ptr<const catalog_info>> catalog_cache;
+
+  // Get a parsed catalog, from the cache if the file content is
+  // unchanged.  Catalogs are small, so reading and comparing the
+  // content is cheap relative to parsing, and unlike the file
+  // modification time, can't miss a change.  The reader is created
+  // on first use.  Returns null if the file can't be read.
+  std::shared_ptr<const catalog_info>
+  get_catalog(const boost::filesystem::path&   file,
+              std::unique_ptr<catalog_reader>& reader)
+  {
+    std::ifstream in(file.string().c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+      return std::shared_ptr<const catalog_info>();
+    std::string content((std::istreambuf_iterator<char>(in)),
+                        std::istreambuf_iterator<char>());
+    if (in.bad())
+      return std::shared_ptr<const catalog_info>();
+
+    {
+      std::lock_guard<std::mutex> lock(catalog_cache_mutex);
+      auto i = catalog_cache.find(file.string());
+      if (i != catalog_cache.end() && i->second->content == content)
+        return i->second;
+    }
+
+    std::shared_ptr<catalog_info> info(std::make_shared<catalog_info>());
+
+    if (!reader)
+      reader.reset(new catalog_reader());
+    boost::filesystem::path dir(file.parent_path());
+    CatalogHandler handler(*info, dir);
+    reader->reader.parse(content, handler, file.string());
+    info->content = std::move(content);
+
+    std::lock_guard<std::mutex> lock(catalog_cache_mutex);
+    catalog_cache[file.string()] = info;
+    return info;
+  }
+
+}
 
 namespace ome
 {
@@ -70,8 +236,10 @@ namespace ome
       EntityResolver::EntityResolver():
         xercesc::XMLEntityResolver(),
         logger(ome::common::createLogger("EntityResolver")),
-        entity_path_map(),
-        entity_data_map()
+        state(std::make_shared<const entity_state>()),
+        serial(next_serial.fetch_add(1, std::memory_order_relaxed)),
+        generation(0),
+        mutex()
       {
       }
 
@@ -91,12 +259,12 @@ namespace ome
               case xercesc::XMLResourceIdentifier::SchemaGrammar:
               case xercesc::XMLResourceIdentifier::SchemaImport:
                 {
-                  ret = getSource(String(resource->getSchemaLocation()));
+                  ret = getSource(resource->getSchemaLocation());
                 }
                 break;
               case xercesc::XMLResourceIdentifier::ExternalEntity:
                 {
-                  ret = getSource(String(resource->getSystemId()));
+                  ret = getSource(resource->getSystemId());
                 }
                 break;
               default:
@@ -107,102 +275,377 @@ namespace ome
         return ret;
       }
 
+      std::vector<std::string>
+      EntityResolver::getEntityIds() const
+      {
+        const entity_state& current(snapshot());
+
+        std::vector<std::string> ids;
+        ids.reserve(current.entities.size());
+        for (const auto& entity : current.entities)
+          ids.push_back(entity.first);
+        std::sort(ids.begin(), ids.end());
+        return ids;
+      }
+
       xercesc::InputSource *
-      EntityResolver::getSource(const std::string& resource)
+      EntityResolver::getSource(const std::string& resource) const
       {
-        xercesc::InputSource *ret = 0;
+        const entity_state& current(snapshot());
+
+        entity_map_type::const_iterator i = current.entities.find(resource);
+        if (i == current.entities.end())
+          return 0;
+
+        return makeSource(i->second);
+      }
+
+      xercesc::InputSource *
+      EntityResolver::getSource(const XMLCh *resource) const
+      {
+        if (!resource)
+          return 0;
+
+        const entity_state& current(snapshot());
 
-        entity_path_map_type::const_iterator i = entity_path_map.find(resource);
+        entity_index_type::const_iterator i = current.index.find(StringView(resource));
+        if (i == current.index.end())
+          return 0;
 
-        if (i != entity_path_map.end())
+        return makeSource(i->second);
+      }
+
+      const EntityResolver::entity_state&
+      EntityResolver::snapshot() const
+      {
+        // The generation is incremented after the snapshot is
+        // stored, so a snapshot loaded after reading the generation
+        // is at least as new as it.
+        uint64_t current = generation.load(std::memory_order_acquire);
+        if (current_snapshot.serial != serial ||
+            current_snapshot.generation != current)
           {
-            entity_data_map_type::iterator d = entity_data_map.find(resource);
+            current_snapshot.state = std::atomic_load(&state);
+            current_snapshot.serial = serial;
+            current_snapshot.generation = current;
+          }
+        return *static_cast<const entity_state *>(current_snapshot.state.get());
+      }
 
-            if (d == entity_data_map.end()) // No cached data
-              {
-                const boost::filesystem::path& file(i->second);
-
-                if (boost::filesystem::exists(file))
-                  {
-                    std::ifstream in(file.string().c_str());
-                    if (in)
-                      {
-                        std::string data;
-                        std::ios::pos_type pos = in.tellg();
-                        in.seekg(0, std::ios::end);
-                        std::ios::pos_type len = in.tellg() - pos;
-                        if (len)
-                          data.reserve(static_cast<std::string::size_type>(len));
-                        in.seekg(0, std::ios::beg);
-
-                        data.assign(std::istreambuf_iterator<char>(in),
-                                    std::istreambuf_iterator<char>());
-
-                        BOOST_LOG_SEV(logger, ome::logging::trivial::debug)
-                          << "Registering resource data " << resource
-                          << " (" << i->second << ")\n" << data;
-
-                        std::pair<entity_data_map_type::iterator,bool> valid =
-                          entity_data_map.insert(std::make_pair(resource, data));
-                        if (valid.second)
-                          d = valid.first;
-                      }
-                    else
-                      {
-                        boost::format fmt("Failed to load XML schema id ‘%1%’ from file ‘%2%’");
-                        fmt % resource % file.string();
-                        std::cerr << fmt.str() << '\n';
-                      }
-                  }
-              }
+      void
+      EntityResolver::store(std::shared_ptr<const entity_state> next) const
+      {
+        std::atomic_store(&state, std::move(next));
+        generation.fetch_add(1, std::memory_order_release);
+      }
 
-            if (d != entity_data_map.end()) // Cached data
-              {
-                const std::string&data(d->second);
+      void
+      EntityResolver::insert(entity_state&                 state,
+                             std::shared_ptr<const entity> e)
+      {
+        // The index key views the entity's own system ID, so must be
+        // replaced along with the entity.
+        StringView key(e->id.data(), e->id.size());
+        state.index.erase(key);
+        state.index.insert(std::make_pair(key, e));
+        state.entities[e->id.str()] = std::move(e);
+      }
+
+      void
+      EntityResolver::publish(const entity_state&           current,
+                              std::shared_ptr<const entity> e) const
+      {
+        std::shared_ptr<entity_state> next(std::make_shared<entity_state>(current));
+        insert(*next, std::move(e));
+
+        store(std::move(next));
+      }
+
+      xercesc::InputSource *
+      EntityResolver::makeSource(const std::shared_ptr<const entity>& e) const
+      {
+        std::shared_ptr<const std::string> data(e->data);
+        if (!data) // No cached data
+          data = load(*e);
+        if (!data)
+          return 0;
+
+        BOOST_LOG_SEV(logger, ome::logging::trivial::trace)
+          << "Returning resource " << e->id.str()
+          << " (" << e->file << ")";
+
+        return new SharedBufferInputSource(std::move(data), e->system_id);
+      }
+
+      std::shared_ptr<const std::string>
+      EntityResolver::read(const entity& e)
+      {
+        if (!boost::filesystem::exists(e.file))
+          return std::shared_ptr<const std::string>();
 
-                BOOST_LOG_SEV(logger, ome::logging::trivial::trace)
-                  << "Returning resource " << resource
-                  << " (" << i->second << ")\n" << data;
+        std::ifstream in(e.file.string().c_str(), std::ios::in | std::ios::binary);
+        if (in)
+          {
+            in.seekg(0, std::ios::end);
+            std::ios::pos_type len = in.tellg();
+            in.seekg(0, std::ios::beg);
 
-                ret = new xercesc::MemBufInputSource(reinterpret_cast<const XMLByte *>(data.c_str()),
-                                                     static_cast<XMLSize_t>(data.size()),
-                                                     String(i->second.string()));
+            if (len >= 0)
+              {
+                std::string content(static_cast<std::string::size_type>(len), '\0');
+                if (content.empty() || in.read(&content[0], static_cast<std::streamsize>(len)))
+                  return std::make_shared<const std::string>(std::move(content));
               }
           }
 
-        return ret;
+        boost::format fmt("Failed to load XML schema id ‘%1%’ from file ‘%2%’");
+        fmt % e.id.str() % e.file.string();
+        std::cerr << fmt.str() << '\n';
+        return std::shared_ptr<const std::string>();
+      }
+
+      std::shared_ptr<const std::string>
+      EntityResolver::load(const entity& e) const
+      {
+        // Read the file without holding the lock; if another thread
+        // is loading the same entity concurrently, the first to
+        // publish its data wins.
+        std::shared_ptr<const std::string> data(read(e));
+        if (!data)
+          return data;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::shared_ptr<const entity_state> current(std::atomic_load(&state));
+        // Entities are never removed or changed once registered.
+        entity_map_type::const_iterator i = current->entities.find(e.id.str());
+        assert(i != current->entities.end() && i->second->file == e.file);
+        if (i->second->data) // Loaded concurrently
+          return i->second->data;
+
+        BOOST_LOG_SEV(logger, ome::logging::trivial::debug)
+          << "Registering resource data " << e.id.str()
+          << " (" << e.file << ")\n" << *data;
+
+        publish(*current, std::make_shared<const entity>(e.id.str(), e.file, data));
+
+        return data;
       }
 
       void
       EntityResolver::registerEntity(const std::string&             id,
                                      const boost::filesystem::path& file)
       {
-        entity_path_map_type::iterator i = entity_path_map.find(id);
+        boost::filesystem::path path(canonical(file));
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::shared_ptr<const entity_state> current(std::atomic_load(&state));
+        entity_map_type::const_iterator i = current->entities.find(id);
 
-        if (i == entity_path_map.end())
+        if (i == current->entities.end())
           {
-            // Insert new entry.
-            entity_path_map.insert(std::make_pair(id, canonical(file)));
+            // Publish a new snapshot with the new entry.
+            publish(*current, std::make_shared<const entity>(id, path));
           }
         else
           {
-            if(canonical(file) != i->second)
+            if(path != i->second->file)
               {
                 boost::format fmt("Mismatch registering entity id ‘%1%’: File ‘%2%’ does not match existing cached file ‘%3%’");
-                fmt % id % i->second % file;
+                fmt % id % i->second->file % file;
                 std::cerr << fmt.str() << std::endl;
                 throw std::runtime_error(fmt.str());
               }
           }
       }
 
+      EntityResolver::PreloadStatistics
+      EntityResolver::preload(unsigned int threads)
+      {
+        std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+
+        std::vector<std::shared_ptr<const entity>> pending;
+        {
+          std::shared_ptr<const entity_state> current(std::atomic_load(&state));
+          for (const auto& e : current->entities)
+            if (!e.second->data)
+              pending.push_back(e.second);
+        }
+
+        if (threads == 0)
+          threads = std::max(std::thread::hardware_concurrency(), 1U);
+        if (threads > pending.size())
+          threads = std::max(static_cast<unsigned int>(pending.size()), 1U);
+
+        // Each worker claims the next unread entity; the files vary
+        // greatly in size, so static partitioning balances poorly.
+        std::vector<std::shared_ptr<const std::string>> data(pending.size());
+        std::atomic<std::size_t> next(0);
+
+        auto work = [&pending, &data, &next]() {
+          for (std::size_t i = next++; i < pending.size(); i = next++)
+            {
+              try
+                {
+                  data[i] = read(*pending[i]);
+                }
+              catch (const std::exception&)
+                {
+                  // Left null; counted as failed.
+                }
+            }
+        };
+
+        {
+          // Joins all started workers on every exit path.
+          struct joiner
+          {
+            ~joiner()
+            {
+              for (auto& worker : workers)
+                worker.join();
+            }
+
+            std::vector<std::thread> workers;
+          } pool;
+
+          try
+            {
+              pool.workers.reserve(threads - 1U);
+              for (unsigned int t = 1; t < threads; ++t)
+                pool.workers.emplace_back(work);
+            }
+          catch (const std::system_error&)
+            {
+              // Out of threads; the calling thread reads the rest.
+            }
+          catch (const std::bad_alloc&)
+            {
+            }
+
+          // The calling thread is also a worker.
+          work();
+          threads = static_cast<unsigned int>(pool.workers.size()) + 1U;
+        }
+
+        PreloadStatistics stats = {0, 0, 0, threads, std::chrono::steady_clock::duration::zero()};
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+
+          std::shared_ptr<const entity_state> current(std::atomic_load(&state));
+          std::shared_ptr<entity_state> next_state(std::make_shared<entity_state>(*current));
+
+          for (std::size_t i = 0; i < pending.size(); ++i)
+            {
+              if (!data[i])
+                {
+                  ++stats.failed;
+                  continue;
+                }
+
+              // Entities are never removed or changed once registered.
+              entity_map_type::const_iterator e = next_state->entities.find(pending[i]->id.str());
+              assert(e != next_state->entities.end() && e->second->file == pending[i]->file);
+              if (e->second->data) // Loaded concurrently
+                continue;
+
+              ++stats.loaded;
+              stats.bytes += data[i]->size();
+              insert(*next_state, std::make_shared<const entity>(pending[i]->id.str(), pending[i]->file, data[i]));
+            }
+
+          if (stats.loaded)
+            store(std::move(next_state));
+        }
+
+        stats.elapsed = std::chrono::steady_clock::now() - start;
+
+        BOOST_LOG_SEV(logger, ome::logging::trivial::info)
+          << "Preloaded " << stats.loaded << " resources (" << stats.bytes
+          << " bytes, " << stats.failed << " failed) using "
+          << stats.threads << " threads in "
+          << std::chrono::duration_cast<std::chrono::microseconds>(stats.elapsed).count()
+          << " µs";
+
+        return stats;
+      }
+
       void
-      EntityResolver::registerCatalog(const boost::filesystem::path& catalog)
+      EntityResolver::registerEntity(const std::string&                 id,
+                                     std::shared_ptr<const std::string> data)
+      {
+        if (!data)
+          {
+            boost::format fmt("Failed to register entity id ‘%1%’: No content");
+            fmt % id;
+            throw std::runtime_error(fmt.str());
+          }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::shared_ptr<const entity_state> current(std::atomic_load(&state));
+        entity_map_type::const_iterator i = current->entities.find(id);
+
+        if (i == current->entities.end())
+          {
+            publish(*current, std::make_shared<const entity>(id, boost::filesystem::path(), std::move(data)));
+          }
+        else
+          {
+            const entity& existing(*i->second);
+            if (!existing.file.empty() || !existing.data || *existing.data != *data)
+              {
+                boost::format fmt("Mismatch registering entity id ‘%1%’: Content does not match existing cached content from ‘%2%’");
+                fmt % id % (existing.file.empty() ? std::string("memory") : existing.file.string());
+                std::cerr << fmt.str() << std::endl;
+                throw std::runtime_error(fmt.str());
+              }
+          }
+      }
+
+      std::size_t
+      EntityResolver::registerEmbeddedSchemas()
+      {
+#ifdef OME_HAVE_EMBEDDED_SCHEMAS
+        std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+
+        for (std::size_t i = 0; i < detail::embedded_schema_count; ++i)
+          {
+            const detail::embedded_schema& schema(detail::embedded_schemas[i]);
+            const char *begin = reinterpret_cast<const char *>(schema.data);
+            registerEntity(schema.id,
+                           std::make_shared<const std::string>(begin, begin + schema.size));
+          }
+
+        BOOST_LOG_SEV(logger, ome::logging::trivial::info)
+          << "Registered " << detail::embedded_schema_count
+          << " embedded resources in "
+          << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()
+          << " µs";
+
+        return detail::embedded_schema_count;
+#else // ! OME_HAVE_EMBEDDED_SCHEMAS
+        return 0;
+#endif // OME_HAVE_EMBEDDED_SCHEMAS
+      }
+
+      void
+      EntityResolver::clearCatalogCache()
+      {
+        std::lock_guard<std::mutex> lock(catalog_cache_mutex);
+        catalog_cache.clear();
+      }
+
+      void
+      EntityResolver::registerCatalog(const boost::filesystem::path& catalog,
+                                      bool                           preload)
       {
         std::set<boost::filesystem::path> visited;
         std::deque<boost::filesystem::path> pending;
-
-	ome::common::xml::Platform platform;
+        std::vector<std::shared_ptr<const catalog_info>> catalogs;
+        std::unique_ptr<catalog_reader> reader;
 
         pending.push_back(ome::common::canonical(catalog));
 
@@ -220,57 +663,18 @@ namespace ome
                 continue; // This has already been processed; break loop
               }
 
-            boost::filesystem::path currentdir(current.parent_path());
-            assert(!currentdir.empty());
-
-            std::ifstream in(current.string().c_str());
-            if (in)
+            std::shared_ptr<const catalog_info> info(get_catalog(current, reader));
+            if (info)
               {
-                EntityResolver r; // Does nothing.
-                dom::Document doc(dom::createDocument(in, r,
-                                  dom::ParseParameters(),
-                                  current.string()));
-                dom::Element root(doc.getDocumentElement());
-                dom::NodeList nodes(root.getChildNodes());
-                for (auto& node : nodes)
-                  {
-                    if (node.getNodeType() == xercesc::DOMNode::ELEMENT_NODE)
-                      {
-                        dom::Element e(node.get(), false);
-                        if (e)
-                          {
-                            if (e.getTagName() == "uri")
-                              {
-                                if (e.hasAttribute("uri") && e.hasAttribute("name"))
-                                  {
-                                    boost::filesystem::path newid(currentdir / static_cast<std::string>(e.getAttribute("uri")));
-
-                                    BOOST_LOG_SEV(logger, ome::logging::trivial::debug)
-
-                                      << "Registering " << static_cast<std::string>(e.getAttribute("name"))
-                                      << " as " << ome::common::canonical(newid);
-                                    registerEntity(static_cast<std::string>(e.getAttribute("name")),
-                                                   ome::common::canonical(newid));
-                                  }
-                              }
-                            if (e.getTagName() == "nextCatalog")
-                              {
-                                if (e.hasAttribute("catalog"))
-                                  {
-                                    boost::filesystem::path newcatalog(currentdir / static_cast<std::string>(e.getAttribute("catalog")));
-                                    pending.push_back(ome::common::canonical(newcatalog));
-                                  }
-                              }
-                          }
-                      }
-                  }
+                catalogs.push_back(info);
+                pending.insert(pending.end(), info->catalogs.begin(), info->catalogs.end());
               }
 #ifndef NDEBUG
             // Don't make failure hard in release builds; just skip.
             else
               {
                 boost::format fmt("Failed to load XML catalog from file ‘%1%’");
-                fmt % catalog.string();
+                fmt % current.string();
                 throw std::runtime_error(fmt.str());
               }
 #endif
@@ -278,6 +682,47 @@ namespace ome
             // Mark this file visited.
             visited.insert(current);
           }
+
+        {
+          // Register all entries in a single snapshot; nothing is
+          // registered if any entry conflicts.
+          std::lock_guard<std::mutex> lock(mutex);
+
+          std::shared_ptr<const entity_state> current(std::atomic_load(&state));
+          std::shared_ptr<entity_state> next;
+
+          for (const auto& info : catalogs)
+            {
+              for (const auto& e : info->entities)
+                {
+                  const entity_state& latest(next ? *next : *current);
+                  entity_map_type::const_iterator i = latest.entities.find(e.first);
+
+                  if (i == latest.entities.end())
+                    {
+                      BOOST_LOG_SEV(logger, ome::logging::trivial::debug)
+                        << "Registering " << e.first << " as " << e.second;
+
+                      if (!next)
+                        next = std::make_shared<entity_state>(*current);
+                      insert(*next, std::make_shared<const entity>(e.first, e.second));
+                    }
+                  else if (e.second != i->second->file)
+                    {
+                      boost::format fmt("Mismatch registering entity id ‘%1%’: File ‘%2%’ does not match existing cached file ‘%3%’");
+                      fmt % e.first % e.second % i->second->file;
+                      std::cerr << fmt.str() << std::endl;
+                      throw std::runtime_error(fmt.str());
+                    }
+                }
+            }
+
+          if (next)
+            store(std::move(next));
+        }
+
+        if (preload)
+          this->preload();
       }
 
     }
@@ -39,13 +39,22 @@
 #ifndef OME_COMMON_XML_ENTITYRESOLVER_H
 #define OME_COMMON_XML_ENTITYRESOLVER_H
 
-#include <map>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <boost/filesystem/path.hpp>
 
 #include <ome/common/log.h>
+#include <ome/common/xml/Name.h>
+#include <ome/common/xml/StringView.h>
 
 #include <xercesc/util/XMLEntityResolver.hpp>
 
@@ -62,10 +71,46 @@ namespace ome
        * This resolver allows replacement of URLs with local files or
        * in-memory copies of XML schemas.  This permits efficient
        * validation without network access for commonly-used schemas.
+       * If the library was built with embedded schemas (@c
+       * OME_HAVE_EMBEDDED_SCHEMAS is defined), these may be
+       * registered with registerEmbeddedSchemas(), which requires no
+       * filesystem access at all.
+       *
+       * Entity registration and resolution are thread-safe, so a
+       * single resolver may be shared by parsers in multiple threads.
+       * The registered entities and their cached content are held in
+       * an immutable snapshot which is replaced atomically when
+       * changed, incrementing a generation counter.  Each thread
+       * keeps its own reference to the snapshot it last used, and
+       * only reloads it when the generation has changed, so lookups
+       * read a single atomic counter and do not lock or modify any
+       * shared state; concurrent parsers do not contend with each
+       * other.  Only registration, and the first load of each
+       * entity's content, take a lock to publish a new snapshot.
+       *
+       * @note A thread's cached snapshot is released when it next
+       * uses a different resolver, or when it exits, so entity
+       * content may remain allocated for a while after the
+       * resolver is destroyed.
        */
       class EntityResolver : public xercesc::XMLEntityResolver
       {
       public:
+        /// Statistics from preloading entity content.
+        struct PreloadStatistics
+        {
+          /// Number of entities loaded.
+          std::size_t loaded;
+          /// Number of entities which failed to load.
+          std::size_t failed;
+          /// Total size of the loaded content, in bytes.
+          std::size_t bytes;
+          /// Number of threads used.
+          unsigned int threads;
+          /// Time taken.
+          std::chrono::steady_clock::duration elapsed;
+        };
+
         /// Constructor.
         EntityResolver();
 
@@ -92,19 +137,96 @@ namespace ome
 	registerEntity(const std::string&             id,
 		       const boost::filesystem::path& file);
 
+        /**
+         * Register in-memory content with the entity resolver.
+         *
+         * The content is shared, not copied, by the resolver and
+         * the input sources it returns.
+         *
+         * @param id the XML system ID of the entity.
+         * @param data the content of the entity.
+         */
+        void
+        registerEntity(const std::string&                 id,
+                       std::shared_ptr<const std::string> data);
+
+        /**
+         * Register the schemas embedded in the library.
+         *
+         * The schemas and system IDs are taken from the catalog
+         * given by the @c embedded-schema-catalog build option.
+         * No filesystem access or catalog parsing is required.
+         *
+         * @returns the number of schemas registered; 0 if the library
+         * was built without embedded schemas.
+         */
+        std::size_t
+        registerEmbeddedSchemas();
+
         /**
 	 * Register a catalog with the entity resolver.
 	 *
+	 * The catalog, and any nested catalogs, are read with a
+	 * non-validating streaming parser.  The parsed catalogs are
+	 * cached for the lifetime of the process, and are reused by
+	 * all resolvers while the content of the catalog file is
+	 * unchanged, so registering the same catalog again requires
+	 * no parsing.  The cached entries hold canonical schema
+	 * filenames; if schema files or directories are moved while
+	 * their catalog is unchanged, use clearCatalogCache().
+	 *
+	 * All of the catalog entries are registered together; if any
+	 * conflicts with an existing registration, none are
+	 * registered.
+	 *
+	 * By default, the content of each entity is loaded when it is
+	 * first resolved.  If @c preload is set, all registered
+	 * entities are loaded immediately with preload(), so that the
+	 * first parse does not incur any file I/O.
+	 *
 	 * @param file the filename of the catalog.
+	 * @param preload load all registered entities immediately?
+	 * @throws std::runtime_error if a catalog can't be parsed, or
+	 * an entry conflicts with an existing registration.
 	 */
         void
-	registerCatalog(const boost::filesystem::path& file);
+	registerCatalog(const boost::filesystem::path& file,
+			bool                           preload = false);
 
-      private:
-        /// Mapping from system ID to filesystem path.
-        typedef std::map<std::string, boost::filesystem::path> entity_path_map_type;
-        /// Mapping from system ID to XML data.
-        typedef std::map<std::string, std::string> entity_data_map_type;
+        /**
+         * Clear the cache of parsed catalogs.
+         *
+         * The cache is shared by all resolvers.  Registrations
+         * already made are not affected.
+         */
+        static
+        void
+        clearCatalogCache();
+
+        /**
+         * Load the content of all registered entities.
+         *
+         * Entities which are already loaded are skipped.  The files
+         * are read in parallel, with the calling thread as one of
+         * the workers, and the content published in a single
+         * update.  If threads can't be created, the remaining files
+         * are read by the calling thread.  The time taken is logged,
+         * and also returned.
+         *
+         * @param threads the maximum number of threads to use (0 to
+         * use the hardware concurrency).
+         * @returns the preload statistics.
+         */
+        PreloadStatistics
+        preload(unsigned int threads = 0);
+
+        /**
+         * Get the system IDs of all registered entities.
+         *
+         * @returns the registered system IDs.
+         */
+        std::vector<std::string>
+        getEntityIds() const;
 
         /**
          * Get input source from file.
@@ -113,18 +235,157 @@ namespace ome
          * an InputSource.  Use cached content if possible.
          *
          * @param resource the resource to resolve.
-         * @returns the input source for the file, or null on failure.
+         * @returns the input source for the file, or null on failure;
+         * the caller takes ownership.
+         */
+        xercesc::InputSource *
+        getSource(const std::string& resource) const;
+
+        /**
+         * Get input source from file.
+         *
+         * As getSource(const std::string&), but looking up a UTF-16
+         * system ID directly, without transcoding or allocation.
+         *
+         * @param resource the resource to resolve (may be null).
+         * @returns the input source for the file, or null on failure;
+         * the caller takes ownership.
+         */
+        xercesc::InputSource *
+        getSource(const XMLCh *resource) const;
+
+      private:
+        /// A registered entity.
+        struct entity
+        {
+          /**
+           * Construct an entity.
+           *
+           * @param id the system ID of the entity.
+           * @param file the canonical filename of the entity (empty
+           * if registered from memory).
+           * @param data the cached content (null if not loaded).
+           */
+          entity(const std::string&                 id,
+                 const boost::filesystem::path&     file,
+                 std::shared_ptr<const std::string> data = std::shared_ptr<const std::string>()):
+            id(id),
+            file(file),
+            system_id(file.empty() ? id : file.string()),
+            data(std::move(data))
+          {
+          }
+
+          /// System ID.
+          Name id;
+          /// Canonical filename (empty if registered from memory).
+          boost::filesystem::path file;
+          /// Filename (or system ID if registered from memory),
+          /// pre-transcoded for use as an input source ID.
+          Name system_id;
+          /// Cached content (null if not loaded); immutable.
+          std::shared_ptr<const std::string> data;
+        };
+
+        /// Mapping from system ID to entity.
+        typedef std::unordered_map<std::string, std::shared_ptr<const entity>> entity_map_type;
+        /// Mapping from UTF-16 system ID (viewing entity::id) to entity.
+        typedef std::unordered_map<StringView, std::shared_ptr<const entity>> entity_index_type;
+
+        /// Immutable snapshot of the registered entities.
+        struct entity_state
+        {
+          /// Map of registered system IDs to entities.
+          entity_map_type entities;
+          /// Index of UTF-16 system IDs to entities.
+          entity_index_type index;
+        };
+
+        /**
+         * Get the current snapshot for lookups.
+         *
+         * The snapshot is cached by the calling thread, and is only
+         * reloaded if the generation has changed.  The reference
+         * remains valid until the calling thread next calls
+         * snapshot() on any resolver.
+         *
+         * @returns the current snapshot.
+         */
+        const entity_state&
+        snapshot() const;
+
+        /**
+         * Replace the current snapshot.
+         *
+         * The mutex must be held by the caller.
+         *
+         * @param next the new snapshot.
+         */
+        void
+        store(std::shared_ptr<const entity_state> next) const;
+
+        /**
+         * Add or replace an entity in a snapshot.
+         *
+         * @param state the snapshot to update.
+         * @param e the entity to add or replace.
+         */
+        static
+        void
+        insert(entity_state&                 state,
+               std::shared_ptr<const entity> e);
+
+        /**
+         * Publish a snapshot with an entity added or replaced.
+         *
+         * The mutex must be held by the caller.
+         *
+         * @param current the current snapshot.
+         * @param e the entity to add or replace.
+         */
+        void
+        publish(const entity_state&            current,
+                std::shared_ptr<const entity>  e) const;
+
+        /**
+         * Read the content of an entity.
+         *
+         * @param e the entity to read.
+         * @returns the content, or null on failure.
+         */
+        static
+        std::shared_ptr<const std::string>
+        read(const entity& e);
+
+        /**
+         * Get input source for an entity.
+         *
+         * @param e the entity.
+         * @returns the input source, or null on failure.
          */
         xercesc::InputSource *
-        getSource(const std::string& resource);
+        makeSource(const std::shared_ptr<const entity>& e) const;
+
+        /**
+         * Load and cache the content of an entity.
+         *
+         * @param e the entity to load.
+         * @returns the cached content, or null on failure.
+         */
+        std::shared_ptr<const std::string>
+        load(const entity& e) const;
 
         private:
-          /// Message logger.
-          ome::common::Logger logger;
-          /// Map of registered system IDs to filesystem paths.
-          entity_path_map_type entity_path_map;
-          /// Map of system IDs to cached XML data.
-          entity_data_map_type entity_data_map;
+          /// Message logger (thread-safe).
+          mutable ome::common::Logger logger;
+          /// Current snapshot; accessed atomically.
+          mutable std::shared_ptr<const entity_state> state;
+          /// Unique serial number of this resolver.
+          const std::uint64_t serial;
+          /// Snapshot generation, incremented when it is replaced.
+          mutable std::atomic<std::uint64_t> generation;
+          /// Mutex to serialise snapshot updates.
+          mutable std::mutex mutex;
       };
 
     }
@@ -0,0 +1,151 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_FORMATTARGET_H
+#define OME_COMMON_XML_FORMATTARGET_H
+
+#include <ome/common/config.h>
+
+#include <ostream>
+#include <string>
+
+#include <xercesc/framework/XMLFormatter.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+
+      /**
+       * Xerces format target writing to a std::ostream.
+       *
+       * Serialized output is written to the stream as it is
+       * produced, in chunks bounded by the size of the Xerces
+       * formatter buffer, rather than being accumulated in memory.
+       * The std::ostream must remain valid for the lifetime of the
+       * StreamFormatTarget.
+       */
+      class StreamFormatTarget : public xercesc::XMLFormatTarget
+      {
+      public:
+        /**
+         * Construct a StreamFormatTarget.
+         *
+         * @param stream the stream to write to.
+         */
+        explicit
+        StreamFormatTarget(std::ostream& stream);
+
+        /// Destructor.
+        ~StreamFormatTarget();
+
+        /**
+         * Write characters to the stream.
+         *
+         * @param toWrite the characters to write.
+         * @param count the number of characters to write.
+         * @param formatter the formatter in use.
+         * @throws std::runtime_error if the stream fails.
+         */
+        void
+        writeChars(const XMLByte * const toWrite,
+                   const XMLSize_t       count,
+                   xercesc::XMLFormatter * const formatter);
+
+        /**
+         * Flush the stream.
+         */
+        void
+        flush();
+
+      private:
+        /// The stream to write to.
+        std::ostream& stream;
+      };
+
+      /**
+       * Xerces format target appending to a std::string.
+       *
+       * Serialized output is appended directly to the string, without
+       * any intermediate buffer.  The std::string must remain valid
+       * for the lifetime of the StringFormatTarget.
+       */
+      class StringFormatTarget : public xercesc::XMLFormatTarget
+      {
+      public:
+        /**
+         * Construct a StringFormatTarget.
+         *
+         * @param text the string to append to.
+         */
+        explicit
+        StringFormatTarget(std::string& text);
+
+        /// Destructor.
+        ~StringFormatTarget();
+
+        /**
+         * Append characters to the string.
+         *
+         * @param toWrite the characters to write.
+         * @param count the number of characters to write.
+         * @param formatter the formatter in use.
+         */
+        void
+        writeChars(const XMLByte * const toWrite,
+                   const XMLSize_t       count,
+                   xercesc::XMLFormatter * const formatter);
+
+      private:
+        /// The string to append to.
+        std::string& text;
+      };
+
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_FORMATTARGET_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
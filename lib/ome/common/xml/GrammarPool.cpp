@@ -0,0 +1,211 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#include <stdexcept>
+
+#include <boost/format.hpp>
+
+#include <ome/common/xml/ErrorReporter.h>
+#include <ome/common/xml/GrammarPool.h>
+#include <ome/common/xml/String.h>
+
+#include <xercesc/framework/XMLGrammarPoolImpl.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/validators/common/Grammar.hpp>
+
+namespace
+{
+
+  bool
+  is_schema_id(const std::string& id)
+  {
+    static const std::string suffix(".xsd");
+
+    return id.size() >= suffix.size() &&
+      id.compare(id.size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+
+}
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+
+      GrammarPool::GrammarPool():
+        xmlplat(),
+        pool(new xercesc::XMLGrammarPoolImpl(xercesc::XMLPlatformUtils::fgMemoryManager)),
+        is_locked(false)
+      {
+      }
+
+      GrammarPool::GrammarPool(EntityResolver& resolver,
+                               bool            lock):
+        xmlplat(),
+        pool(new xercesc::XMLGrammarPoolImpl(xercesc::XMLPlatformUtils::fgMemoryManager)),
+        is_locked(false)
+      {
+        loadGrammars(resolver);
+        if (lock)
+          this->lock();
+      }
+
+      GrammarPool::~GrammarPool()
+      {
+      }
+
+      void
+      GrammarPool::loadGrammar(const std::string& id,
+                               EntityResolver&    resolver)
+      {
+        if (is_locked)
+          {
+            boost::format fmt("Unable to load XML schema id ‘%1%’ into locked grammar pool");
+            fmt % id;
+            throw std::runtime_error(fmt.str());
+          }
+
+        std::unique_ptr<xercesc::InputSource> source(resolver.getSource(id));
+        if (!source)
+          {
+            boost::format fmt("XML schema id ‘%1%’ is not registered");
+            fmt % id;
+            throw std::runtime_error(fmt.str());
+          }
+
+        // Use the system ID as the schema location so that documents
+        // referencing the schema by URL match the cached grammar.
+        source->setSystemId(String(id));
+
+        ErrorReporter er;
+
+        xercesc::XercesDOMParser parser(0, xercesc::XMLPlatformUtils::fgMemoryManager, pool.get());
+        parser.setErrorHandler(&er);
+        parser.setXMLEntityResolver(&resolver);
+        parser.setDoNamespaces(true);
+        parser.setDoSchema(true);
+        parser.setHandleMultipleImports(true);
+        parser.setValidationSchemaFullChecking(true);
+        parser.setLoadExternalDTD(false);
+        // Reuse grammars already in the pool for imported schemas.
+        parser.useCachedGrammarInParse(true);
+
+        xercesc::Grammar *grammar = 0;
+        try
+          {
+            grammar = parser.loadGrammar(*source, xercesc::Grammar::SchemaGrammarType, true);
+          }
+        catch (const xercesc::XMLException& e)
+          {
+            boost::format fmt("Failed to load XML schema id ‘%1%’: %2%");
+            fmt % id % String(e.getMessage()).str();
+            throw std::runtime_error(fmt.str());
+          }
+
+        if (er || !grammar)
+          {
+            boost::format fmt("Failed to load XML schema id ‘%1%’");
+            fmt % id;
+            throw std::runtime_error(fmt.str());
+          }
+      }
+
+      void
+      GrammarPool::loadGrammars(EntityResolver& resolver)
+      {
+        for (const auto& id : resolver.getEntityIds())
+          {
+            if (is_schema_id(id))
+              loadGrammar(id, resolver);
+          }
+      }
+
+      void
+      GrammarPool::lock()
+      {
+        if (!is_locked)
+          {
+            pool->lockPool();
+            is_locked = true;
+          }
+      }
+
+      void
+      GrammarPool::unlock()
+      {
+        if (is_locked)
+          {
+            pool->unlockPool();
+            is_locked = false;
+          }
+      }
+
+      bool
+      GrammarPool::locked() const
+      {
+        return is_locked;
+      }
+
+      std::size_t
+      GrammarPool::size() const
+      {
+        std::size_t count = 0;
+
+        xercesc::RefHashTableOfEnumerator<xercesc::Grammar> grammars(pool->getGrammarEnumerator());
+        while (grammars.hasMoreElements())
+          {
+            grammars.nextElement();
+            ++count;
+          }
+
+        return count;
+      }
+
+      xercesc::XMLGrammarPool *
+      GrammarPool::get()
+      {
+        return pool.get();
+      }
+
+    }
+  }
+}
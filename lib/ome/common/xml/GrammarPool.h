@@ -0,0 +1,193 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_GRAMMARPOOL_H
+#define OME_COMMON_XML_GRAMMARPOOL_H
+
+#include <ome/common/config.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <xercesc/framework/XMLGrammarPool.hpp>
+
+#include <ome/common/xml/EntityResolver.h>
+#include <ome/common/xml/Platform.h>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+
+      /**
+       * Cache of compiled XML schema grammars.
+       *
+       * Validating a document normally requires its schemas to be
+       * resolved, parsed and compiled before the document itself can
+       * be validated.  A GrammarPool holds the compiled grammars so
+       * that they may be shared by any number of parsers; validation
+       * then only incurs the cost of validating the document.
+       *
+       * The pool may be populated up front by loading the schemas
+       * registered with an EntityResolver (typically from an XML
+       * catalog with EntityResolver::registerCatalog()), and then
+       * locked.  A locked pool is immutable, and may be shared
+       * between parsers in multiple threads.  An unlocked pool will
+       * additionally cache any grammars encountered while parsing.
+       *
+       * The pool must outlive all parsers using it.
+       */
+      class GrammarPool
+      {
+      public:
+        /**
+         * Construct an empty, unlocked GrammarPool.
+         */
+        GrammarPool();
+
+        /**
+         * Construct a GrammarPool preloaded with the schemas
+         * registered with an EntityResolver.
+         *
+         * @param resolver the EntityResolver to load schemas from.
+         * @param lock lock the pool after loading?
+         * @throws std::runtime_error if a schema fails to load.
+         */
+        GrammarPool(EntityResolver& resolver,
+                    bool            lock = true);
+
+        /// Destructor.
+        ~GrammarPool();
+
+        /// Copy constructor (deleted).
+        GrammarPool(const GrammarPool&) = delete;
+
+        /// Assignment operator (deleted).
+        GrammarPool&
+        operator= (const GrammarPool&) = delete;
+
+        /**
+         * Load and cache a schema grammar.
+         *
+         * The schema and any schemas it imports or includes are
+         * obtained from the EntityResolver.
+         *
+         * @param id the XML system ID of the schema.
+         * @param resolver the EntityResolver to use.
+         * @throws std::runtime_error if the pool is locked, the schema
+         * is not registered with the resolver, or fails to load.
+         */
+        void
+        loadGrammar(const std::string& id,
+                    EntityResolver&    resolver);
+
+        /**
+         * Load and cache all schema grammars registered with an
+         * EntityResolver.
+         *
+         * All registered entities with a system ID ending in ".xsd"
+         * are loaded.
+         *
+         * @param resolver the EntityResolver to use.
+         * @throws std::runtime_error if the pool is locked or a schema
+         * fails to load.
+         */
+        void
+        loadGrammars(EntityResolver& resolver);
+
+        /**
+         * Lock the pool.
+         *
+         * No further grammars may be added to a locked pool.
+         */
+        void
+        lock();
+
+        /**
+         * Unlock the pool.
+         */
+        void
+        unlock();
+
+        /**
+         * Is the pool locked?
+         *
+         * @returns true if locked, false if unlocked.
+         */
+        bool
+        locked() const;
+
+        /**
+         * Get the number of cached grammars.
+         *
+         * @returns the number of grammars.
+         */
+        std::size_t
+        size() const;
+
+        /**
+         * Get the wrapped grammar pool.
+         *
+         * @returns the grammar pool.
+         */
+        xercesc::XMLGrammarPool *
+        get();
+
+      private:
+        /// Xerces platform (declared first, so destroyed last).
+        Platform xmlplat;
+        /// The grammar pool.
+        std::unique_ptr<xercesc::XMLGrammarPool> pool;
+        /// Is the pool locked?
+        bool is_locked;
+      };
+
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_GRAMMARPOOL_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
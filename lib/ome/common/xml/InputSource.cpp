@@ -0,0 +1,189 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+
+#include <ome/common/xml/InputSource.h>
+#include <ome/common/xml/String.h>
+
+#include <xercesc/util/BinMemInputStream.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+
+      StreamBinInputStream::StreamBinInputStream(std::istream& stream):
+        xercesc::BinInputStream(),
+        stream(stream),
+        pos(0)
+      {
+      }
+
+      StreamBinInputStream::~StreamBinInputStream()
+      {
+      }
+
+      XMLFilePos
+      StreamBinInputStream::curPos() const
+      {
+        return pos;
+      }
+
+      XMLSize_t
+      StreamBinInputStream::readBytes(XMLByte * const toFill,
+                                      const XMLSize_t maxToRead)
+      {
+        typedef std::istream::traits_type traits_type;
+
+        std::streambuf *buf = stream.rdbuf();
+        if (!buf || !stream.good() || maxToRead == 0)
+          return 0;
+
+        // Wait for at least one byte to become available.
+        if (traits_type::eq_int_type(buf->sgetc(), traits_type::eof()))
+          {
+            stream.setstate(std::ios::eofbit);
+            return 0;
+          }
+
+        // Read what is available without blocking.
+        std::streamsize avail = std::max(buf->in_avail(), std::streamsize(1));
+        std::streamsize count = buf->sgetn(reinterpret_cast<char *>(toFill),
+                                           std::min(avail, static_cast<std::streamsize>(maxToRead)));
+        if (count < 0)
+          count = 0;
+
+        pos += static_cast<XMLFilePos>(count);
+        return static_cast<XMLSize_t>(count);
+      }
+
+      const XMLCh *
+      StreamBinInputStream::getContentType() const
+      {
+        return 0;
+      }
+
+      StreamInputSource::StreamInputSource(std::istream&      stream,
+                                           const std::string& id):
+        xercesc::InputSource(),
+        stream(stream)
+      {
+        setSystemId(String(id));
+      }
+
+      StreamInputSource::~StreamInputSource()
+      {
+      }
+
+      xercesc::BinInputStream *
+      StreamInputSource::makeStream() const
+      {
+        return new StreamBinInputStream(stream);
+      }
+
+      MappedFileInputSource::MappedFileInputSource(const boost::filesystem::path& file):
+        xercesc::InputSource(),
+        mapping()
+      {
+        boost::filesystem::path absfile(boost::filesystem::absolute(file));
+
+        setSystemId(String(absfile.generic_string()));
+
+        try
+          {
+            // Empty files can not be mapped.
+            if (boost::filesystem::file_size(absfile) > 0)
+              mapping.open(absfile.string());
+          }
+        catch (const std::exception& e)
+          {
+            boost::format fmt("Failed to map XML file ‘%1%’: %2%");
+            fmt % absfile.string() % e.what();
+            throw std::runtime_error(fmt.str());
+          }
+      }
+
+      MappedFileInputSource::~MappedFileInputSource()
+      {
+      }
+
+      xercesc::BinInputStream *
+      MappedFileInputSource::makeStream() const
+      {
+        static const XMLByte empty[] = { 0 };
+
+        if (!mapping.is_open())
+          return new xercesc::BinMemInputStream(empty, 0,
+                                                xercesc::BinMemInputStream::BufOpt_Reference);
+
+        return new xercesc::BinMemInputStream(reinterpret_cast<const XMLByte *>(mapping.data()),
+                                              static_cast<XMLSize_t>(mapping.size()),
+                                              xercesc::BinMemInputStream::BufOpt_Reference);
+      }
+
+      SharedBufferInputSource::SharedBufferInputSource(std::shared_ptr<const std::string> buffer,
+                                                       const XMLCh                        *id):
+        xercesc::InputSource(),
+        buffer(std::move(buffer))
+      {
+        setSystemId(id);
+      }
+
+      SharedBufferInputSource::~SharedBufferInputSource()
+      {
+      }
+
+      xercesc::BinInputStream *
+      SharedBufferInputSource::makeStream() const
+      {
+        return new xercesc::BinMemInputStream(reinterpret_cast<const XMLByte *>(buffer->data()),
+                                              static_cast<XMLSize_t>(buffer->size()),
+                                              xercesc::BinMemInputStream::BufOpt_Reference);
+      }
+
+    }
+  }
+}
@@ -0,0 +1,238 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_INPUTSOURCE_H
+#define OME_COMMON_XML_INPUTSOURCE_H
+
+#include <ome/common/config.h>
+
+#include <istream>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/util/BinInputStream.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+
+      /**
+       * Xerces input stream reading from a std::istream.
+       *
+       * Data is passed to the parser as it becomes available, so
+       * parsing may proceed incrementally from non-seekable sources
+       * such as pipes and sockets.  The std::istream must remain
+       * valid for the lifetime of the StreamBinInputStream.
+       */
+      class StreamBinInputStream : public xercesc::BinInputStream
+      {
+      public:
+        /**
+         * Construct a StreamBinInputStream.
+         *
+         * @param stream the stream to read.
+         */
+        explicit
+        StreamBinInputStream(std::istream& stream);
+
+        /// Destructor.
+        ~StreamBinInputStream();
+
+        /**
+         * Get the current position in the stream.
+         *
+         * @returns the number of bytes read.
+         */
+        XMLFilePos
+        curPos() const;
+
+        /**
+         * Read bytes from the stream.
+         *
+         * Blocks until at least one byte is available, but returns
+         * only what is immediately available thereafter.
+         *
+         * @param toFill the buffer to fill.
+         * @param maxToRead the buffer size.
+         * @returns the number of bytes read, or zero at end of stream.
+         */
+        XMLSize_t
+        readBytes(XMLByte * const toFill,
+                  const XMLSize_t maxToRead);
+
+        /**
+         * Get the content type.
+         *
+         * @returns null (the content type is unknown).
+         */
+        const XMLCh *
+        getContentType() const;
+
+      private:
+        /// The stream to read.
+        std::istream& stream;
+        /// The number of bytes read.
+        XMLFilePos pos;
+      };
+
+      /**
+       * Xerces input source reading from a std::istream.
+       *
+       * Unlike copying the stream content into memory and then
+       * parsing it, the stream is read incrementally during parsing.
+       * The std::istream must remain valid for the lifetime of the
+       * StreamInputSource, and may only be parsed once.
+       */
+      class StreamInputSource : public xercesc::InputSource
+      {
+      public:
+        /**
+         * Construct a StreamInputSource.
+         *
+         * @param stream the stream to read.
+         * @param id document filename (for error reporting only).
+         */
+        StreamInputSource(std::istream&      stream,
+                          const std::string& id = "streambuf");
+
+        /// Destructor.
+        ~StreamInputSource();
+
+        /**
+         * Create an input stream for the parser.
+         *
+         * @returns a new StreamBinInputStream; the caller takes ownership.
+         */
+        xercesc::BinInputStream *
+        makeStream() const;
+
+      private:
+        /// The stream to read.
+        std::istream& stream;
+      };
+
+      /**
+       * Xerces input source reading from a memory-mapped file.
+       *
+       * The file is mapped into memory and parsed in place, without
+       * any intermediate copies.
+       */
+      class MappedFileInputSource : public xercesc::InputSource
+      {
+      public:
+        /**
+         * Construct a MappedFileInputSource.
+         *
+         * @param file the file to map.
+         * @throws std::runtime_error if the file can not be mapped.
+         */
+        explicit
+        MappedFileInputSource(const boost::filesystem::path& file);
+
+        /// Destructor.
+        ~MappedFileInputSource();
+
+        /**
+         * Create an input stream for the parser.
+         *
+         * @returns a new input stream over the mapped file; the
+         * caller takes ownership.
+         */
+        xercesc::BinInputStream *
+        makeStream() const;
+
+      private:
+        /// The mapped file.
+        boost::iostreams::mapped_file_source mapping;
+      };
+
+      /**
+       * Xerces input source reading from a shared immutable buffer.
+       *
+       * The buffer is parsed in place and is kept alive by the input
+       * source, so it may be shared by any number of concurrent
+       * parses without copying.
+       */
+      class SharedBufferInputSource : public xercesc::InputSource
+      {
+      public:
+        /**
+         * Construct a SharedBufferInputSource.
+         *
+         * @param buffer the buffer to read.
+         * @param id the system ID (for relative entity resolution and
+         * error reporting).
+         */
+        SharedBufferInputSource(std::shared_ptr<const std::string> buffer,
+                                const XMLCh                        *id);
+
+        /// Destructor.
+        ~SharedBufferInputSource();
+
+        /**
+         * Create an input stream for the parser.
+         *
+         * @returns a new input stream over the buffer; the caller
+         * takes ownership.
+         */
+        xercesc::BinInputStream *
+        makeStream() const;
+
+      private:
+        /// The buffer to read.
+        std::shared_ptr<const std::string> buffer;
+      };
+
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_INPUTSOURCE_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
@@ -0,0 +1,82 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <ome/common/xml/Name.h>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+
+      Name::Name(const char *name):
+        Name(std::string(name))
+      {
+      }
+
+      Name::Name(const std::string& name):
+        narrow(name),
+        wide()
+      {
+        wide.resize(String::transcode(narrow.data(), narrow.size(), static_cast<XMLCh *>(0)) + 1);
+        String::transcode(narrow.data(), narrow.size(), &wide[0]);
+        wide.back() = 0;
+      }
+
+      const Name&
+      Name::intern(const std::string& name)
+      {
+        static std::mutex mutex;
+        static std::unordered_map<std::string, std::unique_ptr<Name>> names;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto i = names.find(name);
+        if (i == names.end())
+          i = names.insert(std::make_pair(name, std::unique_ptr<Name>(new Name(name)))).first;
+        return *(i->second);
+      }
+
+    }
+  }
+}
@@ -0,0 +1,314 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_NAME_H
+#define OME_COMMON_XML_NAME_H
+
+#include <ome/common/config.h>
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <xercesc/util/XMLString.hpp>
+
+#include <ome/common/xml/String.h>
+#include <ome/common/xml/StringView.h>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+
+      /**
+       * Pre-transcoded XML name.
+       *
+       * A Name holds an element or attribute name in both UTF-8 and
+       * UTF-16 forms, transcoded once upon construction.  Passing a
+       * Name to the DOM wrapper methods, or comparing it with a
+       * Xerces string, does not require any transcoding or
+       * allocation.  This makes it suitable for names which are used
+       * repeatedly, for example:
+       *
+       * @code
+       * static const xml::Name uri("uri");
+       * if (element.hasAttribute(uri))
+       *   value = element.getAttribute(uri);
+       * @endcode
+       *
+       * Names do not require the Xerces platform to be initialised,
+       * so may be defined as static constants.  Names only known at
+       * runtime may be interned with intern(), which returns a
+       * unique Name instance for each distinct name.
+       */
+      class Name
+      {
+      public:
+        /**
+         * Construct a Name from a NUL-terminated UTF-8 string.
+         *
+         * @param name the name.
+         * @throws std::runtime_error if the name is not valid UTF-8.
+         */
+        explicit
+        Name(const char *name);
+
+        /**
+         * Construct a Name from a UTF-8 string.
+         *
+         * @param name the name.
+         * @throws std::runtime_error if the name is not valid UTF-8.
+         */
+        explicit
+        Name(const std::string& name);
+
+        /**
+         * Get the interned Name for a string.
+         *
+         * The same Name instance is returned for every call with the
+         * same string, and remains valid for the lifetime of the
+         * program.  This function is thread-safe.
+         *
+         * @param name the name.
+         * @returns the interned Name.
+         * @throws std::runtime_error if the name is not valid UTF-8.
+         */
+        static
+        const Name&
+        intern(const std::string& name);
+
+        /**
+         * Get the name as a NUL-terminated UTF-16 string.
+         *
+         * @returns the UTF-16 name.
+         */
+        const XMLCh *
+        data() const
+        {
+          return &wide[0];
+        }
+
+        /**
+         * Get the length of the UTF-16 name.
+         *
+         * @returns the length, in UTF-16 code units.
+         */
+        std::size_t
+        size() const
+        {
+          return wide.size() - 1;
+        }
+
+        /**
+         * Cast Name to XMLCh *.
+         *
+         * @returns the NUL-terminated UTF-16 name.
+         */
+        operator const XMLCh *() const
+        {
+          return data();
+        }
+
+        /**
+         * Get the name as a UTF-8 string.
+         *
+         * @returns the UTF-8 name.
+         */
+        const std::string&
+        str() const
+        {
+          return narrow;
+        }
+
+        /**
+         * Get a view of the UTF-16 name.
+         *
+         * @returns the view.
+         */
+        StringView
+        view() const
+        {
+          return StringView(data(), size());
+        }
+
+        /**
+         * Compare a Name for equality with a Name.
+         *
+         * @param rhs the name to compare.
+         * @returns @c true if equal, @c false otherwise.
+         */
+        bool
+        operator== (const Name& rhs) const
+        {
+          return this == &rhs || wide == rhs.wide;
+        }
+
+        /**
+         * Compare a Name for equality with a NUL-terminated UTF-16
+         * string.
+         *
+         * @param rhs the string to compare.
+         * @returns @c true if equal, @c false otherwise.
+         */
+        bool
+        operator== (const XMLCh *rhs) const
+        {
+          if (!rhs)
+            return false;
+          for (std::size_t i = 0; i < wide.size(); ++i)
+            if (wide[i] != rhs[i])
+              return false;
+          return true;
+        }
+
+        /**
+         * Compare a Name for inequality with a Name.
+         *
+         * @param rhs the name to compare.
+         * @returns @c true if not equal, @c false otherwise.
+         */
+        bool
+        operator!= (const Name& rhs) const
+        {
+          return !(*this == rhs);
+        }
+
+        /**
+         * Compare a Name for inequality with a NUL-terminated UTF-16
+         * string.
+         *
+         * @param rhs the string to compare.
+         * @returns @c true if not equal, @c false otherwise.
+         */
+        bool
+        operator!= (const XMLCh *rhs) const
+        {
+          return !(*this == rhs);
+        }
+
+      private:
+        /// The UTF-8 name.
+        std::string narrow;
+        /// The NUL-terminated UTF-16 name.
+        std::vector<XMLCh> wide;
+      };
+
+      /**
+       * Compare a String for equality with a Name.
+       *
+       * @param lhs the string to compare.
+       * @param rhs the name to compare.
+       * @returns @c true if equal, @c false otherwise.
+       */
+      inline bool
+      operator== (const String& lhs,
+                  const Name&   rhs)
+      {
+        return rhs == static_cast<const XMLCh *>(lhs);
+      }
+
+      /**
+       * Compare a String for inequality with a Name.
+       *
+       * @param lhs the string to compare.
+       * @param rhs the name to compare.
+       * @returns @c true if not equal, @c false otherwise.
+       */
+      inline bool
+      operator!= (const String& lhs,
+                  const Name&   rhs)
+      {
+        return !(lhs == rhs);
+      }
+
+      /**
+       * Compare a StringView for equality with a Name.
+       *
+       * @param lhs the string to compare.
+       * @param rhs the name to compare.
+       * @returns @c true if equal, @c false otherwise.
+       */
+      inline bool
+      operator== (const StringView& lhs,
+                  const Name&       rhs)
+      {
+        return lhs == rhs.view();
+      }
+
+      /**
+       * Compare a StringView for inequality with a Name.
+       *
+       * @param lhs the string to compare.
+       * @param rhs the name to compare.
+       * @returns @c true if not equal, @c false otherwise.
+       */
+      inline bool
+      operator!= (const StringView& lhs,
+                  const Name&       rhs)
+      {
+        return !(lhs == rhs);
+      }
+
+      /**
+       * Output Name to output stream.
+       *
+       * @param os the output stream.
+       * @param name the Name to output.
+       * @returns the output stream.
+       */
+      inline ::std::ostream&
+      operator<< (::std::ostream& os,
+                  const Name&     name)
+      {
+        return os << name.str();
+      }
+
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_NAME_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
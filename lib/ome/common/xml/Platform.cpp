@@ -47,6 +47,8 @@ namespace ome
 
       std::mutex Platform::mutex;
 
+      std::atomic<uint32_t> Platform::refcount(0);
+
     }
   }
 }
@@ -39,6 +39,8 @@
 #ifndef OME_COMMON_XML_PLATFORM_H
 #define OME_COMMON_XML_PLATFORM_H
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 
 #include <xercesc/util/PlatformUtils.hpp>
@@ -65,35 +67,74 @@ namespace ome
        * complete.  When the scope is exited, or an exception is thrown,
        * Xerces will be automatically terminated.  Any number of
        * instances of this class may be created; Xerces will only be
+       * initialized when the first instance is created, and
        * terminated when the last instance is destroyed.
+       *
+       * Creating or destroying an instance while other instances
+       * exist only updates an atomic reference count, and does not
+       * take a lock, so short-lived instances may be created freely by
+       * concurrent threads.  Holding an instance for the lifetime of
+       * the process (or of a long-lived parser) keeps Xerces
+       * initialized throughout.
        */
       class Platform
       {
       public:
         inline
         /**
-         * Construct a Platform.  Calls xercesc::XMLPlatformUtils::Initialize().
+         * Construct a Platform.  Calls xercesc::XMLPlatformUtils::Initialize()
+         * for the first instance.
          */
         Platform()
         {
-	  std::lock_guard<std::mutex> lock(mutex);
+          // Fast path: already initialized; take a reference.
+          uint32_t count = refcount.load(std::memory_order_acquire);
+          while (count != 0)
+            {
+              if (refcount.compare_exchange_weak(count, count + 1,
+                                                 std::memory_order_acq_rel))
+                return;
+            }
 
-          xercesc::XMLPlatformUtils::Initialize();
+          std::lock_guard<std::mutex> lock(mutex);
+
+          // Only call Initialize for first instance.  The reference
+          // is published after initialization is complete.
+          if (refcount.load(std::memory_order_acquire) == 0)
+            xercesc::XMLPlatformUtils::Initialize();
+          refcount.fetch_add(1, std::memory_order_acq_rel);
         }
 
         /**
-         * Destructor. Calls xercesc::XMLPlatformUtils::Terminate().
+         * Destructor. Calls xercesc::XMLPlatformUtils::Terminate()
+         * for the last instance.
          */
         inline
         ~Platform()
         {
-	  std::lock_guard<std::mutex> lock(mutex);
+          // Fast path: not the last instance; drop a reference.
+          uint32_t count = refcount.load(std::memory_order_acquire);
+          while (count > 1)
+            {
+              if (refcount.compare_exchange_weak(count, count - 1,
+                                                 std::memory_order_acq_rel))
+                return;
+            }
+
+          std::lock_guard<std::mutex> lock(mutex);
 
-          xercesc::XMLPlatformUtils::Terminate();
+          // Only call Terminate for last instance.
+          // refcount will never be zero at this point.
+          if (refcount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            xercesc::XMLPlatformUtils::Terminate();
         }
 
-	/// Mutex to lock libxerces access.
+        /// Mutex to lock libxerces access.
         static std::mutex mutex;
+
+      private:
+        /// Reference count.
+        static std::atomic<uint32_t> refcount;
       };
 
     }
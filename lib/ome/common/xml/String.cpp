@@ -36,12 +36,284 @@
  * #L%
  */
 
+#include <cstdint>
 #include <cstring>
 #include <stdexcept>
 
 #include <ome/common/xml/String.h>
 
-#include <xercesc/util/TransService.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  define OME_COMMON_XML_STRING_X86 1
+#  include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#  define OME_COMMON_XML_STRING_NEON 1
+#  include <arm_neon.h>
+#endif
+
+namespace
+{
+
+  /*
+   * ASCII kernels.
+   *
+   * Each kernel converts the leading ASCII characters of a UTF-8 or
+   * UTF-16 string to the other form, stopping at the first
+   * non-ASCII character.  If the destination is null, the
+   * characters are only checked.  The number of ASCII characters
+   * converted is returned; if this is less than the input size,
+   * the caller must continue with the general transcoding path.
+   */
+
+  /// UTF-8 to UTF-16 ASCII kernel.
+  typedef std::size_t (*widen_function)(const char *, std::size_t, XMLCh *);
+
+  /// UTF-16 to UTF-8 ASCII kernel.
+  typedef std::size_t (*narrow_function)(const XMLCh *, std::size_t, char *);
+
+  std::size_t
+  widen_scalar(const char  *src,
+               std::size_t  size,
+               XMLCh       *dest)
+  {
+    std::size_t i = 0;
+    for (; i < size; ++i)
+      {
+        const unsigned char c = static_cast<unsigned char>(src[i]);
+        if (c >= 0x80)
+          break;
+        if (dest)
+          dest[i] = static_cast<XMLCh>(c);
+      }
+    return i;
+  }
+
+  std::size_t
+  narrow_scalar(const XMLCh *src,
+                std::size_t  size,
+                char        *dest)
+  {
+    std::size_t i = 0;
+    for (; i < size; ++i)
+      {
+        const XMLCh c = src[i];
+        if (c >= 0x80)
+          break;
+        if (dest)
+          dest[i] = static_cast<char>(c);
+      }
+    return i;
+  }
+
+#ifdef OME_COMMON_XML_STRING_X86
+
+  __attribute__((target("sse2")))
+  std::size_t
+  widen_sse2(const char  *src,
+             std::size_t  size,
+             XMLCh       *dest)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+
+    for (; i + 16 <= size; i += 16)
+      {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        if (_mm_movemask_epi8(v))
+          break; // Not ASCII.
+        if (dest)
+          {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), _mm_unpacklo_epi8(v, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i + 8), _mm_unpackhi_epi8(v, zero));
+          }
+      }
+
+    return i + widen_scalar(src + i, size - i, dest ? dest + i : 0);
+  }
+
+  __attribute__((target("sse2")))
+  std::size_t
+  narrow_sse2(const XMLCh *src,
+              std::size_t  size,
+              char        *dest)
+  {
+    const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+
+    for (; i + 16 <= size; i += 16)
+      {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8));
+        const __m128i high = _mm_and_si128(_mm_or_si128(v0, v1), mask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF)
+          break; // Not ASCII.
+        if (dest)
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), _mm_packus_epi16(v0, v1));
+      }
+
+    return i + narrow_scalar(src + i, size - i, dest ? dest + i : 0);
+  }
+
+  __attribute__((target("avx2")))
+  std::size_t
+  widen_avx2(const char  *src,
+             std::size_t  size,
+             XMLCh       *dest)
+  {
+    std::size_t i = 0;
+
+    for (; i + 32 <= size; i += 32)
+      {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        if (_mm256_movemask_epi8(v))
+          break; // Not ASCII.
+        if (dest)
+          {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i),
+                                _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i + 16),
+                                _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+          }
+      }
+
+    // Avoid AVX-SSE transition penalties in the tail and the caller.
+    _mm256_zeroupper();
+
+    return i + widen_sse2(src + i, size - i, dest ? dest + i : 0);
+  }
+
+  __attribute__((target("avx2")))
+  std::size_t
+  narrow_avx2(const XMLCh *src,
+              std::size_t  size,
+              char        *dest)
+  {
+    const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    std::size_t i = 0;
+
+    for (; i + 32 <= size; i += 32)
+      {
+        const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 16));
+        if (!_mm256_testz_si256(_mm256_or_si256(v0, v1), mask))
+          break; // Not ASCII.
+        if (dest)
+          {
+            // packus interleaves the 128-bit lanes; restore the order.
+            const __m256i packed = _mm256_packus_epi16(v0, v1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i),
+                                _mm256_permute4x64_epi64(packed, 0xD8));
+          }
+      }
+
+    // Avoid AVX-SSE transition penalties in the tail and the caller.
+    _mm256_zeroupper();
+
+    return i + narrow_sse2(src + i, size - i, dest ? dest + i : 0);
+  }
+
+#endif // OME_COMMON_XML_STRING_X86
+
+#ifdef OME_COMMON_XML_STRING_NEON
+
+  std::size_t
+  widen_neon(const char  *src,
+             std::size_t  size,
+             XMLCh       *dest)
+  {
+    std::size_t i = 0;
+
+    for (; i + 16 <= size; i += 16)
+      {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(src + i));
+        if (vmaxvq_u8(v) >= 0x80)
+          break; // Not ASCII.
+        if (dest)
+          {
+            vst1q_u16(reinterpret_cast<uint16_t *>(dest + i), vmovl_u8(vget_low_u8(v)));
+            vst1q_u16(reinterpret_cast<uint16_t *>(dest + i + 8), vmovl_u8(vget_high_u8(v)));
+          }
+      }
+
+    return i + widen_scalar(src + i, size - i, dest ? dest + i : 0);
+  }
+
+  std::size_t
+  narrow_neon(const XMLCh *src,
+              std::size_t  size,
+              char        *dest)
+  {
+    std::size_t i = 0;
+
+    for (; i + 16 <= size; i += 16)
+      {
+        const uint16x8_t v0 = vld1q_u16(reinterpret_cast<const uint16_t *>(src + i));
+        const uint16x8_t v1 = vld1q_u16(reinterpret_cast<const uint16_t *>(src + i + 8));
+        if (vmaxvq_u16(vorrq_u16(v0, v1)) >= 0x80)
+          break; // Not ASCII.
+        if (dest)
+          vst1q_u8(reinterpret_cast<uint8_t *>(dest + i),
+                   vcombine_u8(vmovn_u16(v0), vmovn_u16(v1)));
+      }
+
+    return i + narrow_scalar(src + i, size - i, dest ? dest + i : 0);
+  }
+
+#endif // OME_COMMON_XML_STRING_NEON
+
+  /// ASCII kernels for the current system.
+  struct ascii_kernels
+  {
+    /// UTF-8 to UTF-16 kernel.
+    widen_function widen;
+    /// UTF-16 to UTF-8 kernel.
+    narrow_function narrow;
+
+    ascii_kernels():
+      widen(widen_scalar),
+      narrow(narrow_scalar)
+    {
+#if defined(OME_COMMON_XML_STRING_X86)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+        {
+          widen = widen_avx2;
+          narrow = narrow_avx2;
+        }
+      else if (__builtin_cpu_supports("sse2"))
+        {
+          widen = widen_sse2;
+          narrow = narrow_sse2;
+        }
+#elif defined(OME_COMMON_XML_STRING_NEON)
+      widen = widen_neon;
+      narrow = narrow_neon;
+#endif
+    }
+  };
+
+  const ascii_kernels&
+  kernels()
+  {
+    static const ascii_kernels k;
+    return k;
+  }
+
+  [[noreturn]] void
+  utf8_failure()
+  {
+    throw std::runtime_error("XML UTF-8 to UTF-16 transcoding failure");
+  }
+
+  [[noreturn]] void
+  utf16_failure()
+  {
+    throw std::runtime_error("XML UTF-16 to UTF-8 transcoding failure");
+  }
+
+}
 
 namespace ome
 {
@@ -50,48 +322,372 @@ namespace ome
     namespace xml
     {
 
+      String::String(const String& rhs):
+        narrow(0),
+        narrow_size(rhs.narrow_size),
+        wide(0),
+        wide_size(rhs.wide_size),
+        used(0),
+        narrow_heap(),
+        wide_heap()
+      {
+        if (rhs.wide)
+          {
+            XMLCh *dest = allocateWide(wide_size);
+            std::memcpy(dest, rhs.wide, (wide_size + 1) * sizeof(XMLCh));
+            wide = dest;
+          }
+        if (rhs.narrow)
+          {
+            char *dest = allocateNarrow(narrow_size);
+            std::memcpy(dest, rhs.narrow, narrow_size + 1);
+            narrow = dest;
+          }
+      }
+
+      String::String(String&& rhs) noexcept:
+        narrow(0),
+        narrow_size(0),
+        wide(0),
+        wide_size(0),
+        used(0),
+        narrow_heap(),
+        wide_heap()
+      {
+        take(rhs);
+      }
+
+      String&
+      String::operator= (String&& rhs) noexcept
+      {
+        if (this != &rhs)
+          take(rhs);
+        return *this;
+      }
+
+      void
+      String::take(String& rhs) noexcept
+      {
+        std::memcpy(buffer, rhs.buffer, rhs.used);
+        used = rhs.used;
+        narrow_heap = std::move(rhs.narrow_heap);
+        wide_heap = std::move(rhs.wide_heap);
+
+        // Rebase pointers into the inline buffer.
+        narrow = rhs.narrow;
+        if (narrow && !narrow_heap)
+          narrow = buffer + (rhs.narrow - rhs.buffer);
+        wide = rhs.wide;
+        if (wide && !wide_heap)
+          wide = reinterpret_cast<const XMLCh *>(buffer + (reinterpret_cast<const char *>(rhs.wide) - rhs.buffer));
+        narrow_size = rhs.narrow_size;
+        wide_size = rhs.wide_size;
+
+        // Leave rhs as an empty string.
+        rhs.narrow = rhs.buffer;
+        rhs.buffer[0] = '\0';
+        rhs.narrow_size = 0;
+        rhs.wide = 0;
+        rhs.wide_size = 0;
+        rhs.used = 1;
+      }
+
+      void
+      String::assignNarrow(const char  *str,
+                           std::size_t  size)
+      {
+        // Validate and size the UTF-16 form up front, so that
+        // invalid input is reported by the constructor.
+        wide_size = transcode(str, size, static_cast<XMLCh *>(0));
+
+        char *dest = allocateNarrow(size);
+        if (size)
+          std::memcpy(dest, str, size);
+        dest[size] = '\0';
+        narrow = dest;
+        narrow_size = size;
+      }
+
+      void
+      String::assignWide(const XMLCh *str,
+                         std::size_t  size)
+      {
+        // Validate and size the UTF-8 form up front, so that invalid
+        // input is reported by the constructor.
+        narrow_size = transcode(str, size, static_cast<char *>(0));
+
+        XMLCh *dest = allocateWide(size);
+        if (size)
+          std::memcpy(dest, str, size * sizeof(XMLCh));
+        dest[size] = 0;
+        wide = dest;
+        wide_size = size;
+      }
+
+      void
+      String::makeNarrow() const
+      {
+        assert(wide != 0);
+
+        char *dest = allocateNarrow(narrow_size);
+        transcode(wide, wide_size, dest);
+        dest[narrow_size] = '\0';
+        narrow = dest;
+      }
+
+      void
+      String::makeWide() const
+      {
+        assert(narrow != 0);
+
+        XMLCh *dest = allocateWide(wide_size);
+        transcode(narrow, narrow_size, dest);
+        dest[wide_size] = 0;
+        wide = dest;
+      }
+
       char *
-      String::transcode(const XMLCh *str)
+      String::allocateNarrow(std::size_t size) const
       {
-        if (str)
+        const std::size_t bytes = size + 1;
+        if (bytes <= inline_size - used)
           {
-            if (xercesc::XMLString::stringLen(str) == 0)
-              return xercesc::XMLString::replicate("");
+            char *dest = buffer + used;
+            used += bytes;
+            return dest;
+          }
 
-            try
+        narrow_heap.reset(new char[bytes]);
+        return narrow_heap.get();
+      }
+
+      XMLCh *
+      String::allocateWide(std::size_t size) const
+      {
+        const std::size_t bytes = (size + 1) * sizeof(XMLCh);
+        const std::size_t offset = (used + alignof(XMLCh) - 1) & ~(alignof(XMLCh) - 1);
+        if (offset <= inline_size && bytes <= inline_size - offset)
+          {
+            XMLCh *dest = reinterpret_cast<XMLCh *>(buffer + offset);
+            used = offset + bytes;
+            return dest;
+          }
+
+        wide_heap.reset(new XMLCh[size + 1]);
+        return wide_heap.get();
+      }
+
+      std::size_t
+      String::transcode(const XMLCh *src,
+                        std::size_t  size,
+                        char        *dest)
+      {
+        // Convert any leading ASCII with the vector kernel.
+        const std::size_t ascii = kernels().narrow(src, size, dest);
+        if (ascii == size)
+          return size;
+
+        std::size_t len = ascii;
+
+        for (std::size_t i = ascii; i < size; ++i)
+          {
+            uint32_t c = src[i];
+
+            if (c < 0x80)
               {
-                xercesc::TranscodeToStr tc(str, "UTF-8");
-                return reinterpret_cast<char *>(tc.adopt());
+                if (dest)
+                  dest[len] = static_cast<char>(c);
+                len += 1;
               }
-            catch (const xercesc::XMLException&)
+            else if (c < 0x800)
               {
-                throw std::runtime_error("XML UTF-16 to UTF-8 transcoding failure");
+                if (dest)
+                  {
+                    dest[len]   = static_cast<char>(0xC0 | (c >> 6));
+                    dest[len+1] = static_cast<char>(0x80 | (c & 0x3F));
+                  }
+                len += 2;
+              }
+            else if (c >= 0xD800 && c <= 0xDFFF)
+              {
+                // Surrogate pair.
+                if (c > 0xDBFF || i + 1 >= size)
+                  utf16_failure();
+                uint32_t low = src[i+1];
+                if (low < 0xDC00 || low > 0xDFFF)
+                  utf16_failure();
+                ++i;
+                c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                if (dest)
+                  {
+                    dest[len]   = static_cast<char>(0xF0 | (c >> 18));
+                    dest[len+1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+                    dest[len+2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    dest[len+3] = static_cast<char>(0x80 | (c & 0x3F));
+                  }
+                len += 4;
+              }
+            else
+              {
+                if (dest)
+                  {
+                    dest[len]   = static_cast<char>(0xE0 | (c >> 12));
+                    dest[len+1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    dest[len+2] = static_cast<char>(0x80 | (c & 0x3F));
+                  }
+                len += 3;
               }
           }
 
-      return 0;
-    }
+        return len;
+      }
 
-      XMLCh *
-      String::transcode(const char *str)
+      std::size_t
+      String::transcode(const char  *src,
+                        std::size_t  size,
+                        XMLCh       *dest)
+      {
+        // Convert any leading ASCII with the vector kernel.
+        const std::size_t ascii = kernels().widen(src, size, dest);
+        if (ascii == size)
+          return size;
+
+        const unsigned char *s = reinterpret_cast<const unsigned char *>(src);
+        std::size_t len = ascii;
+
+        for (std::size_t i = ascii; i < size;)
+          {
+            uint32_t c = s[i];
+
+            if (c < 0x80)
+              {
+                if (dest)
+                  dest[len] = static_cast<XMLCh>(c);
+                ++len;
+                ++i;
+                continue;
+              }
+
+            std::size_t trail;
+            uint32_t min;
+            if ((c & 0xE0) == 0xC0)
+              {
+                trail = 1;
+                min = 0x80;
+                c &= 0x1F;
+              }
+            else if ((c & 0xF0) == 0xE0)
+              {
+                trail = 2;
+                min = 0x800;
+                c &= 0x0F;
+              }
+            else if ((c & 0xF8) == 0xF0)
+              {
+                trail = 3;
+                min = 0x10000;
+                c &= 0x07;
+              }
+            else
+              utf8_failure();
+
+            if (size - i - 1 < trail)
+              utf8_failure();
+            for (std::size_t j = 1; j <= trail; ++j)
+              {
+                uint32_t b = s[i+j];
+                if ((b & 0xC0) != 0x80)
+                  utf8_failure();
+                c = (c << 6) | (b & 0x3F);
+              }
+            // Reject overlong forms, surrogates and values outside
+            // the Unicode range.
+            if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+              utf8_failure();
+            i += trail + 1;
+
+            if (c >= 0x10000)
+              {
+                if (dest)
+                  {
+                    c -= 0x10000;
+                    dest[len]   = static_cast<XMLCh>(0xD800 + (c >> 10));
+                    dest[len+1] = static_cast<XMLCh>(0xDC00 + (c & 0x3FF));
+                  }
+                len += 2;
+              }
+            else
+              {
+                if (dest)
+                  dest[len] = static_cast<XMLCh>(c);
+                ++len;
+              }
+          }
+
+        return len;
+      }
+
+      char *
+      String::transcode(const XMLCh *str)
       {
         if (str)
           {
-            if (strlen(str) == 0)
+            xercesc::MemoryManager *mm = xercesc::XMLPlatformUtils::fgMemoryManager;
+            const std::size_t size = xercesc::XMLString::stringLen(str);
+
+            // Assume the string is ASCII, so that the common case
+            // only requires a single pass.
+            char *dest = static_cast<char *>(mm->allocate(size + 1));
+            const std::size_t ascii = kernels().narrow(str, size, dest);
+            if (ascii != size)
               {
-                const XMLCh src[] = { 0x0 };
-                return xercesc::XMLString::replicate(src);
+                // Not ASCII; size and convert the remainder.
+                std::size_t len = ascii;
+                try
+                  {
+                    len += transcode(str + ascii, size - ascii, static_cast<char *>(0));
+                  }
+                catch (...)
+                  {
+                    mm->deallocate(dest);
+                    throw;
+                  }
+                char *full = static_cast<char *>(mm->allocate(len + 1));
+                std::memcpy(full, dest, ascii);
+                mm->deallocate(dest);
+                dest = full;
+                transcode(str + ascii, size - ascii, dest + ascii);
+                dest[len] = '\0';
               }
+            else
+              dest[size] = '\0';
+            return dest;
+          }
+
+        return 0;
+      }
+
+      XMLCh *
+      String::transcode(const char *str)
+      {
+        if (str)
+          {
+            xercesc::MemoryManager *mm = xercesc::XMLPlatformUtils::fgMemoryManager;
+            const std::size_t size = std::strlen(str);
 
+            // The UTF-16 form never has more code units than the
+            // UTF-8 form, so it may be converted in a single pass.
+            XMLCh *dest = static_cast<XMLCh *>(mm->allocate((size + 1) * sizeof(XMLCh)));
             try
               {
-                xercesc::TranscodeFromStr tc(reinterpret_cast<const XMLByte *>(str), std::strlen(str), "UTF-8");
-                return tc.adopt();
+                dest[transcode(str, size, dest)] = 0;
               }
-            catch (const xercesc::XMLException&)
+            catch (...)
               {
-                throw std::runtime_error("XML UTF-8 to UTF-16 transcoding failure");
+                mm->deallocate(dest);
+                throw;
               }
+            return dest;
           }
 
         return 0;
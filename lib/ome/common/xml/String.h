@@ -40,6 +40,9 @@
 #define OME_COMMON_XML_STRING_H
 
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <ostream>
 
@@ -63,9 +66,21 @@ namespace ome
        * directly construct instances of this class using the return
        * value.
        *
-       * This class does have an overhead of maintaining two copies of
-       * the string (char * and XMLCh *), as well as the cost of
-       * transcoding between the two forms upon construction.
+       * Only the form the String was constructed from is stored
+       * initially.  The other form is transcoded on first use, so a
+       * String which is only used as a std::string, or only as an
+       * XMLCh *, is never transcoded.  The input is validated upon
+       * construction, so transcoding errors are still reported by
+       * the constructor.  Both forms are stored in an inline buffer
+       * of inline_size bytes when they fit, so that short strings
+       * such as element and attribute names do not require any heap
+       * allocation.
+       *
+       * Since the second form is created on demand, a String must
+       * not be used concurrently from multiple threads, even if
+       * const, unless freeze() has been called first.  For constant
+       * element and attribute names shared between threads, use
+       * Name, which is always immutable.
        *
        * Assignment of std::string or XMLCh * is not supported.  This
        * class is only intended to transiently transcode between the two
@@ -74,65 +89,127 @@ namespace ome
       class String
       {
       public:
+        /// Size of the inline string buffer, in bytes.
+        static const std::size_t inline_size = 128;
+
         /**
          * Construct a String from an XMLCh * string.  The string
          * content will be copied; no ownership is taken of the original
-         * string.  The string will also be transcoded to a
-         * NUL-terminated char * string.
+         * string.  A null string is treated as an empty string.
          *
          * @param str an XMLCh *string.
+         * @throws std::runtime_error if the string is not valid UTF-16.
          */
         inline
         String(const XMLCh *str):
-          narrow(transcode(str)),
-          wide(xercesc::XMLString::replicate(str))
+          narrow(0),
+          narrow_size(0),
+          wide(0),
+          wide_size(0),
+          used(0),
+          narrow_heap(),
+          wide_heap()
         {
-          assert(this->wide != 0);
-          assert(this->narrow != 0);
+          assignWide(str, str ? xercesc::XMLString::stringLen(str) : 0);
         }
 
         /**
          * Construct a String from a NUL-terminated string.  The string
-         * content will be copied into a NUL-terminated char * string.
-         * The string will also be transcoded to an XMLCh * string.
+         * content will be copied; no ownership is taken of the original
+         * string.  A null string is treated as an empty string.
          *
-         * @param str a char * NUL-terminated string.
+         * @param str a char * NUL-terminated UTF-8 string.
+         * @throws std::runtime_error if the string is not valid UTF-8.
          */
         inline
         String(const char *str):
-          narrow(xercesc::XMLString::replicate(str)),
-          wide(transcode(str))
+          narrow(0),
+          narrow_size(0),
+          wide(0),
+          wide_size(0),
+          used(0),
+          narrow_heap(),
+          wide_heap()
         {
-          assert(this->narrow != 0);
-          assert(this->wide != 0);
+          assignNarrow(str, str ? std::strlen(str) : 0);
         }
 
         /**
          * Construct a String from a std::string.  The string content
-         * will be copied into a NUL-terminated char * string.  The
-         * string will also be transcoded to an XMLCh * string.
+         * will be copied.
          *
-         * @param str a std::string.
+         * @param str a UTF-8 std::string.
+         * @throws std::runtime_error if the string is not valid UTF-8.
          */
         inline
         String(std::string const& str):
-          narrow(xercesc::XMLString::replicate(str.c_str())),
-          wide(transcode(str.c_str()))
+          narrow(0),
+          narrow_size(0),
+          wide(0),
+          wide_size(0),
+          used(0),
+          narrow_heap(),
+          wide_heap()
         {
-          assert(this->narrow != 0);
-          assert(this->wide != 0);
+          assignNarrow(str.c_str(), str.size());
         }
 
         /**
-         * Destructor.  The allocated char * and XMLCh * strings will be freed.
+         * Copy constructor.  The forms present in the source String
+         * are copied.
+         *
+         * @param rhs the String to copy.
+         */
+        String(const String& rhs);
+
+        /**
+         * Move constructor.  Heap storage is transferred, and inline
+         * storage is copied; no allocation or transcoding is
+         * performed.
+         *
+         * @param rhs the String to move (left empty).
+         */
+        String(String&& rhs) noexcept;
+
+        /// Assignment operator (deleted).
+        String&
+        operator= (const String&) = delete;
+
+        /**
+         * Move assignment operator.  Heap storage is transferred, and
+         * inline storage is copied; no allocation or transcoding is
+         * performed.
+         *
+         * @param rhs the String to move (left empty).
+         * @returns the String.
+         */
+        String&
+        operator= (String&& rhs) noexcept;
+
+        /**
+         * Destructor.  Any allocated char * and XMLCh * strings will be
+         * freed.
          */
         inline
         ~String()
         {
-          if (narrow)
-            xercesc::XMLString::release(&narrow);
-          if (wide)
-            xercesc::XMLString::release(&wide);
+        }
+
+        /**
+         * Create both forms now.
+         *
+         * After this, the String is not modified by any const
+         * method, so it may be read concurrently from multiple
+         * threads.
+         */
+        inline
+        void
+        freeze() const
+        {
+          if (!narrow)
+            makeNarrow();
+          if (!wide)
+            makeWide();
         }
 
         /**
@@ -143,6 +220,8 @@ namespace ome
         inline
         operator const XMLCh *() const
         {
+          if (!wide)
+            makeWide();
           assert(this->wide != 0);
 
           return wide;
@@ -156,9 +235,7 @@ namespace ome
         inline
         operator ::std::string() const
         {
-          assert(this->narrow != 0);
-
-          return narrow;
+          return str();
         }
 
         /**
@@ -170,6 +247,25 @@ namespace ome
         ::std::string
         str() const
         {
+          if (!narrow)
+            makeNarrow();
+          assert(this->narrow != 0);
+
+          return ::std::string(narrow, narrow_size);
+        }
+
+        /**
+         * Get the String content as a NUL-terminated UTF-8 string.
+         *
+         * @returns a NUL-terminated char * string, valid for the
+         * lifetime of the String.
+         */
+        inline
+        const char *
+        c_str() const
+        {
+          if (!narrow)
+            makeNarrow();
           assert(this->narrow != 0);
 
           return narrow;
@@ -182,9 +278,9 @@ namespace ome
          * @returns @c true if equal, @c false otherwise.
          */
         bool
-        operator== (const char *rhs)
+        operator== (const char *rhs) const
         {
-          return this->narrow != 0 && strcmp(this->narrow, rhs) == 0;
+          return rhs != 0 && std::strcmp(c_str(), rhs) == 0;
         }
 
         /**
@@ -194,22 +290,32 @@ namespace ome
          * @returns @c true if equal, @c false otherwise.
          */
         bool
-        operator== (const std::string& rhs)
+        operator== (const std::string& rhs) const
         {
-          return this->narrow != 0 && strcmp(this->narrow, rhs.c_str()) == 0;
+          const char *lhs = c_str();
+          return narrow_size == rhs.size() &&
+            std::memcmp(lhs, rhs.data(), narrow_size) == 0;
         }
 
         /**
          * Compare a String for equality with a String.
          *
+         * The comparison uses the UTF-16 form if both Strings have
+         * it, to avoid transcoding.
+         *
          * @param rhs the string to compare.
          * @returns @c true if equal, @c false otherwise.
          */
         bool
-        operator== (const String& rhs)
+        operator== (const String& rhs) const
         {
-          return this->narrow != 0 && rhs.narrow != 0 &&
-            strcmp(this->narrow, rhs.narrow) == 0;
+          if (this->wide && rhs.wide)
+            return this->wide_size == rhs.wide_size &&
+              std::memcmp(this->wide, rhs.wide, wide_size * sizeof(XMLCh)) == 0;
+
+          const char *lhs = c_str();
+          return this->narrow_size == rhs.narrow_size &&
+            std::memcmp(lhs, rhs.c_str(), narrow_size) == 0;
         }
 
         /**
@@ -219,7 +325,7 @@ namespace ome
          * @returns @c true if not equal, @c false otherwise.
          */
         bool
-        operator!= (const char *rhs)
+        operator!= (const char *rhs) const
         {
           return !(*this == rhs);
         }
@@ -231,7 +337,7 @@ namespace ome
          * @returns @c true if not equal, @c false otherwise.
          */
         bool
-        operator!= (const std::string& rhs)
+        operator!= (const std::string& rhs) const
         {
           return !(*this == rhs);
         }
@@ -243,7 +349,7 @@ namespace ome
          * @returns @c true if not equal, @c false otherwise.
          */
         bool
-        operator!= (const String& rhs)
+        operator!= (const String& rhs) const
         {
           return !(*this == rhs);
         }
@@ -270,11 +376,119 @@ namespace ome
         XMLCh *
         transcode(const char *str);
 
+        /**
+         * Transcode UTF-16 string to UTF-8 string.
+         *
+         * If @c dest is null, the string is only validated, and the
+         * size of the UTF-8 string is computed.
+         *
+         * @param src the UTF-16 string.
+         * @param size the length of @c src (in code units).
+         * @param dest the destination buffer (may be null); must
+         * have space for the returned number of code units.  It will
+         * not be NUL-terminated.
+         * @returns the length of the UTF-8 string (in code units).
+         * @throws std::runtime_error if @c src is not valid UTF-16.
+         */
+        static
+        std::size_t
+        transcode(const XMLCh *src,
+                  std::size_t  size,
+                  char        *dest);
+
+        /**
+         * Transcode UTF-8 string to UTF-16 string.
+         *
+         * If @c dest is null, the string is only validated, and the
+         * size of the UTF-16 string is computed.
+         *
+         * @param src the UTF-8 string.
+         * @param size the length of @c src (in code units).
+         * @param dest the destination buffer (may be null); must
+         * have space for the returned number of code units.  It will
+         * not be NUL-terminated.
+         * @returns the length of the UTF-16 string (in code units).
+         * @throws std::runtime_error if @c src is not valid UTF-8.
+         */
+        static
+        std::size_t
+        transcode(const char  *src,
+                  std::size_t  size,
+                  XMLCh       *dest);
+
       private:
-        /// The char * string representation.
-        char *narrow;
-        /// The XMLCh * string representation.
-        XMLCh *wide;
+        /**
+         * Take the content of another String.
+         *
+         * @param rhs the String to move (left empty).
+         */
+        void
+        take(String& rhs) noexcept;
+
+        /**
+         * Set the UTF-8 form.
+         *
+         * @param str the UTF-8 string.
+         * @param size the length of @c str.
+         */
+        void
+        assignNarrow(const char  *str,
+                     std::size_t  size);
+
+        /**
+         * Set the UTF-16 form.
+         *
+         * @param str the UTF-16 string.
+         * @param size the length of @c str.
+         */
+        void
+        assignWide(const XMLCh *str,
+                   std::size_t  size);
+
+        /// Create the UTF-8 form from the UTF-16 form.
+        void
+        makeNarrow() const;
+
+        /// Create the UTF-16 form from the UTF-8 form.
+        void
+        makeWide() const;
+
+        /**
+         * Allocate storage for the UTF-8 form.
+         *
+         * @param size the string length, excluding the NUL
+         * terminator.
+         * @returns the storage (inline if possible).
+         */
+        char *
+        allocateNarrow(std::size_t size) const;
+
+        /**
+         * Allocate storage for the UTF-16 form.
+         *
+         * @param size the string length, excluding the NUL
+         * terminator.
+         * @returns the storage (inline if possible).
+         */
+        XMLCh *
+        allocateWide(std::size_t size) const;
+
+        /// The char * string representation (null if not yet created).
+        mutable const char *narrow;
+        /// The length of the char * string representation.
+        mutable std::size_t narrow_size;
+        /// The XMLCh * string representation (null if not yet created).
+        mutable const XMLCh *wide;
+        /// The length of the XMLCh * string representation.
+        mutable std::size_t wide_size;
+        /// Bytes of the inline buffer in use.
+        mutable std::size_t used;
+        /// Heap storage for long char * strings.
+        mutable std::unique_ptr<char[]> narrow_heap;
+        /// Heap storage for long XMLCh * strings.
+        mutable std::unique_ptr<XMLCh[]> wide_heap;
+        /// Inline storage for short strings.
+        alignas(XMLCh) mutable char buffer[inline_size];
       };
 
       /**
@@ -288,7 +502,7 @@ namespace ome
       operator<< (::std::ostream& os,
                   const String&   str)
       {
-        return os << static_cast<std::string>(str);
+        return os << str.c_str();
       }
 
     }
@@ -0,0 +1,311 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_STRINGVIEW_H
+#define OME_COMMON_XML_STRINGVIEW_H
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+
+#include <xercesc/util/XMLString.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+
+      /**
+       * Non-owning view of an XMLCh string.
+       *
+       * Unlike String, a StringView does not copy or transcode its
+       * content; it simply refers to a UTF-16 string owned by
+       * Xerces, such as an element name or attribute value passed to
+       * a SAX callback.  It is only valid for as long as the viewed
+       * string.  Comparison with UTF-8 C strings does not allocate
+       * when the C string is ASCII.  Use str() to obtain a copy of the
+       * content as a UTF-8 std::string.
+       */
+      class StringView
+      {
+      public:
+        /**
+         * Construct an empty StringView.
+         */
+        StringView():
+          ptr(0),
+          len(0)
+        {
+        }
+
+        /**
+         * Construct a StringView of a NUL-terminated XMLCh string.
+         *
+         * @param str the string to view (may be null).
+         */
+        StringView(const XMLCh *str):
+          ptr(str),
+          len(str ? xercesc::XMLString::stringLen(str) : 0)
+        {
+        }
+
+        /**
+         * Construct a StringView of an XMLCh string of known length.
+         *
+         * @param str the string to view.
+         * @param size the length of the string, in characters.
+         */
+        StringView(const XMLCh *str,
+                   std::size_t  size):
+          ptr(str),
+          len(size)
+        {
+        }
+
+        /**
+         * Get the viewed characters.
+         *
+         * @note The characters are not necessarily NUL-terminated.
+         *
+         * @returns the characters (may be null if empty).
+         */
+        const XMLCh *
+        data() const
+        {
+          return ptr;
+        }
+
+        /**
+         * Get the length of the view.
+         *
+         * @returns the length, in UTF-16 code units.
+         */
+        std::size_t
+        size() const
+        {
+          return len;
+        }
+
+        /**
+         * Check if the view is empty.
+         *
+         * @returns @c true if empty, @c false otherwise.
+         */
+        bool
+        empty() const
+        {
+          return len == 0;
+        }
+
+        /**
+         * Get a character.
+         *
+         * @param index the character index.
+         * @returns the character.
+         */
+        XMLCh
+        operator[] (std::size_t index) const
+        {
+          return ptr[index];
+        }
+
+        /**
+         * Get the content as a std::string.
+         *
+         * @returns a UTF-8 std::string containing a copy of the content.
+         * @throws std::runtime_error on transcoding failure.
+         */
+        std::string
+        str() const;
+
+        /**
+         * Compare a StringView for equality with a StringView.
+         *
+         * @param rhs the string to compare.
+         * @returns @c true if equal, @c false otherwise.
+         */
+        bool
+        operator== (const StringView& rhs) const
+        {
+          if (len != rhs.len)
+            return false;
+          for (std::size_t i = 0; i < len; ++i)
+            if (ptr[i] != rhs.ptr[i])
+              return false;
+          return true;
+        }
+
+        /**
+         * Compare a StringView for equality with a UTF-8 C string.
+         *
+         * @param rhs the string to compare.
+         * @returns @c true if equal, @c false otherwise.
+         */
+        bool
+        operator== (const char *rhs) const
+        {
+          const std::size_t rlen = std::strlen(rhs);
+          for (std::size_t i = 0; i < rlen; ++i)
+            {
+              const unsigned char c = static_cast<unsigned char>(rhs[i]);
+              if (c >= 0x80U) // Not ASCII; compare transcoded content.
+                return str() == rhs;
+              if (i >= len || ptr[i] != static_cast<XMLCh>(c))
+                return false;
+            }
+          return rlen == len;
+        }
+
+        /**
+         * Compare a StringView for equality with a UTF-8 std::string.
+         *
+         * @param rhs the string to compare.
+         * @returns @c true if equal, @c false otherwise.
+         */
+        bool
+        operator== (const std::string& rhs) const
+        {
+          return *this == rhs.c_str();
+        }
+
+        /**
+         * Compare a StringView for inequality with a StringView.
+         *
+         * @param rhs the string to compare.
+         * @returns @c true if not equal, @c false otherwise.
+         */
+        bool
+        operator!= (const StringView& rhs) const
+        {
+          return !(*this == rhs);
+        }
+
+        /**
+         * Compare a StringView for inequality with a UTF-8 C string.
+         *
+         * @param rhs the string to compare.
+         * @returns @c true if not equal, @c false otherwise.
+         */
+        bool
+        operator!= (const char *rhs) const
+        {
+          return !(*this == rhs);
+        }
+
+        /**
+         * Compare a StringView for inequality with a UTF-8 std::string.
+         *
+         * @param rhs the string to compare.
+         * @returns @c true if not equal, @c false otherwise.
+         */
+        bool
+        operator!= (const std::string& rhs) const
+        {
+          return !(*this == rhs);
+        }
+
+      private:
+        /// The viewed characters.
+        const XMLCh *ptr;
+        /// The number of viewed characters.
+        std::size_t len;
+      };
+
+      /**
+       * Output StringView to output stream.
+       *
+       * @param os the output stream.
+       * @param view the StringView to output.
+       * @returns the output stream.
+       */
+      inline ::std::ostream&
+      operator<< (::std::ostream&   os,
+                  const StringView& view)
+      {
+        return os << view.str();
+      }
+
+    }
+  }
+}
+
+namespace std
+{
+
+  /**
+   * Hash a StringView.
+   *
+   * This permits StringView to be used as a key in unordered
+   * containers; the hash is computed over the UTF-16 code units
+   * without transcoding (FNV-1a).
+   */
+  template<>
+  struct hash<ome::common::xml::StringView>
+  {
+    /**
+     * Compute the hash.
+     *
+     * @param view the StringView to hash.
+     * @returns the hash value.
+     */
+    std::size_t
+    operator() (const ome::common::xml::StringView& view) const
+    {
+      std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+      for (std::size_t i = 0; i < view.size(); ++i)
+        {
+          h ^= static_cast<std::size_t>(view[i]);
+          h *= static_cast<std::size_t>(1099511628211ULL);
+        }
+      return h;
+    }
+  };
+
+}
+
+#endif // OME_COMMON_XML_STRINGVIEW_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
@@ -45,6 +45,7 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <utility>
 
 namespace ome
 {
@@ -113,11 +114,55 @@ namespace ome
                  std::shared_ptr<base_element_type>())
           {}
 
+          /**
+           * Copy construct a Base.
+           *
+           * @param rhs the Base to copy.
+           */
+          Base(const Base& rhs) = default;
+
+          /**
+           * Move construct a Base.
+           *
+           * The wrapped value is transferred without changing its
+           * reference count; @c rhs is left null.
+           *
+           * @param rhs the Base to move.
+           */
+          Base(Base&& rhs) noexcept:
+            base(std::move(rhs.base))
+          {}
+
           /// Destructor.
           virtual
           ~Base()
           {}
 
+          /**
+           * Assign a Base.
+           *
+           * @param rhs the Base to assign.
+           * @returns the Base.
+           */
+          Base&
+          operator= (const Base& rhs) = default;
+
+          /**
+           * Move assign a Base.
+           *
+           * The wrapped value is transferred without changing its
+           * reference count; @c rhs is left null.
+           *
+           * @param rhs the Base to move.
+           * @returns the Base.
+           */
+          Base&
+          operator= (Base&& rhs) noexcept
+          {
+            base = std::move(rhs.base);
+            return *this;
+          }
+
           /**
            * Get wrapped base_element_type *.
            *
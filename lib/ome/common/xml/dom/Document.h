@@ -46,6 +46,7 @@
 #include <istream>
 #include <memory>
 #include <string>
+#include <utility>
 #include <ostream>
 
 #include <boost/filesystem/path.hpp>
@@ -59,6 +60,7 @@
 #include <ome/common/xml/dom/NodeList.h>
 #include <ome/common/xml/dom/Wrapper.h>
 #include <ome/common/xml/EntityResolver.h>
+#include <ome/common/xml/Name.h>
 #include <ome/common/xml/String.h>
 
 namespace ome
@@ -101,6 +103,16 @@ namespace ome
           {
           }
 
+          /**
+           * Move construct a Document.
+           *
+           * @param document the Document to move (left null).
+           */
+          Document (Document&& document) noexcept:
+            Wrapper<xercesc::DOMDocument, Node>(std::move(document))
+          {
+          }
+
           /**
            * Copy construct a Document.
            *
@@ -157,6 +169,19 @@ namespace ome
             return *this;
           }
 
+          /**
+           * Move assign a Document.
+           *
+           * @param wrapped the Document to move (left null).
+           * @returns the Document.
+           */
+          Document&
+          operator= (Document&& wrapped) noexcept
+          {
+            Wrapper<xercesc::DOMDocument, Node>::operator=(std::move(wrapped));
+            return *this;
+          }
+
           /**
            * Create Element with namespace.
            *
@@ -174,6 +199,20 @@ namespace ome
             return Element((*this)->createElementNS(xns, xname), false);
           }
 
+          /**
+           * Create Element with namespace.
+           *
+           * @param ns the namespace.
+           * @param name the element name.
+           * @returns the created Element.
+           */
+          Element
+          createElementNS(const Name& ns,
+                          const Name& name)
+          {
+            return Element((*this)->createElementNS(ns, name), false);
+          }
+
           /**
            * Create Comment.
            *
@@ -203,6 +242,18 @@ namespace ome
             return Element((*this)->createElement(xname), false);
           }
 
+          /**
+           * Create Element without namespace.
+           *
+           * @param name the element name.
+           * @returns the created Element.
+           */
+          Element
+          createElement(const Name& name)
+          {
+            return Element((*this)->createElement(name), false);
+          }
+
           /**
            * Get the root element of this document.
            *
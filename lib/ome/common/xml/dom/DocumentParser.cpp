@@ -0,0 +1,170 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#include <stdexcept>
+
+#include <ome/common/xml/InputSource.h>
+#include <ome/common/xml/String.h>
+#include <ome/common/xml/dom/DocumentParser.h>
+
+#include <xercesc/framework/MemBufInputSource.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace dom
+      {
+
+        DocumentParser::DocumentParser(EntityResolver&        resolver,
+                                       const ParseParameters& params):
+          xmlplat(),
+          resolver(resolver),
+          params(params),
+          reporter(),
+          parser(new xercesc::XercesDOMParser())
+        {
+          init();
+        }
+
+        DocumentParser::DocumentParser(EntityResolver&        resolver,
+                                       GrammarPool&           pool,
+                                       const ParseParameters& params):
+          xmlplat(),
+          resolver(resolver),
+          params(params),
+          reporter(),
+          parser(new xercesc::XercesDOMParser(0, xercesc::XMLPlatformUtils::fgMemoryManager, pool.get()))
+        {
+          parser->useCachedGrammarInParse(true);
+          // A locked pool is immutable.
+          parser->cacheGrammarFromParse(!pool.locked());
+          init();
+        }
+
+        DocumentParser::~DocumentParser()
+        {
+        }
+
+        void
+        DocumentParser::init()
+        {
+          parser->setErrorHandler(&reporter);
+          parser->setXMLEntityResolver(&resolver);
+          setParameters(params);
+        }
+
+        const ParseParameters&
+        DocumentParser::getParameters() const
+        {
+          return params;
+        }
+
+        void
+        DocumentParser::setParameters(const ParseParameters& params)
+        {
+          this->params = params;
+
+          parser->setValidationScheme(params.validationScheme);
+          parser->setDoNamespaces(params.doNamespaces);
+          parser->setDoSchema(params.doSchema);
+          parser->setHandleMultipleImports(params.handleMultipleImports);
+          parser->setValidationSchemaFullChecking(params.validationSchemaFullChecking);
+          parser->setCreateEntityReferenceNodes(params.createEntityReferenceNodes);
+        }
+
+        Document
+        DocumentParser::parse(const boost::filesystem::path& file)
+        {
+          MappedFileInputSource source(file);
+
+          return parse(source);
+        }
+
+        Document
+        DocumentParser::parse(const std::string& text,
+                              const std::string& id)
+        {
+          xercesc::MemBufInputSource source(reinterpret_cast<const XMLByte *>(text.c_str()),
+                                            static_cast<XMLSize_t>(text.size()),
+                                            String(id));
+
+          return parse(source);
+        }
+
+        Document
+        DocumentParser::parse(std::istream&      stream,
+                              const std::string& id)
+        {
+          StreamInputSource source(stream, id);
+
+          return parse(source);
+        }
+
+        Document
+        DocumentParser::parse(xercesc::InputSource& source)
+        {
+          reporter.resetErrors();
+
+          try
+            {
+              parser->parse(source);
+            }
+          catch (...)
+            {
+              parser->resetDocumentPool();
+              throw;
+            }
+
+          if (reporter || !parser->getDocument())
+            {
+              // Release the partial document rather than letting it
+              // accumulate in the parser's document pool.
+              parser->resetDocumentPool();
+              throw std::runtime_error("Parse error");
+            }
+
+          return Document(parser->adoptDocument(), true);
+        }
+
+      }
+    }
+  }
+}
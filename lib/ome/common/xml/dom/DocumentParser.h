@@ -0,0 +1,223 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_DOM_DOCUMENTPARSER_H
+#define OME_COMMON_XML_DOM_DOCUMENTPARSER_H
+
+#include <ome/common/config.h>
+
+#include <istream>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax/InputSource.hpp>
+
+#include <ome/common/xml/EntityResolver.h>
+#include <ome/common/xml/ErrorReporter.h>
+#include <ome/common/xml/GrammarPool.h>
+#include <ome/common/xml/Platform.h>
+#include <ome/common/xml/dom/Document.h>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace dom
+      {
+
+        /**
+         * Reusable DOM document parser.
+         *
+         * The createDocument() functions construct and configure a
+         * new xercesc::XercesDOMParser for every document, and
+         * initialize the Xerces platform each time.  This class holds
+         * a configured parser, error reporter and entity resolver for
+         * its lifetime, so that parsing many documents only incurs the
+         * cost of the parse itself.  The Xerces platform is kept
+         * initialized while the parser exists.
+         *
+         * Each parsed Document is adopted from the parser and is
+         * independent of it; it may outlive the DocumentParser.
+         *
+         * @note A DocumentParser is not thread-safe; use a separate
+         * instance in each thread.
+         */
+        class DocumentParser
+        {
+        public:
+          /**
+           * Construct a DocumentParser.
+           *
+           * @param resolver the EntityResolver to use; this must
+           * remain valid for the lifetime of the parser.
+           * @param params XML parser parameters.
+           */
+          DocumentParser(EntityResolver&        resolver,
+                         const ParseParameters& params = ParseParameters());
+
+          /**
+           * Construct a DocumentParser using cached grammars.
+           *
+           * Schema grammars will be obtained from the GrammarPool
+           * rather than being compiled for each parse.  If the pool is
+           * unlocked, grammars encountered while parsing will be
+           * added to the pool.
+           *
+           * @param resolver the EntityResolver to use; this must
+           * remain valid for the lifetime of the parser.
+           * @param pool the GrammarPool to use; this must remain valid
+           * for the lifetime of the parser.
+           * @param params XML parser parameters.
+           */
+          DocumentParser(EntityResolver&        resolver,
+                         GrammarPool&           pool,
+                         const ParseParameters& params = ParseParameters());
+
+          /// Destructor.
+          ~DocumentParser();
+
+          /// Copy constructor (deleted).
+          DocumentParser(const DocumentParser&) = delete;
+
+          /// Assignment operator (deleted).
+          DocumentParser&
+          operator= (const DocumentParser&) = delete;
+
+          /**
+           * Get the parser parameters.
+           *
+           * @returns the parser parameters.
+           */
+          const ParseParameters&
+          getParameters() const;
+
+          /**
+           * Set the parser parameters.
+           *
+           * The parameters will be used by all subsequent parses.
+           *
+           * @param params XML parser parameters.
+           */
+          void
+          setParameters(const ParseParameters& params);
+
+          /**
+           * Parse a Document from the content of a file.
+           *
+           * The file is memory-mapped and parsed in place.
+           *
+           * @param file the file to read.
+           * @returns the new Document.
+           * @throws std::runtime_error if parsing fails.
+           */
+          Document
+          parse(const boost::filesystem::path& file);
+
+          /**
+           * Parse a Document from the content of a string.
+           *
+           * @param text the string to use.
+           * @param id document filename (for error reporting only).
+           * @returns the new Document.
+           * @throws std::runtime_error if parsing fails.
+           */
+          Document
+          parse(const std::string& text,
+                const std::string& id = "membuf");
+
+          /**
+           * Parse a Document from the content of an input stream.
+           *
+           * The stream is read incrementally during parsing, and need
+           * not be seekable.
+           *
+           * @param stream the stream to read.
+           * @param id document filename (for error reporting only).
+           * @returns the new Document.
+           * @throws std::runtime_error if parsing fails.
+           */
+          Document
+          parse(std::istream&      stream,
+                const std::string& id = "streambuf");
+
+          /**
+           * Parse a Document from a Xerces input source.
+           *
+           * @param source the input source to read.
+           * @returns the new Document.
+           * @throws std::runtime_error if parsing fails.
+           */
+          Document
+          parse(xercesc::InputSource& source);
+
+        private:
+          /**
+           * Set up the parser error reporter, resolver and parameters.
+           */
+          void
+          init();
+
+          /// Xerces platform (declared first, so destroyed last).
+          Platform xmlplat;
+          /// Entity resolver.
+          EntityResolver& resolver;
+          /// Parser parameters.
+          ParseParameters params;
+          /// Error reporter.
+          ErrorReporter reporter;
+          /// The parser.
+          std::unique_ptr<xercesc::XercesDOMParser> parser;
+        };
+
+      }
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_DOM_DOCUMENTPARSER_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
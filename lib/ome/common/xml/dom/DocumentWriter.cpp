@@ -0,0 +1,252 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#include <stdexcept>
+
+#include <ome/common/xml/FormatTarget.h>
+#include <ome/common/xml/String.h>
+#include <ome/common/xml/dom/DocumentWriter.h>
+
+#include <xercesc/dom/DOMConfiguration.hpp>
+#include <xercesc/dom/DOMException.hpp>
+#include <xercesc/dom/DOMImplementation.hpp>
+#include <xercesc/dom/DOMImplementationRegistry.hpp>
+#include <xercesc/framework/LocalFileFormatTarget.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace dom
+      {
+
+        DocumentWriter::DocumentWriter(const WriteParameters& params):
+          xmlplat(),
+          params(params),
+          writer(),
+          output()
+        {
+          xercesc::DOMImplementation* impl = xercesc::DOMImplementationRegistry::getDOMImplementation(String("LS"));
+          xercesc::DOMImplementationLS *ls(dynamic_cast<xercesc::DOMImplementationLS *>(impl));
+          if (!ls)
+            throw std::runtime_error("Failed to create LS DOMImplementation");
+
+          writer.reset(ls->createLSSerializer());
+          output.reset(ls->createLSOutput());
+
+          setParameters(params);
+        }
+
+        DocumentWriter::~DocumentWriter()
+        {
+        }
+
+        const WriteParameters&
+        DocumentWriter::getParameters() const
+        {
+          return params;
+        }
+
+        void
+        DocumentWriter::setParameters(const WriteParameters& params)
+        {
+          this->params = params;
+
+          xercesc::DOMConfiguration *config(writer->getDomConfig());
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMCanonicalForm, params.canonicalForm))
+            config->setParameter(xercesc::XMLUni::fgDOMCanonicalForm, params.canonicalForm);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMCDATASections, params.CDATASections))
+            config->setParameter(xercesc::XMLUni::fgDOMCDATASections, params.CDATASections);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMComments, params.comments))
+            config->setParameter(xercesc::XMLUni::fgDOMComments, params.comments);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMDatatypeNormalization, params.datatypeNormalization))
+            config->setParameter(xercesc::XMLUni::fgDOMDatatypeNormalization, params.datatypeNormalization);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMWRTDiscardDefaultContent, params.discardDefaultContent))
+            config->setParameter(xercesc::XMLUni::fgDOMWRTDiscardDefaultContent, params.discardDefaultContent);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMEntities, params.entities))
+            config->setParameter(xercesc::XMLUni::fgDOMEntities, params.entities);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMNamespaces, params.namespaces))
+            config->setParameter(xercesc::XMLUni::fgDOMNamespaces, params.namespaces);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMNamespaceDeclarations, params.namespaceDeclarations))
+            config->setParameter(xercesc::XMLUni::fgDOMNamespaceDeclarations, params.namespaceDeclarations);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMNormalizeCharacters, params.normalizeCharacters))
+            config->setParameter(xercesc::XMLUni::fgDOMNormalizeCharacters, params.normalizeCharacters);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMWRTFormatPrettyPrint, params.prettyPrint))
+            config->setParameter(xercesc::XMLUni::fgDOMWRTFormatPrettyPrint, params.prettyPrint);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMSplitCDATASections, params.splitCDATASections))
+            config->setParameter(xercesc::XMLUni::fgDOMSplitCDATASections, params.splitCDATASections);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMValidateIfSchema, params.validate))
+            config->setParameter(xercesc::XMLUni::fgDOMValidateIfSchema, params.validate);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMWRTWhitespaceInElementContent, params.whitespace))
+            config->setParameter(xercesc::XMLUni::fgDOMWRTWhitespaceInElementContent, params.whitespace);
+          if (config->canSetParameter(xercesc::XMLUni::fgDOMXMLDeclaration, params.xmlDeclaration))
+            config->setParameter(xercesc::XMLUni::fgDOMXMLDeclaration, params.xmlDeclaration);
+        }
+
+        void
+        DocumentWriter::write(xercesc::DOMNode&         node,
+                              xercesc::XMLFormatTarget& target)
+        {
+          // To clean up properly due to the lack of Xerces
+          // exception-safety, track if we need to throw an exception
+          // after cleanup.
+          bool ok = false;
+          std::string fail_message("Failed to write DOM XML");
+
+          output->setByteStream(&target);
+
+          try
+            {
+              ok = writer->write(&node, output.get());
+            }
+          catch (const xercesc::XMLException& toCatch)
+            {
+              fail_message = "XMLException during DOM XML writing: ";
+              fail_message += String(toCatch.getMessage());
+            }
+          catch (const xercesc::DOMException& toCatch)
+            {
+              fail_message = "DOMException during DOM XML writing: ";
+              fail_message += String(toCatch.getMessage());
+            }
+          catch (const std::exception& toCatch)
+            {
+              fail_message = "Exception during DOM XML writing: ";
+              fail_message += toCatch.what();
+            }
+          catch (...)
+            {
+              fail_message = "Unexpected exception during DOM XML writing";
+            }
+
+          // Don't retain a reference to the target after returning.
+          output->setByteStream(0);
+
+          if (!ok)
+            throw std::runtime_error(fail_message);
+        }
+
+        void
+        DocumentWriter::write(xercesc::DOMNode&              node,
+                              const boost::filesystem::path& file)
+        {
+          xercesc::LocalFileFormatTarget target(String(file.generic_string()));
+
+          write(node, target);
+        }
+
+        void
+        DocumentWriter::write(xercesc::DOMNode& node,
+                              std::ostream&     stream)
+        {
+          StreamFormatTarget target(stream);
+
+          write(node, target);
+
+          target.flush();
+        }
+
+        void
+        DocumentWriter::write(xercesc::DOMNode& node,
+                              std::string&      text)
+        {
+          text.clear();
+
+          StringFormatTarget target(text);
+
+          try
+            {
+              write(node, target);
+            }
+          catch (...)
+            {
+              text.clear();
+              throw;
+            }
+        }
+
+        void
+        DocumentWriter::write(Node&                          node,
+                              const boost::filesystem::path& file)
+        {
+          write(*(node.get()), file);
+        }
+
+        void
+        DocumentWriter::write(Node&         node,
+                              std::ostream& stream)
+        {
+          write(*(node.get()), stream);
+        }
+
+        void
+        DocumentWriter::write(Node&        node,
+                              std::string& text)
+        {
+          write(*(node.get()), text);
+        }
+
+        void
+        DocumentWriter::write(Document&                      document,
+                              const boost::filesystem::path& file)
+        {
+          write(*(document.get()), file);
+        }
+
+        void
+        DocumentWriter::write(Document&     document,
+                              std::ostream& stream)
+        {
+          write(*(document.get()), stream);
+        }
+
+        void
+        DocumentWriter::write(Document&    document,
+                              std::string& text)
+        {
+          write(*(document.get()), text);
+        }
+
+      }
+    }
+  }
+}
@@ -0,0 +1,280 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_DOM_DOCUMENTWRITER_H
+#define OME_COMMON_XML_DOM_DOCUMENTWRITER_H
+
+#include <ome/common/config.h>
+
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include <xercesc/dom/DOMImplementationLS.hpp>
+#include <xercesc/dom/DOMLSOutput.hpp>
+#include <xercesc/dom/DOMLSSerializer.hpp>
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/framework/XMLFormatter.hpp>
+
+#include <ome/common/xml/Platform.h>
+#include <ome/common/xml/dom/Document.h>
+#include <ome/common/xml/dom/Node.h>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace dom
+      {
+
+        namespace detail
+        {
+
+          /**
+           * Deleter for Xerces objects freed with release().
+           */
+          template<typename T>
+          struct release_deleter
+          {
+            /**
+             * Release an object.
+             *
+             * @param object the object to release (may be null).
+             */
+            void
+            operator() (T *object) const
+            {
+              if (object)
+                object->release();
+            }
+          };
+
+        }
+
+        /**
+         * Reusable DOM document writer.
+         *
+         * The writeNode() and writeDocument() functions look up the
+         * DOM implementation, create and configure a new serializer
+         * and output for every write.  This class creates and
+         * configures them once, so that writing many documents only
+         * incurs the cost of the serialization itself.  The Xerces
+         * platform is kept initialized while the writer exists.
+         *
+         * @note A DocumentWriter is not thread-safe; use a separate
+         * instance in each thread.
+         */
+        class DocumentWriter
+        {
+        public:
+          /**
+           * Construct a DocumentWriter.
+           *
+           * @param params XML output parameters.
+           * @throws std::runtime_error if the serializer can not be
+           * created.
+           */
+          DocumentWriter(const WriteParameters& params = WriteParameters());
+
+          /// Destructor.
+          ~DocumentWriter();
+
+          /// Copy constructor (deleted).
+          DocumentWriter(const DocumentWriter&) = delete;
+
+          /// Assignment operator (deleted).
+          DocumentWriter&
+          operator= (const DocumentWriter&) = delete;
+
+          /**
+           * Get the output parameters.
+           *
+           * @returns the output parameters.
+           */
+          const WriteParameters&
+          getParameters() const;
+
+          /**
+           * Set the output parameters.
+           *
+           * The parameters will be used by all subsequent writes.
+           *
+           * @param params XML output parameters.
+           */
+          void
+          setParameters(const WriteParameters& params);
+
+          /**
+           * Write a Node to a Xerces format target.
+           *
+           * @param node the node to write.
+           * @param target the target to write to.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(xercesc::DOMNode&         node,
+                xercesc::XMLFormatTarget& target);
+
+          /**
+           * Write a Node to a file.
+           *
+           * @param node the node to write.
+           * @param file the file to write.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(xercesc::DOMNode&              node,
+                const boost::filesystem::path& file);
+
+          /**
+           * Write a Node to a stream.
+           *
+           * @param node the node to write.
+           * @param stream the stream to write to.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(xercesc::DOMNode& node,
+                std::ostream&     stream);
+
+          /**
+           * Write a Node to a string.
+           *
+           * @param node the node to write.
+           * @param text the string to store the text in.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(xercesc::DOMNode& node,
+                std::string&      text);
+
+          /**
+           * Write a Node to a file.
+           *
+           * @param node the node to write.
+           * @param file the file to write.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(Node&                          node,
+                const boost::filesystem::path& file);
+
+          /**
+           * Write a Node to a stream.
+           *
+           * @param node the node to write.
+           * @param stream the stream to write to.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(Node&         node,
+                std::ostream& stream);
+
+          /**
+           * Write a Node to a string.
+           *
+           * @param node the node to write.
+           * @param text the string to store the text in.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(Node&        node,
+                std::string& text);
+
+          /**
+           * Write a Document to a file.
+           *
+           * @param document the document to write.
+           * @param file the file to write.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(Document&                      document,
+                const boost::filesystem::path& file);
+
+          /**
+           * Write a Document to a stream.
+           *
+           * @param document the document to write.
+           * @param stream the stream to write to.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(Document&     document,
+                std::ostream& stream);
+
+          /**
+           * Write a Document to a string.
+           *
+           * @param document the document to write.
+           * @param text the string to store the text in.
+           * @throws std::runtime_error if writing fails.
+           */
+          void
+          write(Document&    document,
+                std::string& text);
+
+        private:
+          /// Xerces platform (declared first, so destroyed last).
+          Platform xmlplat;
+          /// Output parameters.
+          WriteParameters params;
+          /// The serializer.
+          std::unique_ptr<xercesc::DOMLSSerializer,
+                          detail::release_deleter<xercesc::DOMLSSerializer>> writer;
+          /// The serializer output.
+          std::unique_ptr<xercesc::DOMLSOutput,
+                          detail::release_deleter<xercesc::DOMLSOutput>> output;
+        };
+
+      }
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_DOM_DOCUMENTWRITER_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
@@ -41,11 +41,14 @@
 
 #include <functional>
 #include <string>
+#include <utility>
 
 #include <xercesc/dom/DOMElement.hpp>
 
+#include <ome/common/xml/Name.h>
 #include <ome/common/xml/String.h>
 #include <ome/common/xml/dom/Node.h>
+#include <ome/common/xml/dom/NodeRef.h>
 #include <ome/common/xml/dom/Wrapper.h>
 
 namespace ome
@@ -85,6 +88,16 @@ namespace ome
           {
           }
 
+          /**
+           * Move construct an Element.
+           *
+           * @param element the Element to move (left null).
+           */
+          Element (Element&& element) noexcept:
+            Wrapper<xercesc::DOMElement, Node>(std::move(element))
+          {
+          }
+
           /**
            * Copy construct an Element.
            *
@@ -123,11 +136,58 @@ namespace ome
           {
           }
 
+          /**
+           * Construct an Element from an ElementRef (unmanaged).
+           *
+           * @param element the element to wrap.
+           */
+          explicit
+          Element (ElementRef element):
+            Element(element.get(), false)
+          {
+          }
+
           /// Destructor.
           ~Element()
           {
           }
 
+          /**
+           * Assign an Element.
+           *
+           * @param wrapped the Element to assign.
+           * @returns the Element.
+           */
+          Element&
+          operator= (const Element& wrapped)
+          {
+            Wrapper<xercesc::DOMElement, Node>::operator=(wrapped);
+            return *this;
+          }
+
+          /**
+           * Move assign an Element.
+           *
+           * @param wrapped the Element to move (left null).
+           * @returns the Element.
+           */
+          Element&
+          operator= (Element&& wrapped) noexcept
+          {
+            Wrapper<xercesc::DOMElement, Node>::operator=(std::move(wrapped));
+            return *this;
+          }
+
+          /**
+           * Get a non-owning reference to the wrapped element.
+           *
+           * @returns the element reference.
+           */
+          operator ElementRef () const
+          {
+            return ElementRef(const_cast<xercesc::DOMElement *>(get()));
+          }
+
           /**
            * Get Element tag name.
            *
@@ -139,6 +199,103 @@ namespace ome
             return (*this)->getTagName();
           }
 
+          /**
+           * Get the first child element.
+           *
+           * @returns the first child element (null if none).
+           */
+          ElementRef
+          getFirstElementChild () const
+          {
+            return ElementRef(*this).getFirstElementChild();
+          }
+
+          /**
+           * Get the last child element.
+           *
+           * @returns the last child element (null if none).
+           */
+          ElementRef
+          getLastElementChild () const
+          {
+            return ElementRef(*this).getLastElementChild();
+          }
+
+          /**
+           * Get the previous sibling element.
+           *
+           * @returns the previous sibling element (null if none).
+           */
+          ElementRef
+          getPreviousElementSibling () const
+          {
+            return ElementRef(*this).getPreviousElementSibling();
+          }
+
+          /**
+           * Get the next sibling element.
+           *
+           * @returns the next sibling element (null if none).
+           */
+          ElementRef
+          getNextElementSibling () const
+          {
+            return ElementRef(*this).getNextElementSibling();
+          }
+
+          /**
+           * Get the number of child elements.
+           *
+           * @returns the number of child elements.
+           */
+          std::size_t
+          getChildElementCount () const
+          {
+            return ElementRef(*this).getChildElementCount();
+          }
+
+          /**
+           * Get the child elements.
+           *
+           * @returns a range of all child elements.
+           */
+          ElementRange
+          children () const
+          {
+            return ElementRef(*this).children();
+          }
+
+          /**
+           * Get the child elements with a given tag name.
+           *
+           * @param name the tag name to match; a Name lvalue must
+           * outlive the range, while a temporary is kept by the range.
+           * @returns a range of matching child elements.
+           */
+          ElementRange
+          childElements (detail::name_ref name) const
+          {
+            return ElementRef(*this).childElements(std::move(name));
+          }
+
+          /**
+           * Get the child elements with a given namespace and local
+           * name.
+           *
+           * @param ns the namespace URI to match.
+           * @param local the local name to match.
+           * @returns a range of matching child elements.
+           *
+           * As for childElements(), Name lvalues must outlive the
+           * range, while temporaries are kept by the range.
+           */
+          ElementRange
+          childElementsNS (detail::name_ref ns,
+                           detail::name_ref local) const
+          {
+            return ElementRef(*this).childElementsNS(std::move(ns), std::move(local));
+          }
+
           /**
            * Get child elements with a given tag name.
            *
@@ -151,6 +308,18 @@ namespace ome
             return (*this)->getElementsByTagName(String(name));
           }
 
+          /**
+           * Get child elements with a given tag name.
+           *
+           * @param name the element name to use.
+           * @returns the child nodes (if any).
+           */
+          NodeList
+          getElementsByTagName(const Name& name)
+          {
+            return (*this)->getElementsByTagName(name);
+          }
+
           /**
            * Check if the Element has the specified attribute.
            *
@@ -164,6 +333,19 @@ namespace ome
             return (*this)->hasAttribute(common::xml::String(attr));
           }
 
+          /**
+           * Check if the Element has the specified attribute.
+           *
+           * @param attr the attribute to check.
+           * @returns true if the Element has the attribute, otherwise
+           * false.
+           */
+          bool
+          hasAttribute (const Name& attr) const
+          {
+            return (*this)->hasAttribute(attr);
+          }
+
           /**
            * Get the specified attribute value.
            *
@@ -176,6 +358,18 @@ namespace ome
             return (*this)->getAttribute(common::xml::String(attr));
           }
 
+          /**
+           * Get the specified attribute value.
+           *
+           * @param attr the attribute to get.
+           * @returns the attribute value.
+           */
+          String
+          getAttribute (const Name& attr) const
+          {
+            return (*this)->getAttribute(attr);
+          }
+
           /**
            * Set the specified attribute value.
            *
@@ -190,6 +384,20 @@ namespace ome
                                          common::xml::String(val));
           }
 
+          /**
+           * Set the specified attribute value.
+           *
+           * @param attr the attribute to set.
+           * @param val the value to set.
+           */
+          void
+          setAttribute (const Name&        attr,
+                        const std::string& val)
+          {
+            return (*this)->setAttribute(attr,
+                                         common::xml::String(val));
+          }
+
           /**
            * Get Element text content.
            *
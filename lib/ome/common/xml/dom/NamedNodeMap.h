@@ -42,6 +42,7 @@
 #include <ome/common/config.h>
 
 #include <cassert>
+#include <utility>
 
 #include <ome/common/xml/dom/Base.h>
 #include <ome/common/xml/dom/Wrapper.h>
@@ -87,6 +88,16 @@ namespace ome
           {
           }
 
+          /**
+           * Move construct a NamedNodeMap.
+           *
+           * @param nodelist the NamedNodeMap to move (left null).
+           */
+          NamedNodeMap (NamedNodeMap&& nodelist) noexcept:
+            Wrapper<xercesc::DOMNamedNodeMap, Base<xercesc::DOMNamedNodeMap>>(std::move(nodelist))
+          {
+          }
+
           /**
            * Construct a NamedNodeMap from a xercesc::DOMNamedNodeMap * (unmanaged).
            *
@@ -102,6 +113,32 @@ namespace ome
           {
           }
 
+          /**
+           * Assign a NamedNodeMap.
+           *
+           * @param wrapped the NamedNodeMap to assign.
+           * @returns the NamedNodeMap.
+           */
+          NamedNodeMap&
+          operator= (const NamedNodeMap& wrapped)
+          {
+            Wrapper<xercesc::DOMNamedNodeMap, Base<xercesc::DOMNamedNodeMap>>::operator=(wrapped);
+            return *this;
+          }
+
+          /**
+           * Move assign a NamedNodeMap.
+           *
+           * @param wrapped the NamedNodeMap to move (left null).
+           * @returns the NamedNodeMap.
+           */
+          NamedNodeMap&
+          operator= (NamedNodeMap&& wrapped) noexcept
+          {
+            Wrapper<xercesc::DOMNamedNodeMap, Base<xercesc::DOMNamedNodeMap>>::operator=(std::move(wrapped));
+            return *this;
+          }
+
           /**
            * Get an item by name.
            *
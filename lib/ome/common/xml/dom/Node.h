@@ -40,6 +40,7 @@
 #define OME_COMMON_XML_DOM_NODE_H
 
 #include <functional>
+#include <utility>
 
 #include <ome/common/config.h>
 
@@ -47,6 +48,7 @@
 #include <ome/common/xml/dom/Base.h>
 #include <ome/common/xml/dom/NodeList.h>
 #include <ome/common/xml/dom/NamedNodeMap.h>
+#include <ome/common/xml/dom/NodeRef.h>
 #include <ome/common/xml/dom/Wrapper.h>
 
 #include <xercesc/dom/DOMNode.hpp>
@@ -91,6 +93,16 @@ namespace ome
           {
           }
 
+          /**
+           * Move construct a Node.
+           *
+           * @param node the Node to move (left null).
+           */
+          Node (Node&& node) noexcept:
+            Wrapper<xercesc::DOMNode, Base<xercesc::DOMNode>>(std::move(node))
+          {
+          }
+
           /**
            * Construct a Node from a xercesc::DOMNode *.
            *
@@ -105,11 +117,58 @@ namespace ome
           {
           }
 
+          /**
+           * Construct a Node from a NodeRef (unmanaged).
+           *
+           * @param node the node to wrap.
+           */
+          explicit
+          Node (NodeRef node):
+            Node(node.get(), false)
+          {
+          }
+
           /// Destructor.
           ~Node ()
           {
           }
 
+          /**
+           * Assign a Node.
+           *
+           * @param wrapped the Node to assign.
+           * @returns the Node.
+           */
+          Node&
+          operator= (const Node& wrapped)
+          {
+            Wrapper<xercesc::DOMNode, Base<xercesc::DOMNode>>::operator=(wrapped);
+            return *this;
+          }
+
+          /**
+           * Move assign a Node.
+           *
+           * @param wrapped the Node to move (left null).
+           * @returns the Node.
+           */
+          Node&
+          operator= (Node&& wrapped) noexcept
+          {
+            Wrapper<xercesc::DOMNode, Base<xercesc::DOMNode>>::operator=(std::move(wrapped));
+            return *this;
+          }
+
+          /**
+           * Get a non-owning reference to the wrapped node.
+           *
+           * @returns the node reference.
+           */
+          operator NodeRef () const
+          {
+            return NodeRef(const_cast<xercesc::DOMNode *>(get()));
+          }
+
           /**
            * Append a child Node.
            *
@@ -136,6 +195,63 @@ namespace ome
             return (*this)->getNodeType();
           }
 
+          /**
+           * Get the parent node.
+           *
+           * @returns the parent node (null if none).
+           */
+          NodeRef
+          getParentNode () const
+          {
+            return NodeRef(*this).getParentNode();
+          }
+
+          /**
+           * Get the first child node.
+           *
+           * Unlike getChildNodes(), this does not allocate.
+           *
+           * @returns the first child node (null if none).
+           */
+          NodeRef
+          getFirstChild () const
+          {
+            return NodeRef(*this).getFirstChild();
+          }
+
+          /**
+           * Get the last child node.
+           *
+           * @returns the last child node (null if none).
+           */
+          NodeRef
+          getLastChild () const
+          {
+            return NodeRef(*this).getLastChild();
+          }
+
+          /**
+           * Get the previous sibling node.
+           *
+           * @returns the previous sibling node (null if none).
+           */
+          NodeRef
+          getPreviousSibling () const
+          {
+            return NodeRef(*this).getPreviousSibling();
+          }
+
+          /**
+           * Get the next sibling node.
+           *
+           * @returns the next sibling node (null if none).
+           */
+          NodeRef
+          getNextSibling () const
+          {
+            return NodeRef(*this).getNextSibling();
+          }
+
           /**
            * Get child nodes.
            *
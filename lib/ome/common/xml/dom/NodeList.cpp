@@ -48,81 +48,6 @@ namespace ome
       namespace dom
       {
 
-        NodeList::iterator::iterator ():
-          index(0),
-          xmlnodelist(0),
-          xmlnode()
-        {}
-
-        NodeList::iterator::iterator (xercesc::DOMNodeList *xmlnodelist,
-                                      size_type             index):
-          index(index),
-          xmlnodelist(xmlnodelist),
-          xmlnode(std::shared_ptr<Node>(new Node(xmlnodelist->item(index), false)))
-        {}
-
-        NodeList::iterator::iterator (const iterator& rhs):
-          index(rhs.index),
-          xmlnodelist(rhs.xmlnodelist),
-          xmlnode(rhs.xmlnode)
-        {}
-
-        NodeList::iterator::~iterator ()
-        {}
-
-        Node&
-        NodeList::iterator::operator* ()
-        {
-          assert(xmlnode && *xmlnode);
-          return *xmlnode;
-        }
-
-        Node *
-        NodeList::iterator::operator-> ()
-        {
-          assert(xmlnode && *xmlnode);
-          return &*xmlnode;
-        }
-
-        NodeList::iterator&
-        NodeList::iterator::operator-- ()
-        {
-          if (xmlnode && *xmlnode)
-            {
-              if (index != 0)
-                {
-                  --index;
-                  *xmlnode = Node(xmlnodelist->item(index), false);
-                }
-              else
-                *xmlnode = Node(static_cast<xercesc::DOMNode *>(0), false);
-            }
-          return *this;
-        }
-
-        NodeList::iterator&
-        NodeList::iterator::operator++ ()
-        {
-          if (xmlnode && *xmlnode)
-            {
-              ++index;
-              *xmlnode = Node(xmlnodelist->item(index), false);
-            }
-          return *this;
-        }
-
-        bool
-        NodeList::iterator::operator == (const iterator& rhs) const
-        {
-          // both null
-          if ((!xmlnode || !(*xmlnode)) && ((!rhs.xmlnode) || !(*rhs.xmlnode)))
-            return true;
-          // one null
-          else if ((xmlnode && *xmlnode) || (rhs.xmlnode && *rhs.xmlnode))
-            return false;
-          else return index == rhs.index;
-        }
-
         Node
         NodeList::at(size_type index)
         {
@@ -42,8 +42,13 @@
 #include <ome/common/config.h>
 
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 #include <ome/common/xml/dom/Base.h>
+#include <ome/common/xml/dom/NodeRef.h>
 #include <ome/common/xml/dom/Wrapper.h>
 
 #include <xercesc/dom/DOMNodeList.hpp>
@@ -73,16 +78,40 @@ namespace ome
           typedef XMLSize_t size_type;
 
           /**
-           * Iterator for a NodeList.
+           * Random access iterator for a NodeList.
+           *
+           * The iterator holds only the list and an index; the node at
+           * the current position is obtained from the list when
+           * dereferenced, and is returned as a non-owning NodeRef, so
+           * iteration does not allocate.  The past-the-end iterator
+           * has an index equal to the list size.
+           *
+           * @tparam List the DOMNodeList type (const for
+           * const_iterator).
            */
-          class iterator
+          template<typename List>
+          class basic_iterator
           {
-          private:
+          public:
+            /// Iterator category.
+            typedef std::random_access_iterator_tag iterator_category;
+            /// Value type.
+            typedef NodeRef value_type;
+            /// Difference type.
+            typedef std::ptrdiff_t difference_type;
+            /// Pointer type (NodeRef dereferences to the DOMNode).
+            typedef NodeRef pointer;
+            /// Reference type (NodeRef is returned by value).
+            typedef NodeRef reference;
+
             /**
-             * Construct a null iterator.  This is used to refer to
-             * invalid positions such as past-the-end.
+             * Construct a null iterator.
              */
-            iterator();
+            basic_iterator ():
+              xmlnodelist(nullptr),
+              index(0)
+            {
+            }
 
             /**
              * Construct an iterator at the specified position for the
@@ -91,51 +120,188 @@ namespace ome
              * @param xmlnodelist the NodeList to iterate over.
              * @param index the index into the NodeList.
              */
-            iterator(xercesc::DOMNodeList *xmlnodelist,
-                     size_type             index);
+            basic_iterator (List      *xmlnodelist,
+                            size_type  index):
+              xmlnodelist(xmlnodelist),
+              index(index)
+            {
+            }
 
-          public:
             /**
-             * Copy construct an iterator.
+             * Convert from an iterator to a const_iterator.
              *
-             * @param rhs the iterator to copy.
+             * @param rhs the iterator to convert.
              */
-            iterator(const iterator& rhs);
-
-            /// Destructor.
-            ~iterator();
+            template<typename OtherList,
+                     typename = typename std::enable_if<std::is_convertible<OtherList *, List *>::value>::type>
+            basic_iterator (const basic_iterator<OtherList>& rhs):
+              xmlnodelist(rhs.xmlnodelist),
+              index(rhs.index)
+            {
+            }
 
             /**
              * Dereference the iterator.
              *
-             * @return a reference to the Node at this position.
+             * @returns the Node at this position.
              */
-            Node&
-            operator* ();
+            reference
+            operator* () const
+            {
+              assert(xmlnodelist && index < xmlnodelist->getLength());
+              return NodeRef(xmlnodelist->item(index));
+            }
 
             /**
              * Dereference the iterator.
              *
-             * @return a pointer to the Node at this position.
+             * @returns the Node at this position.
              */
-            Node *
-            operator-> ();
+            pointer
+            operator-> () const
+            {
+              return **this;
+            }
 
             /**
-             * Move the iterator backward one element.
+             * Dereference the iterator at an offset.
+             *
+             * @param offset the offset from the current position.
+             * @returns the Node at the offset position.
+             */
+            reference
+            operator[] (difference_type offset) const
+            {
+              return *(*this + offset);
+            }
+
+            /**
+             * Move the iterator forward one element.
              *
              * @returns the iterator at the new position.
              */
-            iterator&
-            operator-- ();
+            basic_iterator&
+            operator++ ()
+            {
+              ++index;
+              return *this;
+            }
 
             /**
              * Move the iterator forward one element.
              *
+             * @returns the iterator at the old position.
+             */
+            basic_iterator
+            operator++ (int)
+            {
+              basic_iterator ret(*this);
+              ++index;
+              return ret;
+            }
+
+            /**
+             * Move the iterator backward one element.
+             *
+             * @returns the iterator at the new position.
+             */
+            basic_iterator&
+            operator-- ()
+            {
+              --index;
+              return *this;
+            }
+
+            /**
+             * Move the iterator backward one element.
+             *
+             * @returns the iterator at the old position.
+             */
+            basic_iterator
+            operator-- (int)
+            {
+              basic_iterator ret(*this);
+              --index;
+              return ret;
+            }
+
+            /**
+             * Move the iterator forward.
+             *
+             * @param offset the number of elements to move.
+             * @returns the iterator at the new position.
+             */
+            basic_iterator&
+            operator+= (difference_type offset)
+            {
+              index = static_cast<size_type>(static_cast<difference_type>(index) + offset);
+              return *this;
+            }
+
+            /**
+             * Move the iterator backward.
+             *
+             * @param offset the number of elements to move.
+             * @returns the iterator at the new position.
+             */
+            basic_iterator&
+            operator-= (difference_type offset)
+            {
+              return *this += -offset;
+            }
+
+            /**
+             * Get an iterator moved forward.
+             *
+             * @param offset the number of elements to move.
+             * @returns the iterator at the new position.
+             */
+            basic_iterator
+            operator+ (difference_type offset) const
+            {
+              basic_iterator ret(*this);
+              return ret += offset;
+            }
+
+            /**
+             * Get an iterator moved forward.
+             *
+             * @param offset the number of elements to move.
+             * @param it the iterator to move.
              * @returns the iterator at the new position.
              */
-            iterator&
-            operator++ ();
+            friend basic_iterator
+            operator+ (difference_type       offset,
+                       const basic_iterator& it)
+            {
+              return it + offset;
+            }
+
+            /**
+             * Get an iterator moved backward.
+             *
+             * @param offset the number of elements to move.
+             * @returns the iterator at the new position.
+             */
+            basic_iterator
+            operator- (difference_type offset) const
+            {
+              basic_iterator ret(*this);
+              return ret -= offset;
+            }
+
+            /**
+             * Get the distance between two iterators.
+             *
+             * @param rhs the iterator to subtract.
+             * @returns the number of elements between the iterators.
+             */
+            difference_type
+            operator- (const basic_iterator& rhs) const
+            {
+              assert(xmlnodelist == rhs.xmlnodelist);
+              return static_cast<difference_type>(index) - static_cast<difference_type>(rhs.index);
+            }
 
             /**
              * Check the equality of two iterators.
@@ -144,7 +310,10 @@ namespace ome
              * @returns true if equal, otherwise false.
              */
             bool
-            operator == (const iterator& rhs) const;
+            operator == (const basic_iterator& rhs) const
+            {
+              return index == rhs.index && xmlnodelist == rhs.xmlnodelist;
+            }
 
             /**
              * Check the non-equality of two iterators.
@@ -153,23 +322,80 @@ namespace ome
              * @returns true if not equal, otherwise false.
              */
             bool
-            operator != (const iterator& rhs) const
+            operator != (const basic_iterator& rhs) const
             {
               return !(*this == rhs);
             }
 
+            /**
+             * Check if this iterator precedes another.
+             *
+             * @param rhs the iterator to compare with.
+             * @returns true if less, otherwise false.
+             */
+            bool
+            operator < (const basic_iterator& rhs) const
+            {
+              assert(xmlnodelist == rhs.xmlnodelist);
+              return index < rhs.index;
+            }
+
+            /**
+             * Check if this iterator follows another.
+             *
+             * @param rhs the iterator to compare with.
+             * @returns true if greater, otherwise false.
+             */
+            bool
+            operator > (const basic_iterator& rhs) const
+            {
+              return rhs < *this;
+            }
+
+            /**
+             * Check if this iterator precedes or equals another.
+             *
+             * @param rhs the iterator to compare with.
+             * @returns true if less or equal, otherwise false.
+             */
+            bool
+            operator <= (const basic_iterator& rhs) const
+            {
+              return !(rhs < *this);
+            }
+
+            /**
+             * Check if this iterator follows or equals another.
+             *
+             * @param rhs the iterator to compare with.
+             * @returns true if greater or equal, otherwise false.
+             */
+            bool
+            operator >= (const basic_iterator& rhs) const
+            {
+              return !(*this < rhs);
+            }
+
             /// Other specializations of this template are friends.
-            friend class NodeList;
+            template<typename OtherList>
+            friend class basic_iterator;
 
           private:
+            /// List being iterated over.
+            List *xmlnodelist;
             /// Index into the list.
             size_type index;
-            /// List being iterated over.
-            xercesc::DOMNodeList *xmlnodelist;
-            /// Node at current position.
-            std::shared_ptr<Node> xmlnode;
           };
 
+          /// Iterator.
+          typedef basic_iterator<xercesc::DOMNodeList> iterator;
+          /// Constant iterator.
+          typedef basic_iterator<const xercesc::DOMNodeList> const_iterator;
+          /// Reverse iterator.
+          typedef std::reverse_iterator<iterator> reverse_iterator;
+          /// Constant reverse iterator.
+          typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
           /**
            * Construct a NULL NodeList.
            */
@@ -188,6 +414,16 @@ namespace ome
           {
           }
 
+          /**
+           * Move construct a NodeList.
+           *
+           * @param nodelist the NodeList to move (left null).
+           */
+          NodeList (NodeList&& nodelist) noexcept:
+            Wrapper<xercesc::DOMNodeList, Base<xercesc::DOMNodeList>>(std::move(nodelist))
+          {
+          }
+
           /**
            * Construct a NodeList from a xercesc::DOMNodeList * (unmanaged).
            *
@@ -203,6 +439,32 @@ namespace ome
           {
           }
 
+          /**
+           * Assign a NodeList.
+           *
+           * @param wrapped the NodeList to assign.
+           * @returns the NodeList.
+           */
+          NodeList&
+          operator= (const NodeList& wrapped)
+          {
+            Wrapper<xercesc::DOMNodeList, Base<xercesc::DOMNodeList>>::operator=(wrapped);
+            return *this;
+          }
+
+          /**
+           * Move assign a NodeList.
+           *
+           * @param wrapped the NodeList to move (left null).
+           * @returns the NodeList.
+           */
+          NodeList&
+          operator= (NodeList&& wrapped) noexcept
+          {
+            Wrapper<xercesc::DOMNodeList, Base<xercesc::DOMNodeList>>::operator=(std::move(wrapped));
+            return *this;
+          }
+
           /**
            * Get the size (length) of the NodeList.
            *
@@ -241,6 +503,28 @@ namespace ome
             return iterator(this->get(), 0);
           }
 
+          /**
+           * Get an iterator pointing to the first element in the NodeList.
+           *
+           * @returns an iterator pointing to the first element in the NodeList.
+           */
+          const_iterator
+          begin() const
+          {
+            return const_iterator(this->get(), 0);
+          }
+
+          /**
+           * Get an iterator pointing to the first element in the NodeList.
+           *
+           * @returns an iterator pointing to the first element in the NodeList.
+           */
+          const_iterator
+          cbegin() const
+          {
+            return begin();
+          }
+
           /**
            * Get an iterator pointing to the past-the-end element in the NodeList.
            *
@@ -249,7 +533,101 @@ namespace ome
           iterator
           end()
           {
-            return iterator();
+            return iterator(this->get(), size());
+          }
+
+          /**
+           * Get an iterator pointing to the past-the-end element in the NodeList.
+           *
+           * @returns an iterator pointing to the past-the-end element in the NodeList.
+           */
+          const_iterator
+          end() const
+          {
+            return const_iterator(this->get(), size());
+          }
+
+          /**
+           * Get an iterator pointing to the past-the-end element in the NodeList.
+           *
+           * @returns an iterator pointing to the past-the-end element in the NodeList.
+           */
+          const_iterator
+          cend() const
+          {
+            return end();
+          }
+
+          /**
+           * Get a reverse iterator pointing to the last element in the NodeList.
+           *
+           * @returns a reverse iterator pointing to the last element in the NodeList.
+           */
+          reverse_iterator
+          rbegin()
+          {
+            return reverse_iterator(end());
+          }
+
+          /**
+           * Get a reverse iterator pointing to the last element in the NodeList.
+           *
+           * @returns a reverse iterator pointing to the last element in the NodeList.
+           */
+          const_reverse_iterator
+          rbegin() const
+          {
+            return const_reverse_iterator(end());
+          }
+
+          /**
+           * Get a reverse iterator pointing to the before-the-start
+           * element in the NodeList.
+           *
+           * @returns a reverse iterator pointing to the before-the-start
+           * element in the NodeList.
+           */
+          reverse_iterator
+          rend()
+          {
+            return reverse_iterator(begin());
+          }
+
+          /**
+           * Get a reverse iterator pointing to the before-the-start
+           * element in the NodeList.
+           *
+           * @returns a reverse iterator pointing to the before-the-start
+           * element in the NodeList.
+           */
+          const_reverse_iterator
+          rend() const
+          {
+            return const_reverse_iterator(begin());
+          }
+
+          /**
+           * Get a reverse iterator pointing to the last element in the NodeList.
+           *
+           * @returns a reverse iterator pointing to the last element in the NodeList.
+           */
+          const_reverse_iterator
+          crbegin() const
+          {
+            return rbegin();
+          }
+
+          /**
+           * Get a reverse iterator pointing to the before-the-start
+           * element in the NodeList.
+           *
+           * @returns a reverse iterator pointing to the before-the-start
+           * element in the NodeList.
+           */
+          const_reverse_iterator
+          crend() const
+          {
+            return rend();
           }
 
           /**
@@ -0,0 +1,1020 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_DOM_NODEREF_H
+#define OME_COMMON_XML_DOM_NODEREF_H
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <ome/common/config.h>
+
+#include <ome/common/xml/Name.h>
+#include <ome/common/xml/String.h>
+
+#include <xercesc/dom/DOMElement.hpp>
+#include <xercesc/dom/DOMNode.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace dom
+      {
+
+        namespace detail
+        {
+
+          /**
+           * Cast a DOMNode to a DOMElement.
+           *
+           * The node type is only checked in debug builds.
+           *
+           * @param node the node to cast (may be null).
+           * @returns the node as an element.
+           */
+          inline
+          xercesc::DOMElement *
+          element_cast(xercesc::DOMNode *node)
+          {
+            assert(!node || node->getNodeType() == xercesc::DOMNode::ELEMENT_NODE);
+            assert(!node || dynamic_cast<xercesc::DOMElement *>(node) != nullptr);
+            return static_cast<xercesc::DOMElement *>(node);
+          }
+
+          /**
+           * Reference to a Name used as a filter.
+           *
+           * A Name lvalue is referred to by pointer, without copying;
+           * it must outlive the referencing object.  A temporary Name
+           * is moved into shared storage, so that it lives as long as
+           * the referencing object and any copies of it.  This permits
+           * both static Names and temporaries to be passed safely.
+           */
+          class name_ref
+          {
+          public:
+            /**
+             * Refer to no Name.
+             */
+            name_ref ():
+              owned(),
+              name(nullptr)
+            {
+            }
+
+            /**
+             * Refer to a Name.
+             *
+             * @param name the name; must outlive this object.
+             */
+            name_ref (const Name& name):
+              owned(),
+              name(&name)
+            {
+            }
+
+            /**
+             * Take ownership of a temporary Name.
+             *
+             * @param name the name.
+             */
+            name_ref (Name&& name):
+              owned(std::make_shared<const Name>(std::move(name))),
+              name(owned.get())
+            {
+            }
+
+            /**
+             * Get the Name.
+             *
+             * @returns the Name (null if none); valid for the
+             * lifetime of this object and its copies.
+             */
+            const Name *
+            get() const
+            {
+              return name;
+            }
+
+          private:
+            /// Storage for a temporary Name.
+            std::shared_ptr<const Name> owned;
+            /// The Name.
+            const Name *name;
+          };
+
+        }
+
+        /**
+         * Non-owning DOM Node reference.
+         *
+         * Unlike Node, a NodeRef does not manage the lifetime of the
+         * node or keep any reference count; it is simply a pointer to
+         * a node owned by a document, and is only valid for as long as
+         * the document and node exist.  It is trivially copyable and
+         * its construction and navigation never allocate, so it is
+         * suitable for traversing large documents.
+         *
+         * A NodeRef may be converted to a Node with the Node(NodeRef)
+         * constructor if a wrapper is required.
+         */
+        class NodeRef
+        {
+        public:
+          /// The derived object type of a node.
+          typedef xercesc::DOMNode::NodeType node_type;
+
+          /**
+           * Construct a null NodeRef.
+           */
+          NodeRef ():
+            node(nullptr)
+          {
+          }
+
+          /**
+           * Construct a NodeRef from a xercesc::DOMNode *.
+           *
+           * @param node the node to refer to (may be null).
+           */
+          explicit
+          NodeRef (xercesc::DOMNode *node):
+            node(node)
+          {
+          }
+
+          /**
+           * Get referenced xercesc::DOMNode *.
+           *
+           * @note May be null.
+           *
+           * @returns the referenced node.
+           */
+          xercesc::DOMNode *
+          get() const
+          {
+            return node;
+          }
+
+          /**
+           * Dereference to xercesc::DOMNode.
+           *
+           * @returns the referenced node.
+           * @throws std::logic_error if null.
+           */
+          xercesc::DOMNode&
+          operator* () const
+          {
+            null_check();
+            return *node;
+          }
+
+          /**
+           * Dereference to xercesc::DOMNode.
+           *
+           * @returns the referenced node.
+           * @throws std::logic_error if null.
+           */
+          xercesc::DOMNode *
+          operator-> () const
+          {
+            null_check();
+            return node;
+          }
+
+          /**
+           * Check if the referenced node is not null.
+           *
+           * @returns true if not null, false if null.
+           */
+          operator bool () const
+          {
+            return node != nullptr;
+          }
+
+          /**
+           * Compare with another NodeRef.
+           *
+           * @param rhs the NodeRef to compare with.
+           * @returns true if both refer to the same node, otherwise
+           * false.
+           */
+          bool
+          operator == (const NodeRef& rhs) const
+          {
+            return node == rhs.node;
+          }
+
+          /**
+           * Compare with another NodeRef.
+           *
+           * @param rhs the NodeRef to compare with.
+           * @returns true if the nodes differ, otherwise false.
+           */
+          bool
+          operator != (const NodeRef& rhs) const
+          {
+            return node != rhs.node;
+          }
+
+          /**
+           * Get the object type of this node.
+           *
+           * @return the object type.
+           */
+          node_type
+          getNodeType() const
+          {
+            return (*this)->getNodeType();
+          }
+
+          /**
+           * Get the parent node.
+           *
+           * @returns the parent node (null if none).
+           */
+          NodeRef
+          getParentNode() const
+          {
+            return NodeRef((*this)->getParentNode());
+          }
+
+          /**
+           * Get the first child node.
+           *
+           * @returns the first child node (null if none).
+           */
+          NodeRef
+          getFirstChild() const
+          {
+            return NodeRef((*this)->getFirstChild());
+          }
+
+          /**
+           * Get the last child node.
+           *
+           * @returns the last child node (null if none).
+           */
+          NodeRef
+          getLastChild() const
+          {
+            return NodeRef((*this)->getLastChild());
+          }
+
+          /**
+           * Get the previous sibling node.
+           *
+           * @returns the previous sibling node (null if none).
+           */
+          NodeRef
+          getPreviousSibling() const
+          {
+            return NodeRef((*this)->getPreviousSibling());
+          }
+
+          /**
+           * Get the next sibling node.
+           *
+           * @returns the next sibling node (null if none).
+           */
+          NodeRef
+          getNextSibling() const
+          {
+            return NodeRef((*this)->getNextSibling());
+          }
+
+          /**
+           * Get node value.
+           *
+           * @returns the node value.
+           */
+          String
+          getNodeValue() const
+          {
+            return String((*this)->getNodeValue());
+          }
+
+          /**
+           * Get node text content.
+           *
+           * @returns the text content.
+           */
+          String
+          getTextContent() const
+          {
+            return String((*this)->getTextContent());
+          }
+
+        private:
+          /**
+           * Check if the referenced node is null.
+           *
+           * @throws a @c std::logic_error if null.
+           */
+          void
+          null_check() const
+          {
+            if (!node)
+              throw std::logic_error("Accessing null DOM node reference");
+          }
+
+          /// The referenced node.
+          xercesc::DOMNode *node;
+        };
+
+        class ElementRange;
+
+        /**
+         * Non-owning DOM Element reference.
+         *
+         * The Element counterpart of NodeRef.  An ElementRef may be
+         * created from a NodeRef referring to an element; the node
+         * type is only checked in debug builds.
+         */
+        class ElementRef
+        {
+        public:
+          /**
+           * Construct a null ElementRef.
+           */
+          ElementRef ():
+            element(nullptr)
+          {
+          }
+
+          /**
+           * Construct an ElementRef from a xercesc::DOMElement *.
+           *
+           * @param element the element to refer to (may be null).
+           */
+          explicit
+          ElementRef (xercesc::DOMElement *element):
+            element(element)
+          {
+          }
+
+          /**
+           * Construct an ElementRef from a NodeRef.
+           *
+           * This only accepts a NodeRef exactly, so that an Element is
+           * converted using its ElementRef conversion rather than
+           * ambiguously via NodeRef.
+           *
+           * @param node the node to refer to (may be null); must be an
+           * element.
+           */
+          template<typename T,
+                   typename = typename std::enable_if<std::is_same<T, NodeRef>::value>::type>
+          explicit
+          ElementRef (T node):
+            element(detail::element_cast(node.get()))
+          {
+          }
+
+          /**
+           * Get referenced xercesc::DOMElement *.
+           *
+           * @note May be null.
+           *
+           * @returns the referenced element.
+           */
+          xercesc::DOMElement *
+          get() const
+          {
+            return element;
+          }
+
+          /**
+           * Dereference to xercesc::DOMElement.
+           *
+           * @returns the referenced element.
+           * @throws std::logic_error if null.
+           */
+          xercesc::DOMElement&
+          operator* () const
+          {
+            null_check();
+            return *element;
+          }
+
+          /**
+           * Dereference to xercesc::DOMElement.
+           *
+           * @returns the referenced element.
+           * @throws std::logic_error if null.
+           */
+          xercesc::DOMElement *
+          operator-> () const
+          {
+            null_check();
+            return element;
+          }
+
+          /**
+           * Check if the referenced element is not null.
+           *
+           * @returns true if not null, false if null.
+           */
+          operator bool () const
+          {
+            return element != nullptr;
+          }
+
+          /**
+           * Convert to a NodeRef.
+           *
+           * @returns a NodeRef referring to the same element.
+           */
+          operator NodeRef () const
+          {
+            return NodeRef(element);
+          }
+
+          /**
+           * Compare with another ElementRef.
+           *
+           * @param rhs the ElementRef to compare with.
+           * @returns true if both refer to the same element, otherwise
+           * false.
+           */
+          bool
+          operator == (const ElementRef& rhs) const
+          {
+            return element == rhs.element;
+          }
+
+          /**
+           * Compare with another ElementRef.
+           *
+           * @param rhs the ElementRef to compare with.
+           * @returns true if the elements differ, otherwise false.
+           */
+          bool
+          operator != (const ElementRef& rhs) const
+          {
+            return element != rhs.element;
+          }
+
+          /**
+           * Get Element tag name.
+           *
+           * @returns the tag name.
+           */
+          String
+          getTagName() const
+          {
+            return String((*this)->getTagName());
+          }
+
+          /**
+           * Get the parent element.
+           *
+           * @returns the parent element (null if the parent is not an
+           * element).
+           */
+          ElementRef
+          getParentElement() const
+          {
+            xercesc::DOMNode *parent = (*this)->getParentNode();
+            if (parent && parent->getNodeType() == xercesc::DOMNode::ELEMENT_NODE)
+              return ElementRef(NodeRef(parent));
+            return ElementRef();
+          }
+
+          /**
+           * Get the first child element.
+           *
+           * @returns the first child element (null if none).
+           */
+          ElementRef
+          getFirstElementChild() const
+          {
+            return ElementRef((*this)->getFirstElementChild());
+          }
+
+          /**
+           * Get the last child element.
+           *
+           * @returns the last child element (null if none).
+           */
+          ElementRef
+          getLastElementChild() const
+          {
+            return ElementRef((*this)->getLastElementChild());
+          }
+
+          /**
+           * Get the previous sibling element.
+           *
+           * @returns the previous sibling element (null if none).
+           */
+          ElementRef
+          getPreviousElementSibling() const
+          {
+            return ElementRef((*this)->getPreviousElementSibling());
+          }
+
+          /**
+           * Get the next sibling element.
+           *
+           * @returns the next sibling element (null if none).
+           */
+          ElementRef
+          getNextElementSibling() const
+          {
+            return ElementRef((*this)->getNextElementSibling());
+          }
+
+          /**
+           * Get the number of child elements.
+           *
+           * @returns the number of child elements.
+           */
+          std::size_t
+          getChildElementCount() const
+          {
+            return (*this)->getChildElementCount();
+          }
+
+          /**
+           * Get the child elements.
+           *
+           * @returns a range of all child elements.
+           */
+          ElementRange
+          children() const;
+
+          /**
+           * Get the child elements with a given tag name.
+           *
+           * @param name the tag name to match; a Name lvalue must
+           * outlive the range, while a temporary is kept by the range.
+           * @returns a range of matching child elements.
+           */
+          ElementRange
+          childElements(detail::name_ref name) const;
+
+          /**
+           * Get the child elements with a given namespace and local
+           * name.
+           *
+           * @param ns the namespace URI to match.
+           * @param local the local name to match.
+           * @returns a range of matching child elements.
+           *
+           * As for childElements(), Name lvalues must outlive the
+           * range, while temporaries are kept by the range.
+           */
+          ElementRange
+          childElementsNS(detail::name_ref ns,
+                          detail::name_ref local) const;
+
+          /**
+           * Check if the Element has the specified attribute.
+           *
+           * @param attr the attribute to check.
+           * @returns true if the Element has the attribute, otherwise
+           * false.
+           */
+          bool
+          hasAttribute(const std::string& attr) const
+          {
+            return (*this)->hasAttribute(String(attr));
+          }
+
+          /**
+           * Check if the Element has the specified attribute.
+           *
+           * @param attr the attribute to check.
+           * @returns true if the Element has the attribute, otherwise
+           * false.
+           */
+          bool
+          hasAttribute(const Name& attr) const
+          {
+            return (*this)->hasAttribute(attr);
+          }
+
+          /**
+           * Get the specified attribute value.
+           *
+           * @param attr the attribute to get.
+           * @returns the attribute value.
+           */
+          String
+          getAttribute(const std::string& attr) const
+          {
+            return String((*this)->getAttribute(String(attr)));
+          }
+
+          /**
+           * Get the specified attribute value.
+           *
+           * @param attr the attribute to get.
+           * @returns the attribute value.
+           */
+          String
+          getAttribute(const Name& attr) const
+          {
+            return String((*this)->getAttribute(attr));
+          }
+
+          /**
+           * Get Element text content.
+           *
+           * @returns the text content.
+           */
+          String
+          getTextContent() const
+          {
+            return String((*this)->getTextContent());
+          }
+
+        private:
+          /**
+           * Check if the referenced element is null.
+           *
+           * @throws a @c std::logic_error if null.
+           */
+          void
+          null_check() const
+          {
+            if (!element)
+              throw std::logic_error("Accessing null DOM element reference");
+          }
+
+          /// The referenced element.
+          xercesc::DOMElement *element;
+        };
+
+        /**
+         * Range of child elements.
+         *
+         * The range walks the child elements of a parent element
+         * directly using the Xerces element sibling links, skipping
+         * all non-element nodes.  The elements may optionally be
+         * filtered by tag name, or by namespace URI and local name.
+         * Iteration yields ElementRef values and does not allocate,
+         * transcode or downcast.
+         *
+         * Filter Names passed as lvalues are held by pointer, so
+         * must outlive the range and its iterators; static or
+         * interned Names are suitable, and avoid any copying.
+         * Temporary Names are moved into the range, and live as long
+         * as the range and its copies.
+         *
+         * @code
+         * static const xml::Name image("Image");
+         * for (auto child : element.childElements(image))
+         *   process(child);
+         * @endcode
+         */
+        class ElementRange
+        {
+        public:
+          /**
+           * Forward iterator over child elements.
+           */
+          class iterator
+          {
+          public:
+            /// Iterator category.
+            typedef std::forward_iterator_tag iterator_category;
+            /// Value type.
+            typedef ElementRef value_type;
+            /// Difference type.
+            typedef std::ptrdiff_t difference_type;
+            /// Pointer type (ElementRef dereferences to the DOMElement).
+            typedef ElementRef pointer;
+            /// Reference type (ElementRef is returned by value).
+            typedef ElementRef reference;
+
+            /**
+             * Construct a past-the-end iterator.
+             */
+            iterator ():
+              element(nullptr),
+              tag(nullptr),
+              ns(nullptr),
+              local(nullptr)
+            {
+            }
+
+            /**
+             * Construct an iterator at the first matching element.
+             *
+             * @param element the element to start from (may be null).
+             * @param tag the tag name to match (null to match any).
+             * @param ns the namespace URI to match (null to match any).
+             * @param local the local name to match (null to match any).
+             */
+            iterator (xercesc::DOMElement *element,
+                      const Name          *tag,
+                      const Name          *ns,
+                      const Name          *local):
+              element(element),
+              tag(tag),
+              ns(ns),
+              local(local)
+            {
+              skip();
+            }
+
+            /**
+             * Dereference the iterator.
+             *
+             * @returns the element at this position.
+             */
+            reference
+            operator* () const
+            {
+              assert(element);
+              return ElementRef(element);
+            }
+
+            /**
+             * Dereference the iterator.
+             *
+             * @returns the element at this position.
+             */
+            pointer
+            operator-> () const
+            {
+              return **this;
+            }
+
+            /**
+             * Move the iterator forward to the next matching element.
+             *
+             * @returns the iterator at the new position.
+             */
+            iterator&
+            operator++ ()
+            {
+              assert(element);
+              element = element->getNextElementSibling();
+              skip();
+              return *this;
+            }
+
+            /**
+             * Move the iterator forward to the next matching element.
+             *
+             * @returns the iterator at the old position.
+             */
+            iterator
+            operator++ (int)
+            {
+              iterator ret(*this);
+              ++(*this);
+              return ret;
+            }
+
+            /**
+             * Check the equality of two iterators.
+             *
+             * @param rhs the iterator to compare with.
+             * @returns true if equal, otherwise false.
+             */
+            bool
+            operator == (const iterator& rhs) const
+            {
+              return element == rhs.element;
+            }
+
+            /**
+             * Check the non-equality of two iterators.
+             *
+             * @param rhs the iterator to compare with.
+             * @returns true if not equal, otherwise false.
+             */
+            bool
+            operator != (const iterator& rhs) const
+            {
+              return element != rhs.element;
+            }
+
+          private:
+            /**
+             * Check if the current element matches the filter.
+             *
+             * @returns true if matching, otherwise false.
+             */
+            bool
+            matches() const
+            {
+              if (tag && !(*tag == element->getTagName()))
+                return false;
+              if (local && !(*local == element->getLocalName()))
+                return false;
+              if (ns && !(*ns == element->getNamespaceURI()))
+                return false;
+              return true;
+            }
+
+            /**
+             * Advance to the first matching element at or after the
+             * current position.
+             */
+            void
+            skip()
+            {
+              while (element && !matches())
+                element = element->getNextElementSibling();
+            }
+
+            /// The current element.
+            xercesc::DOMElement *element;
+            /// Tag name filter.
+            const Name *tag;
+            /// Namespace URI filter.
+            const Name *ns;
+            /// Local name filter.
+            const Name *local;
+          };
+
+          /// Constant iterator.
+          typedef iterator const_iterator;
+
+          /**
+           * Construct a range of all child elements.
+           *
+           * @param parent the parent element (may be null).
+           */
+          explicit
+          ElementRange (ElementRef parent):
+            parent(parent),
+            tag(),
+            ns(),
+            local()
+          {
+          }
+
+          /**
+           * Construct a range of child elements with a given tag name.
+           *
+           * @param parent the parent element (may be null).
+           * @param tag the tag name to match.
+           */
+          ElementRange (ElementRef       parent,
+                        detail::name_ref tag):
+            parent(parent),
+            tag(std::move(tag)),
+            ns(),
+            local()
+          {
+          }
+
+          /**
+           * Construct a range of child elements with a given namespace
+           * URI and local name.
+           *
+           * @param parent the parent element (may be null).
+           * @param ns the namespace URI to match.
+           * @param local the local name to match.
+           */
+          ElementRange (ElementRef       parent,
+                        detail::name_ref ns,
+                        detail::name_ref local):
+            parent(parent),
+            tag(),
+            ns(std::move(ns)),
+            local(std::move(local))
+          {
+          }
+
+          /**
+           * Get an iterator pointing to the first matching element.
+           *
+           * @returns an iterator pointing to the first matching element.
+           */
+          iterator
+          begin() const
+          {
+            return iterator(parent ? parent.get()->getFirstElementChild() : nullptr,
+                            tag.get(), ns.get(), local.get());
+          }
+
+          /**
+           * Get an iterator pointing past the last matching element.
+           *
+           * @returns an iterator pointing past the last matching element.
+           */
+          iterator
+          end() const
+          {
+            return iterator();
+          }
+
+          /**
+           * Check if the range is empty.
+           *
+           * @returns @c true if empty, @c false if not empty.
+           */
+          bool
+          empty() const
+          {
+            return begin() == end();
+          }
+
+          /**
+           * Get the first matching element.
+           *
+           * @returns the first matching element (null if none).
+           */
+          ElementRef
+          front() const
+          {
+            iterator i(begin());
+            return i != end() ? *i : ElementRef();
+          }
+
+        private:
+          /// The parent element.
+          ElementRef parent;
+          /// Tag name filter.
+          detail::name_ref tag;
+          /// Namespace URI filter.
+          detail::name_ref ns;
+          /// Local name filter.
+          detail::name_ref local;
+        };
+
+        inline
+        ElementRange
+        ElementRef::children() const
+        {
+          return ElementRange(*this);
+        }
+
+        inline
+        ElementRange
+        ElementRef::childElements(detail::name_ref name) const
+        {
+          return ElementRange(*this, std::move(name));
+        }
+
+        inline
+        ElementRange
+        ElementRef::childElementsNS(detail::name_ref ns,
+                                   detail::name_ref local) const
+        {
+          return ElementRange(*this, std::move(ns), std::move(local));
+        }
+
+      }
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_DOM_NODEREF_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
@@ -0,0 +1,182 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#include <atomic>
+#include <stdexcept>
+
+#include <ome/common/xml/dom/ParserCache.h>
+
+namespace
+{
+
+  /// Serial number for the next ParserCache.
+  std::atomic<uint64_t> next_serial(1);
+
+  /**
+   * The parser most recently used by this thread.
+   *
+   * Caches are identified by serial number rather than address, so
+   * that a new cache allocated at the address of a destroyed cache
+   * will not match.
+   */
+  struct ThreadParser
+  {
+    /// Serial number of the owning cache.
+    uint64_t serial;
+    /// The parser.
+    ome::common::xml::dom::DocumentParser *parser;
+  };
+
+  thread_local ThreadParser current_parser = { 0, nullptr };
+
+}
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace dom
+      {
+
+        ParserCache::ParserCache(EntityResolver&        resolver,
+                                 const ParseParameters& params):
+          xmlplat(),
+          resolver(resolver),
+          pool(nullptr),
+          params(params),
+          serial(next_serial.fetch_add(1, std::memory_order_relaxed)),
+          mutex(),
+          parsers()
+        {
+        }
+
+        ParserCache::ParserCache(EntityResolver&        resolver,
+                                 GrammarPool&           pool,
+                                 const ParseParameters& params):
+          xmlplat(),
+          resolver(resolver),
+          pool(&pool),
+          params(params),
+          serial(next_serial.fetch_add(1, std::memory_order_relaxed)),
+          mutex(),
+          parsers()
+        {
+          if (!pool.locked())
+            throw std::logic_error("GrammarPool must be locked for concurrent use");
+        }
+
+        ParserCache::~ParserCache()
+        {
+        }
+
+        DocumentParser&
+        ParserCache::parser()
+        {
+          if (current_parser.serial == serial)
+            return *current_parser.parser;
+
+          std::lock_guard<std::mutex> lock(mutex);
+
+          std::unique_ptr<DocumentParser>& p(parsers[std::this_thread::get_id()]);
+          if (!p)
+            {
+              if (pool)
+                p.reset(new DocumentParser(resolver, *pool, params));
+              else
+                p.reset(new DocumentParser(resolver, params));
+            }
+
+          current_parser.serial = serial;
+          current_parser.parser = p.get();
+
+          return *p;
+        }
+
+        void
+        ParserCache::release()
+        {
+          std::unique_ptr<DocumentParser> p;
+
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            parser_map_type::iterator i = parsers.find(std::this_thread::get_id());
+            if (i == parsers.end())
+              return;
+            p = std::move(i->second);
+            parsers.erase(i);
+          }
+
+          if (current_parser.serial == serial)
+            current_parser = { 0, nullptr };
+        }
+
+        Document
+        ParserCache::parse(const boost::filesystem::path& file)
+        {
+          return parser().parse(file);
+        }
+
+        Document
+        ParserCache::parse(const std::string& text,
+                           const std::string& id)
+        {
+          return parser().parse(text, id);
+        }
+
+        Document
+        ParserCache::parse(std::istream&      stream,
+                           const std::string& id)
+        {
+          return parser().parse(stream, id);
+        }
+
+        std::size_t
+        ParserCache::size() const
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+
+          return parsers.size();
+        }
+
+      }
+    }
+  }
+}
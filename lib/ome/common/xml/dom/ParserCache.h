@@ -0,0 +1,222 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_DOM_PARSERCACHE_H
+#define OME_COMMON_XML_DOM_PARSERCACHE_H
+
+#include <ome/common/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <boost/filesystem/path.hpp>
+
+#include <ome/common/xml/EntityResolver.h>
+#include <ome/common/xml/GrammarPool.h>
+#include <ome/common/xml/Platform.h>
+#include <ome/common/xml/dom/Document.h>
+#include <ome/common/xml/dom/DocumentParser.h>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace dom
+      {
+
+        /**
+         * Thread-safe DOM document parsing.
+         *
+         * A DocumentParser may only be used by one thread at a time.
+         * This class maintains a separate DocumentParser for each
+         * thread which uses it, created on first use, so that any
+         * number of threads may parse documents concurrently without
+         * locking.  All of the parsers share the same EntityResolver,
+         * parameters and (optionally) GrammarPool.  The Xerces
+         * platform is kept initialized for the lifetime of the cache.
+         *
+         * The intended use is to create a single ParserCache when the
+         * application starts, optionally with a preloaded and locked
+         * GrammarPool, and to share it between all worker threads.
+         *
+         * Parsers are owned by the cache, and one is kept for every
+         * thread ID which has used it until the cache is destroyed
+         * or the thread calls release(); a parser created for a
+         * thread which has exited will be reused by a later thread
+         * with the same thread ID.  Threads which are created for a
+         * short task, rather than drawn from a pool, should call
+         * release() when done so that the cache does not grow with
+         * every thread.  The cache must not be destroyed while any
+         * thread is using it, and the EntityResolver and GrammarPool
+         * must outlive it.
+         */
+        class ParserCache
+        {
+        public:
+          /**
+           * Construct a ParserCache.
+           *
+           * @param resolver the EntityResolver to use.
+           * @param params XML parser parameters.
+           */
+          ParserCache(EntityResolver&        resolver,
+                      const ParseParameters& params = ParseParameters());
+
+          /**
+           * Construct a ParserCache using cached grammars.
+           *
+           * @param resolver the EntityResolver to use.
+           * @param pool the GrammarPool to use; this must be locked.
+           * @param params XML parser parameters.
+           * @throws std::logic_error if the GrammarPool is not locked.
+           */
+          ParserCache(EntityResolver&        resolver,
+                      GrammarPool&           pool,
+                      const ParseParameters& params = ParseParameters());
+
+          /// Destructor.
+          ~ParserCache();
+
+          /// Copy constructor (deleted).
+          ParserCache(const ParserCache&) = delete;
+
+          /// Assignment operator (deleted).
+          ParserCache&
+          operator= (const ParserCache&) = delete;
+
+          /**
+           * Get the DocumentParser for the calling thread.
+           *
+           * The parser is created on first use by each thread.
+           *
+           * @returns the parser.
+           */
+          DocumentParser&
+          parser();
+
+          /**
+           * Destroy the DocumentParser for the calling thread.
+           *
+           * Documents already parsed are not affected.  A new parser
+           * will be created if the thread uses the cache again.
+           */
+          void
+          release();
+
+          /**
+           * Parse a Document from the content of a file.
+           *
+           * @param file the file to read.
+           * @returns the new Document.
+           * @throws std::runtime_error if parsing fails.
+           */
+          Document
+          parse(const boost::filesystem::path& file);
+
+          /**
+           * Parse a Document from the content of a string.
+           *
+           * @param text the string to use.
+           * @param id document filename (for error reporting only).
+           * @returns the new Document.
+           * @throws std::runtime_error if parsing fails.
+           */
+          Document
+          parse(const std::string& text,
+                const std::string& id = "membuf");
+
+          /**
+           * Parse a Document from the content of an input stream.
+           *
+           * @param stream the stream to read.
+           * @param id document filename (for error reporting only).
+           * @returns the new Document.
+           * @throws std::runtime_error if parsing fails.
+           */
+          Document
+          parse(std::istream&      stream,
+                const std::string& id = "streambuf");
+
+          /**
+           * Get the number of per-thread parsers created.
+           *
+           * @returns the number of parsers.
+           */
+          std::size_t
+          size() const;
+
+        private:
+          /// Per-thread parser storage.
+          typedef std::map<std::thread::id, std::unique_ptr<DocumentParser>> parser_map_type;
+
+          /// Xerces platform (declared first, so destroyed last).
+          Platform xmlplat;
+          /// Entity resolver.
+          EntityResolver& resolver;
+          /// Grammar pool (optional).
+          GrammarPool *pool;
+          /// Parser parameters.
+          ParseParameters params;
+          /// Unique serial number of this cache.
+          uint64_t serial;
+          /// Mutex to lock the parser map.
+          mutable std::mutex mutex;
+          /// Parsers for each thread.
+          parser_map_type parsers;
+        };
+
+      }
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_DOM_PARSERCACHE_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
@@ -0,0 +1,347 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#include <stdexcept>
+
+#include <boost/format.hpp>
+
+#include <ome/common/xml/dom/Query.h>
+
+#include <xercesc/dom/DOMAttr.hpp>
+#include <xercesc/dom/DOMDocument.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace dom
+      {
+
+        namespace
+        {
+
+          // Maximum number of steps (limited by state_type).
+          const std::size_t max_steps = 63;
+
+          // Check if a character terminates a name.
+          bool
+          name_end(char c)
+          {
+            return c == '/' || c == '[' || c == ']' || c == '@' ||
+              c == '=' || c == '\'' || c == '"' || c == ' ' ||
+              c == '\t' || c == '\n' || c == '\r';
+          }
+
+        }
+
+        Query::Query(const std::string& expression):
+          expression(expression),
+          is_absolute(false),
+          steps(),
+          descendants(0),
+          attribute(nullptr)
+        {
+          compile(namespace_map());
+        }
+
+        Query::Query(const std::string&   expression,
+                     const namespace_map& namespaces):
+          expression(expression),
+          is_absolute(false),
+          steps(),
+          descendants(0),
+          attribute(nullptr)
+        {
+          compile(namespaces);
+        }
+
+        String
+        Query::value(ElementRef element) const
+        {
+          if (attribute)
+            return element.getAttribute(*attribute);
+          return element.getTextContent();
+        }
+
+        xercesc::DOMNode *
+        Query::root(ElementRef element) const
+        {
+          if (is_absolute && element)
+            return element->getOwnerDocument();
+          return element.get();
+        }
+
+        void
+        Query::compile(const namespace_map& namespaces)
+        {
+          const std::string& e(expression);
+          std::string::size_type pos = 0;
+
+          auto fail = [&](const std::string& reason)
+            {
+              boost::format fmt("Invalid XML query ‘%1%’: %2% at position %3%");
+              fmt % expression % reason % pos;
+              throw std::runtime_error(fmt.str());
+            };
+
+          auto parse_name = [&]()
+            {
+              std::string::size_type start = pos;
+              while (pos < e.size() && !name_end(e[pos]))
+                ++pos;
+              // XML names may not start with '.', '-' or a digit.
+              if (pos == start || e[start] == '.' || e[start] == '-' ||
+                  (e[start] >= '0' && e[start] <= '9'))
+                {
+                  pos = start;
+                  fail("expected name");
+                }
+              return e.substr(start, pos - start);
+            };
+
+          if (e.compare(0, 1, "/") == 0)
+            is_absolute = true;
+          else if (e.compare(0, 2, "./") == 0)
+            pos = 1;
+
+          while (true)
+            {
+              bool descendant = false;
+              if (pos < e.size() && e[pos] == '/')
+                {
+                  ++pos;
+                  if (pos < e.size() && e[pos] == '/')
+                    {
+                      descendant = true;
+                      ++pos;
+                    }
+                }
+              else if (pos != 0)
+                fail("expected ‘/’");
+
+              if (pos < e.size() && e[pos] == '@')
+                {
+                  if (descendant)
+                    fail("attribute step must be a child step");
+                  if (steps.empty())
+                    fail("attribute step must follow an element step");
+                  ++pos;
+                  attribute = &Name::intern(parse_name());
+                  if (pos != e.size())
+                    fail("attribute step must be the final step");
+                  break;
+                }
+
+              if (steps.size() == max_steps)
+                fail("too many steps");
+
+              Step step;
+              step.descendant = descendant;
+              step.local = nullptr;
+              step.ns = nullptr;
+
+              if (pos < e.size() && e[pos] == '*')
+                ++pos;
+              else
+                {
+                  std::string name(parse_name());
+                  std::string::size_type colon = name.find(':');
+                  if (colon != std::string::npos)
+                    {
+                      std::string prefix(name.substr(0, colon));
+                      namespace_map::const_iterator ns = namespaces.find(prefix);
+                      if (ns == namespaces.end())
+                        fail("unknown namespace prefix ‘" + prefix + "’");
+                      step.ns = &Name::intern(ns->second);
+                      name.erase(0, colon + 1);
+                      if (name.empty())
+                        fail("expected local name");
+                    }
+                  if (name.find('*') != std::string::npos)
+                    {
+                      // p:* matches any element in the namespace.
+                      if (step.ns && name == "*")
+                        name.clear();
+                      else
+                        fail("unexpected ‘*’ in name");
+                    }
+                  if (!name.empty())
+                    step.local = &Name::intern(name);
+                }
+
+              while (pos < e.size() && e[pos] == '[')
+                {
+                  ++pos;
+                  if (pos == e.size() || e[pos] != '@')
+                    fail("expected ‘@’");
+                  ++pos;
+
+                  Predicate predicate;
+                  predicate.attribute = &Name::intern(parse_name());
+                  if (pos < e.size() && e[pos] == '=')
+                    {
+                      ++pos;
+                      if (pos == e.size() || (e[pos] != '\'' && e[pos] != '"'))
+                        fail("expected quoted value");
+                      char quote = e[pos++];
+                      std::string::size_type end = e.find(quote, pos);
+                      if (end == std::string::npos)
+                        fail("unterminated value");
+                      predicate.value = std::make_shared<const Name>(e.substr(pos, end - pos));
+                      pos = end + 1;
+                    }
+                  if (pos == e.size() || e[pos] != ']')
+                    fail("expected ‘]’");
+                  ++pos;
+                  step.predicates.push_back(predicate);
+                }
+
+              if (descendant)
+                descendants |= state_type(1) << steps.size();
+              steps.push_back(step);
+
+              if (pos == e.size())
+                break;
+            }
+        }
+
+        void
+        Query::evaluate(xercesc::DOMNode *start,
+                        visitor_type      visitor,
+                        void             *data) const
+        {
+          if (!start)
+            return;
+
+          const state_type first = 1;
+
+          if (start->getNodeType() == xercesc::DOMNode::DOCUMENT_NODE)
+            {
+              // The document element is the only element child of the
+              // document node.
+              xercesc::DOMElement *element = static_cast<xercesc::DOMDocument *>(start)->getDocumentElement();
+              if (element)
+                match(element, first, visitor, data);
+            }
+          else
+            {
+              for (xercesc::DOMElement *child = detail::element_cast(start)->getFirstElementChild();
+                   child;
+                   child = child->getNextElementSibling())
+                if (!match(child, first, visitor, data))
+                  break;
+            }
+        }
+
+        bool
+        Query::match(xercesc::DOMElement *element,
+                     state_type           active,
+                     visitor_type         visitor,
+                     void                *data) const
+        {
+          const std::size_t size = steps.size();
+
+          // Descendant steps remain active below this element whether
+          // or not it matches; matched steps activate the next step.
+          state_type next = active & descendants;
+          bool found = false;
+          for (std::size_t i = 0; i < size; ++i)
+            {
+              if ((active & (state_type(1) << i)) && matches(steps[i], element))
+                {
+                  if (i + 1 == size)
+                    found = true;
+                  else
+                    next |= state_type(1) << (i + 1);
+                }
+            }
+
+          if (found && (!attribute || element->hasAttribute(*attribute)))
+            {
+              if (!visitor(data, ElementRef(element)))
+                return false;
+            }
+
+          if (next)
+            {
+              for (xercesc::DOMElement *child = element->getFirstElementChild();
+                   child;
+                   child = child->getNextElementSibling())
+                if (!match(child, next, visitor, data))
+                  return false;
+            }
+
+          return true;
+        }
+
+        bool
+        Query::matches(const Step&          step,
+                       xercesc::DOMElement *element)
+        {
+          if (step.local)
+            {
+              const XMLCh *name = element->getLocalName();
+              // Elements created without namespace support have no
+              // local name.
+              if (!name)
+                name = element->getTagName();
+              if (!(*step.local == name))
+                return false;
+            }
+
+          if (step.ns && !(*step.ns == element->getNamespaceURI()))
+            return false;
+
+          for (const auto& predicate : step.predicates)
+            {
+              const xercesc::DOMAttr *attr = element->getAttributeNode(*predicate.attribute);
+              if (!attr)
+                return false;
+              if (predicate.value && !(*predicate.value == attr->getValue()))
+                return false;
+            }
+
+          return true;
+        }
+
+      }
+    }
+  }
+}
@@ -0,0 +1,444 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_DOM_QUERY_H
+#define OME_COMMON_XML_DOM_QUERY_H
+
+#include <ome/common/config.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ome/common/xml/Name.h>
+#include <ome/common/xml/String.h>
+#include <ome/common/xml/dom/Document.h>
+#include <ome/common/xml/dom/NodeRef.h>
+
+#include <xercesc/dom/DOMElement.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace dom
+      {
+
+        /**
+         * Compiled path query.
+         *
+         * A Query is a small subset of XPath, compiled once and then
+         * evaluated against any number of documents.  The supported
+         * syntax is:
+         *
+         * - @c /a/b: child steps from the document (absolute path)
+         * - @c a/b or @c ./a/b: child steps from a context element
+         *   (relative path)
+         * - @c //a or @c a//b: descendant steps
+         * - @c *: any element
+         * - @c p:a: element @c a in the namespace mapped to prefix @c p
+         * - @c p:*: any element in the namespace mapped to prefix @c p
+         * - @c a[\@x]: elements with attribute @c x
+         * - @c a[\@x='v']: elements with attribute @c x equal to @c v
+         *   (multiple predicates must all match)
+         * - @c a/\@x: a final attribute step, selecting the value of
+         *   attribute @c x
+         *
+         * Unprefixed element names match the local name in any
+         * namespace, so @c /OME/Image/Pixels matches regardless of
+         * the namespace prefixes used by the document.  Attribute
+         * names are matched by qualified name.
+         *
+         * Names are interned upon compilation.  Evaluation walks the
+         * element tree once, in document order, without creating
+         * DOMNodeLists or other intermediate results; subtrees which
+         * cannot match are skipped.  Each matching element is
+         * visited once, even if it matches by more than one path.
+         *
+         * @code
+         * static const xml::dom::Query sizex("/OME/Image/Pixels/@SizeX");
+         * for (const auto& value : sizex.values(doc))
+         *   std::cout << value << '\n';
+         * @endcode
+         */
+        class Query
+        {
+        public:
+          /// Mapping of namespace prefixes to namespace URIs.
+          typedef std::map<std::string, std::string> namespace_map;
+
+          /**
+           * Compile a query.
+           *
+           * @param expression the query expression.
+           * @throws std::runtime_error if the expression is invalid.
+           */
+          explicit
+          Query(const std::string& expression);
+
+          /**
+           * Compile a query using namespace prefixes.
+           *
+           * @param expression the query expression.
+           * @param namespaces the namespace URIs for the prefixes used
+           * in element names.
+           * @throws std::runtime_error if the expression is invalid or
+           * uses an unknown prefix.
+           */
+          Query(const std::string&   expression,
+                const namespace_map& namespaces);
+
+          /**
+           * Get the query expression.
+           *
+           * @returns the expression.
+           */
+          const std::string&
+          str() const
+          {
+            return expression;
+          }
+
+          /**
+           * Check if the query is an absolute path.
+           *
+           * Absolute queries are evaluated from the document, even
+           * when given a context element.
+           *
+           * @returns @c true if absolute, @c false if relative.
+           */
+          bool
+          absolute() const
+          {
+            return is_absolute;
+          }
+
+          /**
+           * Check if the query ends with an attribute step.
+           *
+           * @returns @c true if selecting an attribute, otherwise
+           * @c false.
+           */
+          bool
+          selectsAttribute() const
+          {
+            return attribute != nullptr;
+          }
+
+          /**
+           * Call a function for each matching element.
+           *
+           * For attribute queries, the elements are those which have
+           * the attribute.  The function may return @c void, or
+           * @c bool to stop the evaluation by returning @c false.
+           *
+           * @param context the document or element to evaluate from.
+           * @param func the function to call with each ElementRef.
+           */
+          template<typename Context, typename F>
+          void
+          forEach(const Context& context,
+                  F              func) const
+          {
+            evaluate(root(context), &visit<F>, &func);
+          }
+
+          /**
+           * Get all matching elements.
+           *
+           * @param context the document or element to evaluate from.
+           * @returns the matching elements, in document order.
+           */
+          template<typename Context>
+          std::vector<ElementRef>
+          select(const Context& context) const
+          {
+            std::vector<ElementRef> ret;
+            forEach(context, [&ret](ElementRef element) { ret.push_back(element); });
+            return ret;
+          }
+
+          /**
+           * Get the first matching element.
+           *
+           * @param context the document or element to evaluate from.
+           * @returns the first matching element, or null if none.
+           */
+          template<typename Context>
+          ElementRef
+          selectFirst(const Context& context) const
+          {
+            ElementRef ret;
+            forEach(context, [&ret](ElementRef element) { ret = element; return false; });
+            return ret;
+          }
+
+          /**
+           * Get the values of all matches.
+           *
+           * The value is the attribute value for attribute queries,
+           * or the element text content otherwise.
+           *
+           * @param context the document or element to evaluate from.
+           * @returns the matching values, in document order.
+           */
+          template<typename Context>
+          std::vector<String>
+          values(const Context& context) const
+          {
+            std::vector<String> ret;
+            forEach(context, [this, &ret](ElementRef element) { ret.push_back(value(element)); });
+            return ret;
+          }
+
+          /**
+           * Get the value of the first match.
+           *
+           * @param context the document or element to evaluate from.
+           * @returns the first matching value, or an empty string if
+           * none.
+           */
+          template<typename Context>
+          String
+          selectValue(const Context& context) const
+          {
+            ElementRef element(selectFirst(context));
+            return element ? value(element) : String("");
+          }
+
+          /**
+           * Get the value of a matching element.
+           *
+           * @param element the matching element.
+           * @returns the attribute value for attribute queries, or the
+           * element text content otherwise.
+           */
+          String
+          value(ElementRef element) const;
+
+        private:
+          /// Attribute predicate.
+          struct Predicate
+          {
+            /// Attribute name.
+            const Name *attribute;
+            /// Attribute value (null to only check presence).
+            std::shared_ptr<const Name> value;
+          };
+
+          /// Location step.
+          struct Step
+          {
+            /// Match descendants (or only children)?
+            bool descendant;
+            /// Local name (null for any element).
+            const Name *local;
+            /// Namespace URI (null for any namespace).
+            const Name *ns;
+            /// Attribute predicates.
+            std::vector<Predicate> predicates;
+          };
+
+          /// Match bitmask; bit @c n is set if step @c n is next.
+          typedef std::uint64_t state_type;
+
+          /// Type-erased visitor function; returns @c false to stop.
+          typedef bool (*visitor_type)(void *, ElementRef);
+
+          /**
+           * Call a visitor returning @c void.
+           *
+           * @param func the visitor.
+           * @param element the element to visit.
+           * @returns @c true to continue.
+           */
+          template<typename F>
+          static
+          typename std::enable_if<std::is_void<decltype(std::declval<F&>()(std::declval<ElementRef>()))>::value, bool>::type
+          call(F&         func,
+               ElementRef element)
+          {
+            func(element);
+            return true;
+          }
+
+          /**
+           * Call a visitor returning @c bool.
+           *
+           * @param func the visitor.
+           * @param element the element to visit.
+           * @returns @c false to stop.
+           */
+          template<typename F>
+          static
+          typename std::enable_if<!std::is_void<decltype(std::declval<F&>()(std::declval<ElementRef>()))>::value, bool>::type
+          call(F&         func,
+               ElementRef element)
+          {
+            return func(element);
+          }
+
+          /**
+           * Type-erased visitor.
+           *
+           * @param func pointer to the visitor.
+           * @param element the element to visit.
+           * @returns @c false to stop.
+           */
+          template<typename F>
+          static
+          bool
+          visit(void       *func,
+                ElementRef  element)
+          {
+            return call(*static_cast<F *>(func), element);
+          }
+
+          /**
+           * Get the starting node for evaluation from a document.
+           *
+           * @param document the document.
+           * @returns the document node.
+           */
+          static
+          xercesc::DOMNode *
+          root(const Document& document)
+          {
+            return const_cast<xercesc::DOMDocument *>(document.get());
+          }
+
+          /**
+           * Get the starting node for evaluation from an element.
+           *
+           * @param element the context element.
+           * @returns the context element, or its document for absolute
+           * queries.
+           */
+          xercesc::DOMNode *
+          root(ElementRef element) const;
+
+          /**
+           * Get the starting node for evaluation from an element.
+           *
+           * @param element the context element.
+           * @returns the context element, or its document for absolute
+           * queries.
+           */
+          xercesc::DOMNode *
+          root(const Element& element) const
+          {
+            return root(ElementRef(element));
+          }
+
+          /**
+           * Compile the expression.
+           *
+           * @param namespaces the namespace prefix mapping.
+           */
+          void
+          compile(const namespace_map& namespaces);
+
+          /**
+           * Evaluate the query.
+           *
+           * @param start the node to evaluate from.
+           * @param visitor the visitor to call for each match.
+           * @param data the visitor data.
+           */
+          void
+          evaluate(xercesc::DOMNode *start,
+                   visitor_type      visitor,
+                   void             *data) const;
+
+          /**
+           * Match an element and its descendants.
+           *
+           * @param element the element to match.
+           * @param active the steps which may match the element.
+           * @param visitor the visitor to call for each match.
+           * @param data the visitor data.
+           * @returns @c false if the visitor stopped the evaluation.
+           */
+          bool
+          match(xercesc::DOMElement *element,
+                state_type           active,
+                visitor_type         visitor,
+                void                *data) const;
+
+          /**
+           * Check if an element matches a step.
+           *
+           * @param step the step to check.
+           * @param element the element to check.
+           * @returns @c true if matching, otherwise @c false.
+           */
+          static
+          bool
+          matches(const Step&          step,
+                  xercesc::DOMElement *element);
+
+          /// The query expression.
+          std::string expression;
+          /// Is the query absolute?
+          bool is_absolute;
+          /// Location steps.
+          std::vector<Step> steps;
+          /// Steps using the descendant axis.
+          state_type descendants;
+          /// Final attribute name (null if selecting elements).
+          const Name *attribute;
+        };
+
+      }
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_DOM_QUERY_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
@@ -47,6 +47,7 @@
 
 #include <string>
 #include <stdexcept>
+#include <utility>
 
 namespace ome
 {
@@ -88,6 +89,28 @@ namespace ome
           {
           }
 
+          /**
+           * Copy construct a Wrapper.
+           *
+           * @param rhs the Wrapper to copy.
+           */
+          Wrapper (const Wrapper& rhs) = default;
+
+          /**
+           * Move construct a Wrapper.
+           *
+           * The wrapped value is transferred without a type check or
+           * reference count update; @c rhs is left null.
+           *
+           * @param rhs the Wrapper to move.
+           */
+          Wrapper (Wrapper&& rhs) noexcept:
+            parent_type(std::move(rhs)),
+            wrapped(rhs.wrapped)
+          {
+            rhs.wrapped = nullptr;
+          }
+
           /**
            * Copy construct a Wrapper.
            *
@@ -211,6 +234,24 @@ namespace ome
             return *this;
           }
 
+          /**
+           * Move assign a Wrapper.
+           *
+           * The wrapped value is transferred without a type check or
+           * reference count update; @c rhs is left null.
+           *
+           * @param rhs the Wrapper to move.
+           * @returns the Wrapper.
+           */
+          Wrapper&
+          operator= (Wrapper&& rhs) noexcept
+          {
+            parent_type::operator=(std::move(rhs));
+            wrapped = rhs.wrapped;
+            rhs.wrapped = nullptr;
+            return *this;
+          }
+
           /**
            * Dereference to element_type.
            *
@@ -0,0 +1,300 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_SAX_HANDLER_H
+#define OME_COMMON_XML_SAX_HANDLER_H
+
+#include <ome/common/config.h>
+
+#include <cstddef>
+
+#include <xercesc/sax2/Attributes.hpp>
+
+#include <ome/common/xml/StringView.h>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      /**
+       * Simple API for XML (SAX) streaming parser.
+       */
+      namespace sax
+      {
+
+        /**
+         * Element attributes.
+         *
+         * A lightweight wrapper around the Xerces attribute list
+         * passed to Handler::startElement().  All names and values
+         * are returned as StringView, and are only valid for the
+         * duration of the callback.
+         */
+        class Attributes
+        {
+        public:
+          /**
+           * Construct from Xerces attributes.
+           *
+           * @param attributes the attributes to wrap.
+           */
+          explicit
+          Attributes(const xercesc::Attributes& attributes):
+            attributes(attributes)
+          {
+          }
+
+          /**
+           * Get the number of attributes.
+           *
+           * @returns the number of attributes.
+           */
+          std::size_t
+          size() const
+          {
+            return attributes.getLength();
+          }
+
+          /**
+           * Get the namespace URI of an attribute.
+           *
+           * @param index the attribute index.
+           * @returns the namespace URI (empty if none).
+           */
+          StringView
+          uri(std::size_t index) const
+          {
+            return StringView(attributes.getURI(index));
+          }
+
+          /**
+           * Get the local name of an attribute.
+           *
+           * @param index the attribute index.
+           * @returns the local name.
+           */
+          StringView
+          localName(std::size_t index) const
+          {
+            return StringView(attributes.getLocalName(index));
+          }
+
+          /**
+           * Get the qualified name of an attribute.
+           *
+           * @param index the attribute index.
+           * @returns the qualified name.
+           */
+          StringView
+          qName(std::size_t index) const
+          {
+            return StringView(attributes.getQName(index));
+          }
+
+          /**
+           * Get the value of an attribute.
+           *
+           * @param index the attribute index.
+           * @returns the value.
+           */
+          StringView
+          value(std::size_t index) const
+          {
+            return StringView(attributes.getValue(index));
+          }
+
+          /**
+           * Check if an attribute is present.
+           *
+           * @param qname the qualified name of the attribute.
+           * @returns @c true if present, @c false otherwise.
+           */
+          bool
+          has(const char *qname) const
+          {
+            return find(qname) < size();
+          }
+
+          /**
+           * Get the value of an attribute by name.
+           *
+           * This is not an overload of value(std::size_t), so that
+           * @c value(0) is not ambiguous.
+           *
+           * @param qname the qualified name of the attribute.
+           * @returns the value, or an empty view if not present.
+           */
+          StringView
+          get(const char *qname) const
+          {
+            std::size_t index = find(qname);
+            return index < size() ? value(index) : StringView();
+          }
+
+        private:
+          /**
+           * Find an attribute by name.
+           *
+           * @param qname the qualified name of the attribute.
+           * @returns the attribute index, or size() if not present.
+           */
+          std::size_t
+          find(const char *qname) const
+          {
+            const std::size_t count = size();
+            for (std::size_t i = 0; i < count; ++i)
+              {
+                if (qName(i) == qname)
+                  return i;
+              }
+            return count;
+          }
+
+          /// The wrapped attributes.
+          const xercesc::Attributes& attributes;
+        };
+
+        /**
+         * Streaming parser event handler.
+         *
+         * Derive from this class and override the callbacks of
+         * interest, then pass to Reader::parse().  All callbacks do
+         * nothing by default.  The StringView and Attributes arguments
+         * refer to parser-owned storage, and are only valid for the
+         * duration of the callback; copy them with StringView::str()
+         * if they are needed afterwards.
+         *
+         * Exceptions thrown by a callback abort the parse and are
+         * propagated to the caller of Reader::parse().
+         */
+        class Handler
+        {
+        public:
+          /// Destructor.
+          virtual
+          ~Handler()
+          {
+          }
+
+          /**
+           * Start of document.
+           */
+          virtual
+          void
+          startDocument()
+          {
+          }
+
+          /**
+           * End of document.
+           */
+          virtual
+          void
+          endDocument()
+          {
+          }
+
+          /**
+           * Start of element.
+           *
+           * @param uri the namespace URI (empty if none).
+           * @param localName the local name of the element.
+           * @param qName the qualified name of the element.
+           * @param attributes the element attributes.
+           */
+          virtual
+          void
+          startElement(const StringView& uri,
+                       const StringView& localName,
+                       const StringView& qName,
+                       const Attributes& attributes)
+          {
+            static_cast<void>(uri);
+            static_cast<void>(localName);
+            static_cast<void>(qName);
+            static_cast<void>(attributes);
+          }
+
+          /**
+           * End of element.
+           *
+           * @param uri the namespace URI (empty if none).
+           * @param localName the local name of the element.
+           * @param qName the qualified name of the element.
+           */
+          virtual
+          void
+          endElement(const StringView& uri,
+                     const StringView& localName,
+                     const StringView& qName)
+          {
+            static_cast<void>(uri);
+            static_cast<void>(localName);
+            static_cast<void>(qName);
+          }
+
+          /**
+           * Character data.
+           *
+           * The content of an element may be split across several
+           * calls.
+           *
+           * @param chars the character data.
+           */
+          virtual
+          void
+          characters(const StringView& chars)
+          {
+            static_cast<void>(chars);
+          }
+        };
+
+      }
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_SAX_HANDLER_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
@@ -0,0 +1,227 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#include <stdexcept>
+
+#include <ome/common/xml/InputSource.h>
+#include <ome/common/xml/String.h>
+#include <ome/common/xml/sax/Reader.h>
+
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace sax
+      {
+
+        namespace detail
+        {
+
+          /**
+           * Forward Xerces SAX2 content events to a Handler.
+           */
+          class HandlerAdapter : public xercesc::DefaultHandler
+          {
+          public:
+            /// Constructor.
+            HandlerAdapter():
+              handler(0)
+            {
+            }
+
+            /// The handler to forward events to.
+            Handler *handler;
+
+            void
+            startDocument()
+            {
+              handler->startDocument();
+            }
+
+            void
+            endDocument()
+            {
+              handler->endDocument();
+            }
+
+            void
+            startElement(const XMLCh * const       uri,
+                         const XMLCh * const       localname,
+                         const XMLCh * const       qname,
+                         const xercesc::Attributes& attrs)
+            {
+              handler->startElement(StringView(uri),
+                                    StringView(localname),
+                                    StringView(qname),
+                                    Attributes(attrs));
+            }
+
+            void
+            endElement(const XMLCh * const uri,
+                       const XMLCh * const localname,
+                       const XMLCh * const qname)
+            {
+              handler->endElement(StringView(uri),
+                                  StringView(localname),
+                                  StringView(qname));
+            }
+
+            void
+            characters(const XMLCh * const chars,
+                       const XMLSize_t     length)
+            {
+              handler->characters(StringView(chars, length));
+            }
+          };
+
+        }
+
+        Reader::Reader(EntityResolver&             resolver,
+                       const dom::ParseParameters& params):
+          xmlplat(),
+          resolver(resolver),
+          reporter(),
+          adapter(new detail::HandlerAdapter()),
+          reader(xercesc::XMLReaderFactory::createXMLReader())
+        {
+          init(params);
+        }
+
+        Reader::Reader(EntityResolver&             resolver,
+                       GrammarPool&                pool,
+                       const dom::ParseParameters& params):
+          xmlplat(),
+          resolver(resolver),
+          reporter(),
+          adapter(new detail::HandlerAdapter()),
+          reader(xercesc::XMLReaderFactory::createXMLReader(xercesc::XMLPlatformUtils::fgMemoryManager,
+                                                            pool.get()))
+        {
+          reader->setFeature(xercesc::XMLUni::fgXercesUseCachedGrammarInParse, true);
+          // A locked pool is immutable.
+          reader->setFeature(xercesc::XMLUni::fgXercesCacheGrammarFromParse, !pool.locked());
+          init(params);
+        }
+
+        Reader::~Reader()
+        {
+        }
+
+        void
+        Reader::init(const dom::ParseParameters& params)
+        {
+          reader->setContentHandler(adapter.get());
+          reader->setErrorHandler(&reporter);
+          reader->setXMLEntityResolver(&resolver);
+
+          switch (params.validationScheme)
+            {
+            case xercesc::XercesDOMParser::Val_Never:
+              reader->setFeature(xercesc::XMLUni::fgSAX2CoreValidation, false);
+              break;
+            case xercesc::XercesDOMParser::Val_Always:
+              reader->setFeature(xercesc::XMLUni::fgSAX2CoreValidation, true);
+              reader->setFeature(xercesc::XMLUni::fgXercesDynamic, false);
+              break;
+            case xercesc::XercesDOMParser::Val_Auto:
+            default:
+              reader->setFeature(xercesc::XMLUni::fgSAX2CoreValidation, true);
+              reader->setFeature(xercesc::XMLUni::fgXercesDynamic, true);
+              break;
+            }
+          reader->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpaces, params.doNamespaces);
+          reader->setFeature(xercesc::XMLUni::fgXercesSchema, params.doSchema);
+          reader->setFeature(xercesc::XMLUni::fgXercesHandleMultipleImports, params.handleMultipleImports);
+          reader->setFeature(xercesc::XMLUni::fgXercesSchemaFullChecking, params.validationSchemaFullChecking);
+        }
+
+        void
+        Reader::parse(const boost::filesystem::path& file,
+                      Handler&                       handler)
+        {
+          MappedFileInputSource source(file);
+
+          parse(source, handler);
+        }
+
+        void
+        Reader::parse(const std::string& text,
+                      Handler&           handler,
+                      const std::string& id)
+        {
+          xercesc::MemBufInputSource source(reinterpret_cast<const XMLByte *>(text.c_str()),
+                                            static_cast<XMLSize_t>(text.size()),
+                                            String(id));
+
+          parse(source, handler);
+        }
+
+        void
+        Reader::parse(std::istream&      stream,
+                      Handler&           handler,
+                      const std::string& id)
+        {
+          StreamInputSource source(stream, id);
+
+          parse(source, handler);
+        }
+
+        void
+        Reader::parse(xercesc::InputSource& source,
+                      Handler&              handler)
+        {
+          reporter.resetErrors();
+          adapter->handler = &handler;
+
+          reader->parse(source);
+
+          if (reporter)
+            throw std::runtime_error("Parse error");
+        }
+
+      }
+    }
+  }
+}
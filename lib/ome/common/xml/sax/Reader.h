@@ -0,0 +1,209 @@
+/*
+ * #%L
+ * OME-XERCES C++ library for working with Xerces C++.
+ * %%
+ * Copyright © 2026 Open Microscopy Environment:
+ *   - Massachusetts Institute of Technology
+ *   - National Institutes of Health
+ *   - University of Dundee
+ *   - Board of Regents of the University of Wisconsin-Madison
+ *   - Glencoe Software, Inc.
+ * %%
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of any organization.
+ * #L%
+ */
+
+#ifndef OME_COMMON_XML_SAX_READER_H
+#define OME_COMMON_XML_SAX_READER_H
+
+#include <ome/common/config.h>
+
+#include <istream>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+
+#include <ome/common/xml/EntityResolver.h>
+#include <ome/common/xml/ErrorReporter.h>
+#include <ome/common/xml/GrammarPool.h>
+#include <ome/common/xml/Platform.h>
+#include <ome/common/xml/dom/Document.h>
+#include <ome/common/xml/sax/Handler.h>
+
+namespace ome
+{
+  namespace common
+  {
+    namespace xml
+    {
+      namespace sax
+      {
+
+        namespace detail
+        {
+          class HandlerAdapter;
+        }
+
+        /**
+         * Streaming XML reader.
+         *
+         * This wraps a Xerces SAX2 parser, and delivers parse events
+         * to a Handler as the document is read, without building a
+         * document tree.  Documents of any size may be read in
+         * constant memory.  Entities are resolved and errors reported
+         * in the same manner as when parsing a DOM Document, using the
+         * same parameters.  The reader may be reused to read any
+         * number of documents.
+         *
+         * @note A Reader is not thread-safe; use a separate instance
+         * in each thread.
+         */
+        class Reader
+        {
+        public:
+          /**
+           * Construct a Reader.
+           *
+           * @param resolver the EntityResolver to use; this must
+           * remain valid for the lifetime of the reader.
+           * @param params XML parser parameters.
+           */
+          Reader(EntityResolver&             resolver,
+                 const dom::ParseParameters& params = dom::ParseParameters());
+
+          /**
+           * Construct a Reader using cached grammars.
+           *
+           * @param resolver the EntityResolver to use; this must
+           * remain valid for the lifetime of the reader.
+           * @param pool the GrammarPool to use; this must remain valid
+           * for the lifetime of the reader.
+           * @param params XML parser parameters.
+           */
+          Reader(EntityResolver&             resolver,
+                 GrammarPool&                pool,
+                 const dom::ParseParameters& params = dom::ParseParameters());
+
+          /// Destructor.
+          ~Reader();
+
+          /// Copy constructor (deleted).
+          Reader(const Reader&) = delete;
+
+          /// Assignment operator (deleted).
+          Reader&
+          operator= (const Reader&) = delete;
+
+          /**
+           * Read a document from a file.
+           *
+           * The file is memory-mapped and parsed in place.
+           *
+           * @param file the file to read.
+           * @param handler the handler to receive parse events.
+           * @throws std::runtime_error if parsing fails.
+           */
+          void
+          parse(const boost::filesystem::path& file,
+                Handler&                       handler);
+
+          /**
+           * Read a document from a string.
+           *
+           * @param text the string to use.
+           * @param handler the handler to receive parse events.
+           * @param id document filename (for error reporting only).
+           * @throws std::runtime_error if parsing fails.
+           */
+          void
+          parse(const std::string& text,
+                Handler&           handler,
+                const std::string& id = "membuf");
+
+          /**
+           * Read a document from an input stream.
+           *
+           * The stream is read incrementally during parsing, and need
+           * not be seekable.
+           *
+           * @param stream the stream to read.
+           * @param handler the handler to receive parse events.
+           * @param id document filename (for error reporting only).
+           * @throws std::runtime_error if parsing fails.
+           */
+          void
+          parse(std::istream&      stream,
+                Handler&           handler,
+                const std::string& id = "streambuf");
+
+          /**
+           * Read a document from a Xerces input source.
+           *
+           * @param source the input source to read.
+           * @param handler the handler to receive parse events.
+           * @throws std::runtime_error if parsing fails.
+           */
+          void
+          parse(xercesc::InputSource& source,
+                Handler&              handler);
+
+        private:
+          /**
+           * Set up the reader handlers and features.
+           *
+           * @param params XML parser parameters.
+           */
+          void
+          init(const dom::ParseParameters& params);
+
+          /// Xerces platform (declared first, so destroyed last).
+          Platform xmlplat;
+          /// Entity resolver.
+          EntityResolver& resolver;
+          /// Error reporter.
+          ErrorReporter reporter;
+          /// Handler adaptor.
+          std::unique_ptr<detail::HandlerAdapter> adapter;
+          /// The reader.
+          std::unique_ptr<xercesc::SAX2XMLReader> reader;
+        };
+
+      }
+    }
+  }
+}
+
+#endif // OME_COMMON_XML_SAX_READER_H
+
+/*
+ * Local Variables:
+ * mode:C++
+ * End:
+ */
@@ -37,10 +37,20 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <thread>
 #include <vector>
 
 #include <ome/common/base64.h>
+#include <ome/common/base64/filter.h>
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 
 #include <ome/test/test.h>
 
@@ -159,6 +169,674 @@ TEST(Base64Test, LookupRoundTrip)
     }
 }
 
+namespace
+{
+
+  std::vector<uint8_t>
+  random_bytes(std::size_t size)
+  {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> data(size);
+    for (auto& byte : data)
+      byte = static_cast<uint8_t>(dist(gen));
+    return data;
+  }
+
+  const ome::common::detail::base64_kernel kernels[] =
+    {
+      ome::common::detail::base64_kernel::SCALAR,
+      ome::common::detail::base64_kernel::SSE41,
+      ome::common::detail::base64_kernel::AVX2
+    };
+
+}
+
+TEST(Base64Test, KernelConsistency)
+{
+  namespace detail = ome::common::detail;
+
+  std::vector<uint8_t> data(random_bytes(300));
+
+  for (auto kernel : kernels)
+    {
+      if (!detail::base64_kernel_supported(kernel))
+        continue;
+
+      for (std::size_t size = 0; size < data.size(); ++size)
+        {
+          std::string expected(((size / 3) * 4), '\0');
+          std::string encoded(((size / 3) * 4), '\0');
+          ASSERT_EQ(expected.size(),
+                    detail::base64_encode_block(detail::base64_kernel::SCALAR, data.data(), size, &expected[0]));
+          ASSERT_EQ(encoded.size(),
+                    detail::base64_encode_block(kernel, data.data(), size, &encoded[0]));
+          ASSERT_EQ(expected, encoded);
+
+          std::vector<uint8_t> decoded((size / 3) * 3);
+          ASSERT_EQ(encoded.size(),
+                    detail::base64_decode_block(kernel, encoded.data(), encoded.size(), decoded.data()));
+          ASSERT_TRUE(std::equal(decoded.begin(), decoded.end(), data.begin()));
+        }
+    }
+}
+
+TEST(Base64Test, KernelStopsAtNonAlphabet)
+{
+  namespace detail = ome::common::detail;
+
+  std::vector<uint8_t> data(random_bytes(96));
+  std::string encoded = ome::common::base64_encode(data.begin(), data.end(), 0);
+
+  for (auto kernel : kernels)
+    {
+      if (!detail::base64_kernel_supported(kernel))
+        continue;
+
+      for (int c = 0; c < 256; ++c)
+        {
+          bool valid = std::isalnum(c) || c == '+' || c == '/';
+          for (std::size_t pos = 0; pos < encoded.size(); pos += 5)
+            {
+              std::string modified(encoded);
+              modified[pos] = static_cast<char>(c);
+              std::vector<uint8_t> decoded(data.size());
+              std::size_t consumed = detail::base64_decode_block(kernel, modified.data(), modified.size(), decoded.data());
+              if (valid && c < 128)
+                ASSERT_EQ(modified.size(), consumed);
+              else
+                ASSERT_EQ((pos / 4) * 4, consumed);
+            }
+        }
+    }
+}
+
+TEST(Base64Test, EncodeContiguous)
+{
+  std::vector<uint8_t> data(random_bytes(10000));
+
+  for (std::size_t size : {0, 1, 2, 3, 56, 57, 58, 1000, 9999, 10000})
+    {
+      for (uint8_t linebreak : {0, 1, 7, 64, 76, 255})
+        {
+          std::deque<uint8_t> generic(data.begin(), data.begin() + size);
+          std::string expected = ome::common::base64_encode(generic.begin(), generic.end(), linebreak);
+          std::string result = ome::common::base64_encode(data.begin(), data.begin() + size, linebreak);
+          ASSERT_EQ(expected, result);
+
+          std::vector<uint8_t> decoded = ome::common::base64_decode<std::vector<uint8_t>>(result);
+          ASSERT_TRUE(std::equal(decoded.begin(), decoded.end(), data.begin()));
+          ASSERT_EQ(size, decoded.size());
+        }
+    }
+}
+
+namespace
+{
+
+  // Encode in chunks of the specified input and output sizes.
+  std::string
+  stream_encode(const std::vector<uint8_t>& data,
+                uint8_t                     linebreak,
+                std::size_t                 in_chunk,
+                std::size_t                 out_chunk)
+  {
+    ome::common::base64_encoder encoder(linebreak);
+    std::string encoded;
+    std::vector<char> buf(out_chunk);
+    const uint8_t *in = data.data();
+    const uint8_t *end = data.data() + data.size();
+    while (in != end)
+      {
+        const uint8_t *chunk_end = in + std::min(in_chunk, static_cast<std::size_t>(end - in));
+        while (in != chunk_end)
+          {
+            char *out = buf.data();
+            encoder.encode(in, chunk_end, out, buf.data() + buf.size());
+            encoded.append(buf.data(), out);
+          }
+      }
+    bool done = false;
+    while (!done)
+      {
+        char *out = buf.data();
+        done = encoder.finish(out, buf.data() + buf.size());
+        encoded.append(buf.data(), out);
+      }
+    return encoded;
+  }
+
+  // Decode in chunks of the specified input and output sizes.
+  std::vector<uint8_t>
+  stream_decode(const std::string& encoded,
+                std::size_t        in_chunk,
+                std::size_t        out_chunk)
+  {
+    ome::common::base64_decoder decoder;
+    std::vector<uint8_t> decoded;
+    std::vector<uint8_t> buf(out_chunk);
+    const char *in = encoded.data();
+    const char *end = encoded.data() + encoded.size();
+    while (in != end)
+      {
+        const char *chunk_end = in + std::min(in_chunk, static_cast<std::size_t>(end - in));
+        while (in != chunk_end)
+          {
+            uint8_t *out = buf.data();
+            decoder.decode(in, chunk_end, out, buf.data() + buf.size());
+            decoded.insert(decoded.end(), buf.data(), out);
+          }
+      }
+    bool done = false;
+    while (!done)
+      {
+        uint8_t *out = buf.data();
+        done = decoder.finish(out, buf.data() + buf.size());
+        decoded.insert(decoded.end(), buf.data(), out);
+      }
+    return decoded;
+  }
+
+  const std::size_t chunk_sizes[] = {1, 2, 3, 4, 5, 7, 64, 1000, 100000};
+
+}
+
+TEST(Base64Test, StreamEncode)
+{
+  for (std::size_t size : {0, 1, 2, 3, 57, 58, 59, 1000, 10000})
+    {
+      std::vector<uint8_t> data(random_bytes(size));
+      for (uint8_t linebreak : {0, 1, 7, 76})
+        {
+          std::string expected = ome::common::base64_encode(data.begin(), data.end(), linebreak);
+          for (std::size_t in_chunk : chunk_sizes)
+            for (std::size_t out_chunk : chunk_sizes)
+              ASSERT_EQ(expected, stream_encode(data, linebreak, in_chunk, out_chunk))
+                << "size=" << size << " linebreak=" << static_cast<int>(linebreak)
+                << " in=" << in_chunk << " out=" << out_chunk;
+        }
+    }
+}
+
+TEST(Base64Test, StreamDecode)
+{
+  for (std::size_t size : {0, 1, 2, 3, 57, 58, 59, 1000, 10000})
+    {
+      std::vector<uint8_t> data(random_bytes(size));
+      for (uint8_t linebreak : {0, 1, 7, 76})
+        {
+          std::string encoded = ome::common::base64_encode(data.begin(), data.end(), linebreak);
+          for (std::size_t in_chunk : chunk_sizes)
+            for (std::size_t out_chunk : chunk_sizes)
+              ASSERT_EQ(data, stream_decode(encoded, in_chunk, out_chunk))
+                << "size=" << size << " linebreak=" << static_cast<int>(linebreak)
+                << " in=" << in_chunk << " out=" << out_chunk;
+        }
+    }
+}
+
+TEST(Base64Test, StreamDecodeFail)
+{
+  for (const char *invalid : {"Invalid ", "$#Invalid", "VGVzdCBwYWRkaW5nLQ==VGVzdCBwYWRkaW5nLQ==",
+                              "VGVzdCBwYWRkaW5nLQ==  =AAA", "VGVzdCBwYWRkaW5nLQ"})
+    {
+      std::string expected;
+      try
+        {
+          ome::common::base64_decode<std::vector<uint8_t>>(invalid);
+        }
+      catch (const std::runtime_error& e)
+        {
+          expected = e.what();
+        }
+      ASSERT_FALSE(expected.empty());
+
+      for (std::size_t in_chunk : chunk_sizes)
+        {
+          std::string message;
+          try
+            {
+              stream_decode(invalid, in_chunk, 2);
+            }
+          catch (const std::runtime_error& e)
+            {
+              message = e.what();
+            }
+          ASSERT_EQ(expected, message);
+        }
+    }
+}
+
+TEST(Base64Test, StreamReset)
+{
+  std::vector<uint8_t> data(random_bytes(100));
+  std::string expected = ome::common::base64_encode(data.begin(), data.end());
+
+  ome::common::base64_encoder encoder;
+  std::vector<char> buf(expected.size());
+  for (int i = 0; i < 2; ++i)
+    {
+      const uint8_t *in = data.data() + 1;
+      char *out = buf.data();
+      encoder.encode(in, data.data() + data.size(), out, buf.data() + buf.size());
+      encoder.reset();
+      in = data.data();
+      out = buf.data();
+      encoder.encode(in, data.data() + data.size(), out, buf.data() + buf.size());
+      ASSERT_TRUE(encoder.finish(out, buf.data() + buf.size()));
+      ASSERT_EQ(expected, std::string(buf.data(), out));
+      encoder.reset();
+    }
+}
+
+TEST(Base64Test, FilterEncode)
+{
+  std::vector<uint8_t> data(random_bytes(100000));
+  std::string expected = ome::common::base64_encode(data.begin(), data.end());
+
+  std::string encoded;
+  {
+    boost::iostreams::filtering_ostream out;
+    out.push(ome::common::base64_encode_filter(76, 100));
+    out.push(boost::iostreams::back_inserter(encoded));
+    out.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+  }
+  ASSERT_EQ(expected, encoded);
+
+  std::string encoded2;
+  {
+    boost::iostreams::filtering_istream in;
+    in.push(ome::common::base64_encode_filter(0));
+    in.push(boost::iostreams::array_source(reinterpret_cast<const char *>(data.data()), data.size()));
+    encoded2.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  ASSERT_EQ(ome::common::base64_encode(data.begin(), data.end(), 0), encoded2);
+}
+
+TEST(Base64Test, FilterDecode)
+{
+  std::vector<uint8_t> data(random_bytes(100000));
+  std::string encoded = ome::common::base64_encode(data.begin(), data.end());
+
+  std::vector<uint8_t> decoded(data.size());
+  {
+    boost::iostreams::filtering_istream in;
+    in.push(ome::common::base64_decode_filter(100));
+    in.push(boost::iostreams::array_source(encoded.data(), encoded.size()));
+    in.read(reinterpret_cast<char *>(decoded.data()), static_cast<std::streamsize>(decoded.size()));
+    ASSERT_EQ(static_cast<std::streamsize>(decoded.size()), in.gcount());
+    ASSERT_EQ(std::char_traits<char>::eof(), in.get());
+  }
+  ASSERT_EQ(data, decoded);
+
+  std::string decoded2;
+  {
+    boost::iostreams::filtering_ostream out;
+    out.push(ome::common::base64_decode_filter());
+    out.push(boost::iostreams::back_inserter(decoded2));
+    out << encoded;
+  }
+  ASSERT_EQ(std::string(data.begin(), data.end()), decoded2);
+}
+
+TEST_P(Base64Test, DecodeInto)
+{
+  const Base64TestParameters& params = GetParam();
+
+  std::vector<uint8_t> expected(reinterpret_cast<const uint8_t *>(params.data),
+                                reinterpret_cast<const uint8_t *>(params.data + std::strlen(params.data)));
+
+  for (const char *encoded : {params.encoded_data_exact, params.encoded_data_inexact})
+    {
+      std::size_t size = ome::common::base64_decoded_size(encoded, std::strlen(encoded));
+      ASSERT_EQ(expected.size(), size);
+
+      std::vector<uint8_t> result(size);
+      ASSERT_EQ(size, ome::common::base64_decode_into(encoded, std::strlen(encoded),
+                                                      result.data(), result.size()));
+      ASSERT_EQ(expected, result);
+
+      ASSERT_THROW(ome::common::base64_decode_into(encoded, std::strlen(encoded),
+                                                   result.data(), result.size() - 1),
+                   std::runtime_error);
+    }
+}
+
+TEST(Base64Test, DecodedSize)
+{
+  ASSERT_EQ(0U, ome::common::base64_decoded_size("", 0));
+  ASSERT_EQ(0U, ome::common::base64_decoded_size(" \r\n\t", 4));
+
+  for (std::size_t size : {0, 1, 2, 3, 57, 58, 59, 1000, 10000})
+    {
+      std::vector<uint8_t> data(random_bytes(size));
+      for (uint8_t linebreak : {0, 1, 7, 76})
+        {
+          std::string encoded = ome::common::base64_encode(data.begin(), data.end(), linebreak);
+          encoded += " \r\n";
+          ASSERT_EQ(size, ome::common::base64_decoded_size(encoded.data(), encoded.size()));
+        }
+    }
+}
+
+TEST(Base64Test, DecodeIntoFail)
+{
+  uint8_t buf[64];
+
+  // Premature end of input.
+  ASSERT_THROW(ome::common::base64_decode_into("Invalid ", 8, buf, sizeof(buf)), std::runtime_error);
+
+  // Invalid characters.
+  ASSERT_THROW(ome::common::base64_decode_into("$#Invalid", 9, buf, sizeof(buf)), std::runtime_error);
+
+  // Data after padding.
+  ASSERT_THROW(ome::common::base64_decode_into("VGVzdCBwYWRkaW5nLQ==VGVzdCBwYWRkaW5nLQ==", 40, buf, sizeof(buf)), std::runtime_error);
+
+  // Insufficient space, with trailing whitespace.
+  ASSERT_EQ(3U, ome::common::base64_decode_into("VGVz\n", 5, buf, 3));
+  ASSERT_THROW(ome::common::base64_decode_into("VGVzdA==", 8, buf, 3), std::runtime_error);
+  ASSERT_THROW(ome::common::base64_decode_into("VGVz", 4, nullptr, 0), std::runtime_error);
+}
+
+TEST(Base64Test, DecodeParallel)
+{
+  for (std::size_t size : {0, 100, 200000, 1000000, 1000001, 1000002})
+    {
+      std::vector<uint8_t> data(random_bytes(size));
+      for (uint8_t linebreak : {0, 1, 7, 76})
+        {
+          std::string encoded = ome::common::base64_encode(data.begin(), data.end(), linebreak);
+          for (unsigned int threads : {0U, 1U, 2U, 3U, 7U, 16U})
+            {
+              std::vector<uint8_t> result(size + 10);
+              ASSERT_EQ(size, ome::common::base64_decode_parallel(encoded.data(), encoded.size(),
+                                                                  result.data(), result.size(), threads));
+              result.resize(size);
+              ASSERT_EQ(data, result)
+                << "size=" << size << " linebreak=" << static_cast<int>(linebreak)
+                << " threads=" << threads;
+            }
+        }
+    }
+}
+
+TEST(Base64Test, DecodeParallelFail)
+{
+  std::vector<uint8_t> data(random_bytes(1000000));
+  std::string encoded = ome::common::base64_encode(data.begin(), data.end());
+
+  std::vector<std::string> invalid;
+  // Invalid character.
+  invalid.push_back(encoded);
+  invalid.back()[encoded.size() / 2] = '$';
+  // Padding before the end.
+  invalid.push_back(encoded);
+  invalid.back().insert(encoded.size() / 3, "AA==");
+  // Padding before the end, followed only by whitespace.
+  invalid.push_back(encoded.substr(0, encoded.size() / 4) + "AA==" + std::string(encoded.size(), '\n'));
+  // Premature end of input.
+  invalid.push_back(encoded.substr(0, encoded.size() - 2));
+  // Insufficient space.
+  invalid.push_back(encoded);
+
+  for (const auto& input : invalid)
+    {
+      std::vector<uint8_t> expected(data.size() - 1);
+      std::string expected_message;
+      std::size_t expected_size = 0U;
+      try
+        {
+          expected_size = ome::common::base64_decode_into(input.data(), input.size(),
+                                                          expected.data(), expected.size());
+        }
+      catch (const std::runtime_error& e)
+        {
+          expected_message = e.what();
+        }
+
+      for (unsigned int threads : {2U, 4U, 7U})
+        {
+          std::vector<uint8_t> result(data.size() - 1);
+          std::string message;
+          std::size_t size = 0U;
+          try
+            {
+              size = ome::common::base64_decode_parallel(input.data(), input.size(),
+                                                         result.data(), result.size(), threads);
+            }
+          catch (const std::runtime_error& e)
+            {
+              message = e.what();
+            }
+          ASSERT_EQ(expected_message, message);
+          ASSERT_EQ(expected_size, size);
+          if (message.empty())
+            {
+              ASSERT_EQ(expected, result);
+            }
+        }
+    }
+}
+
+TEST(Base64Test, DISABLED_BenchmarkParallel)
+{
+  std::vector<uint8_t> data(random_bytes(256 * 1024 * 1024));
+  std::string encoded = ome::common::base64_encode(data.begin(), data.end());
+  std::vector<uint8_t> decoded(data.size());
+
+  unsigned int max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  for (unsigned int threads = 1U; threads <= max_threads; threads *= 2U)
+    {
+      auto start = std::chrono::steady_clock::now();
+      ome::common::base64_decode_parallel(encoded.data(), encoded.size(),
+                                          decoded.data(), decoded.size(), threads);
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::cout << "Decode (" << threads << " threads): "
+                << (data.size() / seconds) / (1024.0 * 1024.0) << " MiB/s" << std::endl;
+      ASSERT_EQ(data, decoded);
+    }
+}
+
+namespace
+{
+
+  template<typename Alphabet, typename Padding, typename Whitespace>
+  void
+  policy_round_trip()
+  {
+    for (std::size_t size : {0, 1, 2, 3, 56, 57, 58, 59, 114, 1000, 10000})
+      {
+        std::vector<uint8_t> data(random_bytes(size));
+        std::string encoded = ome::common::base64_encode<Alphabet, Padding, Whitespace>(data.begin(), data.end());
+
+        std::deque<uint8_t> generic(data.begin(), data.end());
+        ASSERT_EQ(encoded, (ome::common::base64_encode<Alphabet, Padding, Whitespace>(generic.begin(), generic.end())));
+
+        std::vector<uint8_t> decoded = ome::common::base64_decode<std::vector<uint8_t>, Alphabet, Padding, Whitespace>(encoded);
+        ASSERT_EQ(data, decoded) << "size=" << size;
+
+        std::deque<uint8_t> decoded_generic = ome::common::base64_decode<std::deque<uint8_t>, Alphabet, Padding, Whitespace>(encoded);
+        ASSERT_EQ(generic, decoded_generic) << "size=" << size;
+
+        std::vector<uint8_t> decoded_into(ome::common::base64_decoded_size(encoded.data(), encoded.size()));
+        ASSERT_EQ(size, (ome::common::base64_decode_into<Alphabet, Padding, Whitespace>(encoded.data(), encoded.size(),
+                                                                                       decoded_into.data(), decoded_into.size())));
+        ASSERT_EQ(data, decoded_into) << "size=" << size;
+      }
+  }
+
+}
+
+TEST(Base64Test, PolicyRoundTrip)
+{
+  using namespace ome::common;
+
+  policy_round_trip<base64_standard_alphabet, base64_padding_required, base64_whitespace_none>();
+  policy_round_trip<base64_standard_alphabet, base64_padding_required, base64_whitespace_mime>();
+  policy_round_trip<base64_standard_alphabet, base64_padding_required, base64_whitespace_any>();
+  policy_round_trip<base64_standard_alphabet, base64_padding_optional, base64_whitespace_none>();
+  policy_round_trip<base64_standard_alphabet, base64_padding_optional, base64_whitespace_mime>();
+  policy_round_trip<base64_standard_alphabet, base64_padding_optional, base64_whitespace_any>();
+  policy_round_trip<base64_url_alphabet, base64_padding_required, base64_whitespace_none>();
+  policy_round_trip<base64_url_alphabet, base64_padding_required, base64_whitespace_mime>();
+  policy_round_trip<base64_url_alphabet, base64_padding_required, base64_whitespace_any>();
+  policy_round_trip<base64_url_alphabet, base64_padding_optional, base64_whitespace_none>();
+  policy_round_trip<base64_url_alphabet, base64_padding_optional, base64_whitespace_mime>();
+  policy_round_trip<base64_url_alphabet, base64_padding_optional, base64_whitespace_any>();
+}
+
+TEST(Base64Test, PolicyEncode)
+{
+  using namespace ome::common;
+
+  const uint8_t data[] = {0xFB, 0xFF, 0xBF, 0xFB, 0xFF};
+
+  ASSERT_EQ(std::string("+/+/+/8="), base64_encode<base64_standard_alphabet>(data, data + 5));
+  ASSERT_EQ(std::string("+/+/+/8"), (base64_encode<base64_standard_alphabet, base64_padding_optional>(data, data + 5)));
+  ASSERT_EQ(std::string("-_-_-_8="), base64_encode<base64_url_alphabet>(data, data + 5));
+  ASSERT_EQ(std::string("-_-_-_8"), (base64_encode<base64_url_alphabet, base64_padding_optional>(data, data + 5)));
+  ASSERT_EQ(std::string("-_-_-w"), (base64_encode<base64_url_alphabet, base64_padding_optional>(data, data + 4)));
+  ASSERT_EQ(std::string("-_-_-w=="), base64_encode<base64_url_alphabet>(data, data + 4));
+}
+
+TEST(Base64Test, PolicyLayout)
+{
+  using namespace ome::common;
+
+  for (std::size_t size : {0, 1, 56, 57, 58, 114, 1000})
+    {
+      std::vector<uint8_t> data(random_bytes(size));
+
+      // No line breaks.
+      ASSERT_EQ(base64_encode(data.begin(), data.end(), 0),
+                base64_encode<base64_standard_alphabet>(data.begin(), data.end()));
+
+      // Line breaks between (but not after) lines of 76 characters.
+      std::string expected = base64_encode(data.begin(), data.end(), 0);
+      std::string lf, crlf;
+      for (std::size_t pos = 0; pos < expected.size(); pos += 76)
+        {
+          if (pos)
+            {
+              lf += "\n";
+              crlf += "\r\n";
+            }
+          lf += expected.substr(pos, 76);
+          crlf += expected.substr(pos, 76);
+        }
+      ASSERT_EQ(lf, (base64_encode<base64_standard_alphabet, base64_padding_required, base64_whitespace_any>(data.begin(), data.end())));
+      ASSERT_EQ(crlf, (base64_encode<base64_standard_alphabet, base64_padding_required, base64_whitespace_mime>(data.begin(), data.end())));
+
+      // MIME permits a trailing line break.
+      ASSERT_EQ(data, (base64_decode<std::vector<uint8_t>, base64_standard_alphabet,
+                       base64_padding_required, base64_whitespace_mime>(crlf + "\r\n")));
+    }
+}
+
+TEST(Base64Test, PolicyDecodeFail)
+{
+  using namespace ome::common;
+
+  typedef std::vector<uint8_t> bytes;
+
+  // No whitespace permitted.
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_required, base64_whitespace_none>("VGVz\ndA==")), std::runtime_error);
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_required, base64_whitespace_none>("VGVzdA== ")), std::runtime_error);
+  ASSERT_EQ(bytes({'T', 'e', 's', 't'}), (base64_decode<bytes, base64_standard_alphabet, base64_padding_required, base64_whitespace_any>("VGVz\ndA== ")));
+
+  // Padding required.
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_required, base64_whitespace_none>("VGVzdA")), std::runtime_error);
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_required, base64_whitespace_any>("VGVzdA=")), std::runtime_error);
+  ASSERT_EQ(bytes({'T', 'e', 's', 't'}), (base64_decode<bytes, base64_standard_alphabet, base64_padding_optional, base64_whitespace_none>("VGVzdA")));
+  ASSERT_EQ(bytes({'T', 'e', 's', 't'}), (base64_decode<bytes, base64_standard_alphabet, base64_padding_optional, base64_whitespace_none>("VGVzdA==")));
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_optional, base64_whitespace_none>("VGVzdA=")), std::runtime_error);
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_optional, base64_whitespace_none>("VGVzd")), std::runtime_error);
+
+  // Padding only at end.
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_optional, base64_whitespace_none>("VG==VGVz")), std::runtime_error);
+  ASSERT_THROW((base64_decode<bytes, base64_url_alphabet, base64_padding_optional, base64_whitespace_any>("VG== VGVz")), std::runtime_error);
+
+  // Wrong alphabet.
+  ASSERT_THROW((base64_decode<bytes, base64_url_alphabet, base64_padding_required, base64_whitespace_none>("+/8=")), std::runtime_error);
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_required, base64_whitespace_none>("-_8=")), std::runtime_error);
+  ASSERT_THROW((base64_decode<bytes, base64_url_alphabet, base64_padding_optional, base64_whitespace_none>("-_+")), std::runtime_error);
+
+  // Strict MIME line breaks.
+  std::vector<uint8_t> data(random_bytes(200));
+  std::string mime = base64_encode<base64_standard_alphabet, base64_padding_required, base64_whitespace_mime>(data.begin(), data.end());
+  std::string lf(mime);
+  lf.erase(std::remove(lf.begin(), lf.end(), '\r'), lf.end());
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_required, base64_whitespace_mime>(lf)), std::runtime_error);
+  std::string short_line(mime);
+  short_line.erase(10, 4);
+  ASSERT_THROW((base64_decode<bytes, base64_standard_alphabet, base64_padding_required, base64_whitespace_mime>(short_line)), std::runtime_error);
+
+  // Insufficient space.
+  uint8_t buf[3];
+  ASSERT_THROW((base64_decode_into<base64_standard_alphabet>("VGVzdA==", 8, buf, sizeof(buf))), std::runtime_error);
+}
+
+TEST(Base64Test, DISABLED_Benchmark)
+{
+  namespace detail = ome::common::detail;
+
+  std::vector<uint8_t> data(random_bytes(16 * 1024 * 1024));
+  std::string encoded = ome::common::base64_encode(data.begin(), data.end());
+  std::deque<uint8_t> generic(data.begin(), data.end());
+
+  auto report = [&](const char *name, std::chrono::steady_clock::duration elapsed)
+    {
+      double seconds = std::chrono::duration<double>(elapsed).count();
+      std::cout << name << ": " << (data.size() / seconds) / (1024.0 * 1024.0) << " MiB/s" << std::endl;
+    };
+
+  auto start = std::chrono::steady_clock::now();
+  std::string result = ome::common::base64_encode(generic.begin(), generic.end());
+  report("Encode (byte at a time)", std::chrono::steady_clock::now() - start);
+  ASSERT_EQ(encoded, result);
+
+  start = std::chrono::steady_clock::now();
+  result = ome::common::base64_encode(data.begin(), data.end());
+  report("Encode (block kernel)", std::chrono::steady_clock::now() - start);
+  ASSERT_EQ(encoded, result);
+
+  start = std::chrono::steady_clock::now();
+  std::vector<uint8_t> decoded = ome::common::base64_decode<std::vector<uint8_t>>(encoded);
+  report("Decode (block kernel)", std::chrono::steady_clock::now() - start);
+  ASSERT_EQ(data, decoded);
+
+  start = std::chrono::steady_clock::now();
+  std::vector<uint8_t> decoded_into(ome::common::base64_decoded_size(encoded.data(), encoded.size()));
+  ome::common::base64_decode_into(encoded.data(), encoded.size(), decoded_into.data(), decoded_into.size());
+  report("Decode (into buffer)", std::chrono::steady_clock::now() - start);
+  ASSERT_EQ(data, decoded_into);
+
+  std::string unbroken = ome::common::base64_encode(data.begin(), data.end(), 0);
+  start = std::chrono::steady_clock::now();
+  ome::common::base64_decode_into<ome::common::base64_standard_alphabet>(unbroken.data(), unbroken.size(),
+                                                                         decoded_into.data(), decoded_into.size());
+  report("Decode (into buffer, no whitespace policy)", std::chrono::steady_clock::now() - start);
+  ASSERT_EQ(data, decoded_into);
+
+  for (auto kernel : kernels)
+    {
+      if (!detail::base64_kernel_supported(kernel))
+        continue;
+
+      std::cout << "Kernel " << static_cast<int>(kernel) << std::endl;
+      std::string block((data.size() / 3) * 4, '\0');
+      start = std::chrono::steady_clock::now();
+      detail::base64_encode_block(kernel, data.data(), data.size(), &block[0]);
+      report("Encode kernel only", std::chrono::steady_clock::now() - start);
+
+      std::vector<uint8_t> blockdata((data.size() / 3) * 3);
+      start = std::chrono::steady_clock::now();
+      detail::base64_decode_block(kernel, block.data(), block.size(), blockdata.data());
+      report("Decode kernel only", std::chrono::steady_clock::now() - start);
+      ASSERT_TRUE(std::equal(blockdata.begin(), blockdata.end(), data.begin()));
+    }
+}
+
 Base64TestParameters params[] =
   {
     Base64TestParameters("Test Base64 Encoding",
@@ -36,21 +36,83 @@
  * #L%
  */
 
+#include <ome/common/xml/EmbeddedSchemas.h>
 #include <ome/common/xml/EntityResolver.h>
+#include <ome/common/xml/FormatTarget.h>
+#include <ome/common/xml/GrammarPool.h>
+#include <ome/common/xml/InputSource.h>
+#include <ome/common/xml/Name.h>
 #include <ome/common/xml/String.h>
+#include <ome/common/xml/StringView.h>
 #include <ome/common/xml/Platform.h>
 #include <ome/common/xml/dom/Document.h>
+#include <ome/common/xml/dom/DocumentParser.h>
+#include <ome/common/xml/dom/DocumentWriter.h>
+#include <ome/common/xml/dom/NodeRef.h>
+#include <ome/common/xml/dom/ParserCache.h>
+#include <ome/common/xml/dom/Query.h>
+#include <ome/common/xml/sax/Reader.h>
+
+#include <xercesc/util/TransService.hpp>
 
 #include <ome/test/config.h>
 
 #include <ome/test/test.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <fstream>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <boost/filesystem/operations.hpp>
+
 namespace xml = ome::common::xml;
 
+namespace
+{
+
+  // Number of heap allocations made by this program.
+  std::atomic<std::size_t> allocations(0);
+
+}
+
+// Count allocations, to check that operations which should not
+// allocate do not.
+void *
+operator new(std::size_t size)
+{
+  ++allocations;
+  void *ptr = std::malloc(size ? size : 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void *ptr,
+                std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
 class XercesTestParameters
 {
 public:
@@ -116,6 +178,25 @@ public:
   }
 };
 
+TEST(XercesPlatformTest, ConcurrentPlatform)
+{
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < 8; ++t)
+    {
+      threads.emplace_back([]()
+        {
+          for (int i = 0; i < 100; ++i)
+            {
+              xml::Platform plat;
+              xml::String s("test");
+              ASSERT_EQ(std::string("test"), s.str());
+            }
+        });
+    }
+  for (auto& thread : threads)
+    thread.join();
+}
+
 TEST(XercesStringTest, NativeUTF8)
 {
   xml::Platform plat;
@@ -189,6 +270,351 @@ TEST(XercesStringTest, StringWideFail)
   ASSERT_THROW(xml::String s(src), std::runtime_error);
 }
 
+TEST(XercesStringTest, StringSurrogatePair)
+{
+  xml::Platform plat;
+
+  const char src[] = { '\xF0', '\x9F', '\x98', '\x80', '\0' };
+
+  xml::String s(src);
+  const XMLCh *utf16 = s;
+
+  ASSERT_EQ(0xD83D, utf16[0]);
+  ASSERT_EQ(0xDE00, utf16[1]);
+  ASSERT_EQ(0x0, utf16[2]);
+
+  xml::String s2(utf16);
+  ASSERT_EQ(std::string(src), s2.str());
+}
+
+TEST(XercesStringTest, StringNarrowFail)
+{
+  xml::Platform plat;
+
+  // Unpaired high surrogate.
+  const XMLCh src[] = { 0xD800, 0x0041, 0x0 };
+
+  ASSERT_THROW(xml::String s(src), std::runtime_error);
+}
+
+TEST(XercesStringTest, StringLong)
+{
+  xml::Platform plat;
+
+  // Longer than the inline buffer.
+  std::string src(xml::String::inline_size * 4, 'x');
+  src += "\xC2\xB5";
+
+  xml::String s(src);
+  const XMLCh *utf16 = s;
+  ASSERT_EQ(0xB5, utf16[src.size() - 2]);
+  ASSERT_EQ(0x0, utf16[src.size() - 1]);
+  ASSERT_EQ(src, s.str());
+
+  xml::String s2(utf16);
+  ASSERT_EQ(src, s2.str());
+  ASSERT_TRUE(s == s2);
+
+  xml::String s3(s2);
+  ASSERT_EQ(src, s3.str());
+  ASSERT_TRUE(s3 == s);
+}
+
+TEST(XercesStringTest, StringFreeze)
+{
+  xml::Platform plat;
+
+  const xml::String s("shared \xC2\xB5");
+  s.freeze();
+  const XMLCh *wide = s;
+  const char *narrow = s.c_str();
+
+  // Once frozen, concurrent reads see the same storage.
+  std::vector<std::thread> threads;
+  std::atomic<std::size_t> failures(0);
+  for (unsigned int t = 0; t < 4; ++t)
+    {
+      threads.emplace_back([&]()
+        {
+          for (int i = 0; i < 100; ++i)
+            {
+              if (static_cast<const XMLCh *>(s) != wide || s.c_str() != narrow)
+                ++failures;
+            }
+        });
+    }
+  for (auto& thread : threads)
+    thread.join();
+  ASSERT_EQ(0U, failures);
+  ASSERT_EQ(std::string("shared \xC2\xB5"), s.str());
+}
+
+TEST(XercesStringTest, StringASCIIBoundaries)
+{
+  xml::Platform plat;
+
+  // Place a non-ASCII character at every position of strings
+  // spanning several vector blocks, to check the handover from the
+  // ASCII kernel to the general transcoding path.
+  for (std::size_t len = 1; len < 80; ++len)
+    for (std::size_t pos = 0; pos <= len; ++pos)
+      {
+        std::string utf8;
+        std::vector<XMLCh> utf16;
+        for (std::size_t i = 0; i < len; ++i)
+          {
+            if (i == pos)
+              {
+                utf8 += "\xC2\xB5";
+                utf16.push_back(0x00B5);
+              }
+            else
+              {
+                utf8 += static_cast<char>('a' + (i % 26));
+                utf16.push_back(static_cast<XMLCh>('a' + (i % 26)));
+              }
+          }
+        utf16.push_back(0x0);
+
+        xml::String s(utf8);
+        const XMLCh *converted = s;
+        ASSERT_TRUE(std::equal(utf16.begin(), utf16.end(), converted));
+
+        xml::String s2(&utf16[0]);
+        ASSERT_EQ(utf8, s2.str());
+
+        char *narrow = xml::String::transcode(&utf16[0]);
+        ASSERT_EQ(utf8, std::string(narrow));
+        xercesc::XMLString::release(&narrow);
+
+        XMLCh *wide = xml::String::transcode(utf8.c_str());
+        ASSERT_TRUE(std::equal(utf16.begin(), utf16.end(), wide));
+        xercesc::XMLString::release(&wide);
+      }
+}
+
+TEST(XercesNameTest, Name)
+{
+  const XMLCh uri[] = { 'u', 'r', 'i', 0x0 };
+  const XMLCh uris[] = { 'u', 'r', 'i', 's', 0x0 };
+  const XMLCh mu[] = { 0x00B5, 0x0 };
+
+  xml::Name name("uri");
+  ASSERT_EQ(std::string("uri"), name.str());
+  ASSERT_EQ(3U, name.size());
+  ASSERT_TRUE(name == uri);
+  ASSERT_FALSE(name == uris);
+  ASSERT_TRUE(name != uris);
+  ASSERT_TRUE(xml::StringView(uri) == name);
+  ASSERT_TRUE(xml::StringView(uris) != name);
+  ASSERT_TRUE(name == xml::Name(std::string("uri")));
+  ASSERT_TRUE(name != xml::Name("catalog"));
+
+  xml::Name utf8("\xC2\xB5");
+  ASSERT_EQ(1U, utf8.size());
+  ASSERT_TRUE(utf8 == mu);
+
+  ASSERT_THROW(xml::Name("\xC2\x28"), std::runtime_error);
+}
+
+TEST(XercesNameTest, Intern)
+{
+  const xml::Name& a(xml::Name::intern("nextCatalog"));
+  const xml::Name& b(xml::Name::intern(std::string("next") + "Catalog"));
+  const xml::Name& c(xml::Name::intern("catalog"));
+
+  ASSERT_EQ(&a, &b);
+  ASSERT_NE(&a, &c);
+  ASSERT_EQ(std::string("nextCatalog"), a.str());
+}
+
+TEST(XercesStringViewTest, Compare)
+{
+  xml::Platform plat;
+
+  const XMLCh src[] = { 'a', 'b', 0x00B5, 0x0 };
+
+  xml::StringView v(src);
+  ASSERT_EQ(3U, v.size());
+  ASSERT_FALSE(v.empty());
+  ASSERT_TRUE(v == "ab\xC2\xB5");
+  ASSERT_TRUE(v != "ab");
+  ASSERT_TRUE(v != "abc");
+  ASSERT_EQ(std::string("ab\xC2\xB5"), v.str());
+
+  xml::StringView prefix(src, 2);
+  ASSERT_TRUE(prefix == "ab");
+  ASSERT_TRUE(prefix == std::string("ab"));
+  ASSERT_TRUE(prefix != "a");
+  ASSERT_TRUE(prefix != "abc");
+  ASSERT_TRUE(prefix != v);
+  ASSERT_TRUE(prefix == xml::StringView(src, 2));
+  ASSERT_EQ(std::string("ab"), prefix.str());
+
+  xml::StringView empty;
+  ASSERT_TRUE(empty.empty());
+  ASSERT_TRUE(empty == "");
+  ASSERT_EQ(std::string(), empty.str());
+
+  // Transcoded identically to String, including errors.
+  const XMLCh wide[] = { 'x', 0x00E9, 0x4E2D, 0xD83D, 0xDE00, 0x0 };
+  ASSERT_EQ(std::string(xml::String(wide)), xml::StringView(wide).str());
+  const XMLCh invalid[] = { 'x', 0xD83D, 'y', 0x0 };
+  ASSERT_THROW(xml::String{invalid}, std::runtime_error);
+  ASSERT_THROW(xml::StringView(invalid).str(), std::runtime_error);
+}
+
+namespace
+{
+
+  class CountingHandler : public xml::sax::Handler
+  {
+  public:
+    CountingHandler():
+      documents(0),
+      elements(0),
+      depth(0),
+      max_depth(0),
+      characters_size(0),
+      image_ids()
+    {}
+
+    void
+    startDocument()
+    {
+      ++documents;
+    }
+
+    void
+    startElement(const xml::StringView&      /* uri */,
+                 const xml::StringView&      localName,
+                 const xml::StringView&      /* qName */,
+                 const xml::sax::Attributes& attributes)
+    {
+      ++elements;
+      ++depth;
+      max_depth = std::max(max_depth, depth);
+      if (localName == "Image" && attributes.has("ID"))
+        image_ids.push_back(attributes.get("ID").str());
+      // Index and name lookups are not ambiguous.
+      if (attributes.size())
+        {
+          EXPECT_TRUE(attributes.value(0) == attributes.get(attributes.qName(0).str().c_str()));
+        }
+    }
+
+    void
+    endElement(const xml::StringView& /* uri */,
+               const xml::StringView& /* localName */,
+               const xml::StringView& /* qName */)
+    {
+      --depth;
+    }
+
+    void
+    characters(const xml::StringView& chars)
+    {
+      characters_size += chars.size();
+    }
+
+    int documents;
+    std::size_t elements;
+    int depth;
+    int max_depth;
+    std::size_t characters_size;
+    std::vector<std::string> image_ids;
+  };
+
+}
+
+TEST_P(XercesTest, SAXReader)
+{
+  const XercesTestParameters& params = GetParam();
+
+  xml::sax::Reader reader(resolver);
+
+  CountingHandler handler;
+  if (params.valid)
+    {
+      ASSERT_NO_THROW(reader.parse(boost::filesystem::path(params.filename), handler));
+      ASSERT_EQ(1, handler.documents);
+      ASSERT_EQ(0, handler.depth);
+      ASSERT_GT(handler.max_depth, 1);
+      ASSERT_GT(handler.characters_size, 0U);
+      ASSERT_FALSE(handler.image_ids.empty());
+
+      xml::dom::Document doc(ome::common::xml::dom::createDocument(boost::filesystem::path(params.filename), resolver));
+      ASSERT_EQ(doc.getElementsByTagName("*")->getLength(), handler.elements);
+
+      xml::dom::NodeList images(doc.getElementsByTagName("Image"));
+      ASSERT_EQ(images->getLength(), handler.image_ids.size());
+    }
+  else
+    {
+      ASSERT_THROW(reader.parse(boost::filesystem::path(params.filename), handler), std::runtime_error);
+    }
+}
+
+TEST_P(XercesTest, SAXReaderReuse)
+{
+  const XercesTestParameters& params = GetParam();
+
+  std::string data;
+
+  std::ifstream in(params.filename.c_str());
+  ASSERT_TRUE(!!in);
+  data.assign(std::istreambuf_iterator<char>(in),
+              std::istreambuf_iterator<char>());
+
+  xml::GrammarPool pool(resolver);
+  xml::sax::Reader reader(resolver, pool);
+
+  for (int i = 0; i < 3; ++i)
+    {
+      CountingHandler handler;
+      if (params.valid)
+        {
+          ASSERT_NO_THROW(reader.parse(data, handler));
+          ASSERT_EQ(1, handler.documents);
+          ASSERT_GT(handler.elements, 0U);
+        }
+      else
+        {
+          ASSERT_THROW(reader.parse(data, handler), std::runtime_error);
+        }
+    }
+}
+
+TEST_P(XercesTest, SAXReaderHandlerException)
+{
+  const XercesTestParameters& params = GetParam();
+
+  class ThrowingHandler : public xml::sax::Handler
+  {
+  public:
+    void
+    startElement(const xml::StringView&      /* uri */,
+                 const xml::StringView&      /* localName */,
+                 const xml::StringView&      /* qName */,
+                 const xml::sax::Attributes& /* attributes */)
+    {
+      throw std::logic_error("Stop");
+    }
+  };
+
+  if (params.valid)
+    {
+      xml::sax::Reader reader(resolver);
+
+      ThrowingHandler stop;
+      ASSERT_THROW(reader.parse(boost::filesystem::path(params.filename), stop), std::logic_error);
+
+      CountingHandler handler;
+      ASSERT_NO_THROW(reader.parse(boost::filesystem::path(params.filename), handler));
+      ASSERT_GT(handler.elements, 0U);
+    }
+}
+
 TEST_P(XercesTest, Node)
 {
   xml::dom::Node node;
@@ -207,6 +633,53 @@ TEST_P(XercesTest, DefaultNodeList)
   ASSERT_FALSE(nodelist);
 }
 
+TEST_P(XercesTest, NodeListIterator)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+  xml::dom::Element root(doc.getDocumentElement());
+  xml::dom::NodeList children(root.getChildNodes());
+  const xml::dom::NodeList& cchildren(children);
+
+  ASSERT_EQ(static_cast<std::ptrdiff_t>(children.size()),
+            std::distance(children.begin(), children.end()));
+  ASSERT_TRUE(cchildren.cbegin() == xml::dom::NodeList::const_iterator(children.begin()));
+
+  std::size_t before = allocations;
+  xml::dom::NodeList::size_type index = 0;
+  for (auto node : children)
+    {
+      ASSERT_TRUE(node == xml::dom::NodeRef((*children).item(index)));
+      ++index;
+    }
+  std::size_t allocated = allocations - before;
+  ASSERT_EQ(children.size(), index);
+  ASSERT_EQ(0U, allocated);
+
+  for (auto i = cchildren.crbegin(); i != cchildren.crend(); ++i)
+    {
+      --index;
+      ASSERT_TRUE(*i == children.begin()[index]);
+    }
+  ASSERT_EQ(0U, index);
+
+  if (!children.empty())
+    {
+      auto last = children.end() - 1;
+      ASSERT_TRUE(last->getNodeType() == (*last).getNodeType());
+      ASSERT_TRUE(*last == xml::dom::NodeRef(children.at(children.size() - 1)));
+      ASSERT_TRUE(children.begin() < last + 1);
+    }
+
+  xml::dom::NodeList nodelist;
+  ASSERT_TRUE(nodelist.begin() == nodelist.end());
+  ASSERT_TRUE(nodelist.rbegin() == nodelist.rend());
+}
+
 TEST_P(XercesTest, DefaultDocument)
 {
   xml::dom::Document document;
@@ -243,6 +716,97 @@ TEST_P(XercesTest, EmptyDocumentCreateElementNS)
   root.appendChild(e);
 }
 
+TEST_P(XercesTest, EmptyDocumentName)
+{
+  static const xml::Name ns("http://example.com/test/namespace");
+  static const xml::Name test("test");
+  static const xml::Name attr("attr");
+
+  xml::dom::Document document(ome::common::xml::dom::createEmptyDocument("root"));
+  ASSERT_TRUE(document);
+  xml::dom::Element e(document.createElementNS(ns, test));
+  xml::dom::Element root(document.getDocumentElement());
+  root.appendChild(e);
+  xml::dom::Element e2(document.createElement(test));
+  root.appendChild(e2);
+
+  ASSERT_TRUE(e.getTagName() == test);
+  ASSERT_FALSE(e.hasAttribute(attr));
+  e.setAttribute(attr, "value");
+  ASSERT_TRUE(e.hasAttribute(attr));
+  ASSERT_TRUE(e.hasAttribute("attr"));
+  ASSERT_EQ(std::string("value"), e.getAttribute(attr).str());
+
+  xml::dom::NodeList nodes(root.getElementsByTagName(test));
+  ASSERT_EQ(2U, nodes.size());
+}
+
+static_assert(std::is_nothrow_move_constructible<xml::String>::value &&
+              std::is_nothrow_move_assignable<xml::String>::value,
+              "String is not nothrow movable");
+static_assert(std::is_nothrow_move_constructible<xml::dom::Node>::value &&
+              std::is_nothrow_move_assignable<xml::dom::Node>::value,
+              "Node is not nothrow movable");
+static_assert(std::is_nothrow_move_constructible<xml::dom::Element>::value &&
+              std::is_nothrow_move_assignable<xml::dom::Element>::value,
+              "Element is not nothrow movable");
+static_assert(std::is_nothrow_move_constructible<xml::dom::Document>::value &&
+              std::is_nothrow_move_assignable<xml::dom::Document>::value,
+              "Document is not nothrow movable");
+static_assert(std::is_nothrow_move_constructible<xml::dom::NodeList>::value &&
+              std::is_nothrow_move_assignable<xml::dom::NodeList>::value,
+              "NodeList is not nothrow movable");
+static_assert(std::is_trivially_copyable<xml::dom::NodeRef>::value,
+              "NodeRef is not trivially copyable");
+static_assert(std::is_trivially_copyable<xml::dom::ElementRef>::value,
+              "ElementRef is not trivially copyable");
+static_assert(std::is_trivially_copyable<xml::dom::NodeList::iterator>::value,
+              "NodeList::iterator is not trivially copyable");
+static_assert(std::is_same<std::iterator_traits<xml::dom::NodeList::iterator>::iterator_category,
+                           std::random_access_iterator_tag>::value,
+              "NodeList::iterator is not random access");
+
+TEST_P(XercesTest, MoveWrappers)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+  xml::dom::Element root(doc.getDocumentElement());
+  xercesc::DOMElement *xroot = root.get();
+  ASSERT_TRUE(root);
+
+  std::size_t before = allocations;
+
+  xml::dom::Element moved(std::move(root));
+  ASSERT_FALSE(root);
+  ASSERT_EQ(xroot, moved.get());
+  ASSERT_EQ(static_cast<xercesc::DOMNode *>(xroot), static_cast<xml::dom::Node&>(moved).get());
+
+  xml::dom::Element assigned;
+  assigned = std::move(moved);
+  ASSERT_FALSE(moved);
+  ASSERT_EQ(xroot, assigned.get());
+
+  xml::String tag(assigned.getTagName());
+  xml::String tag2(std::move(tag));
+  xml::String tag3("");
+  tag3 = std::move(tag2);
+  ASSERT_EQ(std::string(""), tag.str());
+  ASSERT_EQ(std::string(""), tag2.str());
+
+  // Moving wrappers and short Strings does not allocate.
+  ASSERT_EQ(before, allocations.load());
+
+  ASSERT_EQ(xml::String(xroot->getTagName()).str(), tag3.str());
+
+  xml::dom::Document moveddoc(std::move(doc));
+  ASSERT_FALSE(doc);
+  ASSERT_TRUE(moveddoc);
+}
+
 TEST_P(XercesTest, DocumentFromFile)
 {
   const XercesTestParameters& params = GetParam();
@@ -280,6 +844,145 @@ TEST_P(XercesTest, DocumentFromStream)
     }
 }
 
+namespace
+{
+
+  /**
+   * Non-seekable stream buffer delivering data in small chunks, to
+   * simulate a pipe or socket.
+   */
+  class ChunkedStreamBuf : public std::streambuf
+  {
+  public:
+    ChunkedStreamBuf(const std::string& data,
+                     std::size_t        chunk):
+      data(data),
+      offset(0),
+      chunk(chunk)
+    {}
+
+  protected:
+    int_type
+    underflow()
+    {
+      if (offset >= data.size())
+        return traits_type::eof();
+      char *begin = const_cast<char *>(data.data()) + offset;
+      std::size_t count = std::min(chunk, data.size() - offset);
+      offset += count;
+      setg(begin, begin, begin + count);
+      return traits_type::to_int_type(*gptr());
+    }
+
+  private:
+    const std::string& data;
+    std::size_t offset;
+    std::size_t chunk;
+  };
+
+}
+
+TEST_P(XercesTest, DocumentFromNonSeekableStream)
+{
+  const XercesTestParameters& params = GetParam();
+
+  std::ifstream in(params.filename.c_str());
+  ASSERT_TRUE(!!in);
+  std::string data;
+  data.assign(std::istreambuf_iterator<char>(in),
+              std::istreambuf_iterator<char>());
+
+  ChunkedStreamBuf buf(data, 61);
+  std::istream stream(&buf);
+
+  xml::dom::Document doc;
+  if (params.valid)
+    {
+      ASSERT_NO_THROW(doc = ome::common::xml::dom::createDocument(stream, resolver));
+      ASSERT_TRUE(doc != nullptr);
+    }
+  else
+    {
+      ASSERT_THROW(doc = ome::common::xml::dom::createDocument(stream, resolver), std::runtime_error);
+      ASSERT_TRUE(doc == nullptr);
+    }
+}
+
+TEST(XercesInputSourceTest, StreamBinInputStream)
+{
+  xml::Platform plat;
+
+  std::string data(100000, '\0');
+  for (std::size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>('a' + (i % 26));
+
+  ChunkedStreamBuf buf(data, 1000);
+  std::istream stream(&buf);
+  xml::StreamBinInputStream bin(stream);
+
+  std::string result;
+  XMLByte block[4096];
+  XMLSize_t count;
+  while ((count = bin.readBytes(block, sizeof(block))) > 0)
+    {
+      ASSERT_LE(count, 1000U);
+      result.append(reinterpret_cast<const char *>(block), count);
+    }
+
+  ASSERT_EQ(data, result);
+  ASSERT_EQ(data.size(), bin.curPos());
+}
+
+TEST(XercesFormatTargetTest, StringFormatTarget)
+{
+  xml::Platform plat;
+
+  const XMLByte data[] = { 'a', 'b', 'c' };
+
+  std::string text("prefix:");
+  xml::StringFormatTarget target(text);
+  target.writeChars(data, 3, 0);
+  target.writeChars(data, 2, 0);
+  target.flush();
+
+  ASSERT_EQ(std::string("prefix:abcab"), text);
+}
+
+TEST(XercesFormatTargetTest, StreamFormatTarget)
+{
+  xml::Platform plat;
+
+  const XMLByte data[] = { 'a', 'b', 'c' };
+
+  std::ostringstream os;
+  xml::StreamFormatTarget target(os);
+  target.writeChars(data, 3, 0);
+  target.writeChars(data, 2, 0);
+  target.flush();
+
+  ASSERT_EQ(std::string("abcab"), os.str());
+}
+
+TEST(XercesFormatTargetTest, StreamFormatTargetFail)
+{
+  xml::Platform plat;
+
+  const XMLByte data[] = { 'a', 'b', 'c' };
+
+  std::ostringstream os;
+  os.setstate(std::ios::badbit);
+  xml::StreamFormatTarget target(os);
+  ASSERT_THROW(target.writeChars(data, 3, 0), std::runtime_error);
+}
+
+TEST(XercesInputSourceTest, MappedFileMissing)
+{
+  xml::Platform plat;
+
+  ASSERT_THROW(xml::MappedFileInputSource(boost::filesystem::path(PROJECT_SOURCE_DIR "/test/ome-common/data/nonexistent.ome")),
+               std::runtime_error);
+}
+
 TEST_P(XercesTest, DocumentFromString)
 {
   const XercesTestParameters& params = GetParam();
@@ -442,23 +1145,41 @@ TEST_P(XercesTest, DocumentWriteStringParameters)
     }
 }
 
-TEST_P(XercesTest, DocumentWriteStream)
+TEST_P(XercesTest, DocumentWriteStringReplace)
 {
   const XercesTestParameters& params = GetParam();
 
   if (params.valid)
     {
-      std::string data;
+      xml::dom::Document doc(ome::common::xml::dom::createDocument(boost::filesystem::path(params.filename), resolver));
 
-      std::ifstream in(params.filename.c_str());
-      in.seekg(0, std::ios::end);
-      data.reserve(in.tellg());
-      in.seekg(0, std::ios::beg);
+      std::string s;
+      ome::common::xml::dom::writeDocument(doc, s);
 
-      data.assign(std::istreambuf_iterator<char>(in),
-                  std::istreambuf_iterator<char>());
+      std::string s2("existing content");
+      ome::common::xml::dom::writeDocument(doc, s2);
 
-      xml::dom::Document doc(ome::common::xml::dom::createDocument(data, resolver));
+      ASSERT_EQ(s, s2);
+    }
+}
+
+TEST_P(XercesTest, DocumentWriteStream)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (params.valid)
+    {
+      std::string data;
+
+      std::ifstream in(params.filename.c_str());
+      in.seekg(0, std::ios::end);
+      data.reserve(in.tellg());
+      in.seekg(0, std::ios::beg);
+
+      data.assign(std::istreambuf_iterator<char>(in),
+                  std::istreambuf_iterator<char>());
+
+      xml::dom::Document doc(ome::common::xml::dom::createDocument(data, resolver));
       std::ostringstream os;
       ome::common::xml::dom::writeDocument(doc, os);
 
@@ -619,6 +1340,1653 @@ TEST_P(XercesTest, NodeWriteStream)
     }
 }
 
+TEST_P(XercesTest, DocumentParserReuse)
+{
+  const XercesTestParameters& params = GetParam();
+
+  std::string data;
+
+  std::ifstream in(params.filename.c_str());
+
+  ASSERT_TRUE(!!in);
+  data.assign(std::istreambuf_iterator<char>(in),
+              std::istreambuf_iterator<char>());
+
+  xml::dom::DocumentParser parser(resolver);
+
+  for (int i = 0; i < 3; ++i)
+    {
+      std::istringstream is(data);
+
+      xml::dom::Document doc;
+      if (params.valid)
+        {
+          ASSERT_NO_THROW(doc = parser.parse(boost::filesystem::path(params.filename)));
+          ASSERT_TRUE(doc != nullptr);
+          ASSERT_NO_THROW(doc = parser.parse(data));
+          ASSERT_TRUE(doc != nullptr);
+          ASSERT_NO_THROW(doc = parser.parse(is));
+          ASSERT_TRUE(doc != nullptr);
+        }
+      else
+        {
+          ASSERT_THROW(doc = parser.parse(boost::filesystem::path(params.filename)), std::runtime_error);
+          ASSERT_TRUE(doc == nullptr);
+          ASSERT_THROW(doc = parser.parse(data), std::runtime_error);
+          ASSERT_TRUE(doc == nullptr);
+          ASSERT_THROW(doc = parser.parse(is), std::runtime_error);
+          ASSERT_TRUE(doc == nullptr);
+        }
+    }
+}
+
+TEST_P(XercesTest, DocumentParserOutlivesDocument)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (params.valid)
+    {
+      xml::dom::Document doc;
+      std::string s;
+      {
+        xml::dom::DocumentParser parser(resolver);
+        xml::dom::Document first(parser.parse(boost::filesystem::path(params.filename)));
+        doc = parser.parse(boost::filesystem::path(params.filename));
+        ome::common::xml::dom::writeDocument(first, s);
+      }
+
+      std::string s2;
+      ome::common::xml::dom::writeDocument(doc, s2);
+      ASSERT_EQ(s, s2);
+    }
+}
+
+TEST_P(XercesTest, DocumentParserRecoversAfterError)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (params.valid)
+    {
+      xml::dom::DocumentParser parser(resolver);
+
+      ASSERT_THROW(parser.parse(std::string("<unterminated>")), std::runtime_error);
+      ASSERT_NO_THROW(parser.parse(boost::filesystem::path(params.filename)));
+    }
+}
+
+TEST_P(XercesTest, DocumentParserParameters)
+{
+  xml::dom::ParseParameters p;
+  p.validationScheme = xercesc::XercesDOMParser::Val_Never;
+  p.doSchema = false;
+
+  xml::dom::DocumentParser parser(resolver, p);
+  ASSERT_EQ(xercesc::XercesDOMParser::Val_Never, parser.getParameters().validationScheme);
+  ASSERT_FALSE(parser.getParameters().doSchema);
+
+  parser.setParameters(xml::dom::ParseParameters());
+  ASSERT_EQ(xercesc::XercesDOMParser::Val_Auto, parser.getParameters().validationScheme);
+  ASSERT_TRUE(parser.getParameters().doSchema);
+
+  const XercesTestParameters& params = GetParam();
+  if (params.valid)
+    {
+      ASSERT_NO_THROW(parser.parse(boost::filesystem::path(params.filename)));
+    }
+  else
+    {
+      ASSERT_THROW(parser.parse(boost::filesystem::path(params.filename)), std::runtime_error);
+    }
+}
+
+namespace
+{
+
+  // Timer for benchmarks.  report() prints the rate of work done
+  // since construction or the last restart() or report().
+  class benchmark_timer
+  {
+  public:
+    benchmark_timer():
+      start(std::chrono::steady_clock::now())
+    {}
+
+    void
+    restart()
+    {
+      start = std::chrono::steady_clock::now();
+    }
+
+    double
+    seconds() const
+    {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double
+    milliseconds() const
+    {
+      return seconds() * 1000.0;
+    }
+
+    void
+    report(const char *name,
+           double      count,
+           const char *unit)
+    {
+      std::cout << name << ": " << count / seconds() << ' ' << unit << "/s" << std::endl;
+      restart();
+    }
+
+  private:
+    std::chrono::steady_clock::time_point start;
+  };
+
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkDocumentParser)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  std::string data;
+
+  std::ifstream in(params.filename.c_str());
+  ASSERT_TRUE(!!in);
+  data.assign(std::istreambuf_iterator<char>(in),
+              std::istreambuf_iterator<char>());
+
+  const int iterations = 500;
+
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    {
+      xml::dom::Document doc(ome::common::xml::dom::createDocument(data, resolver));
+      ASSERT_TRUE(doc);
+    }
+  timer.report("createDocument", iterations, "documents");
+
+  xml::dom::DocumentParser parser(resolver);
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    {
+      xml::dom::Document doc(parser.parse(data));
+      ASSERT_TRUE(doc);
+    }
+  timer.report("DocumentParser", iterations, "documents");
+}
+
+TEST_P(XercesTest, DocumentWriterReuse)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+
+  std::string expected;
+  ome::common::xml::dom::writeDocument(doc, expected);
+
+  xml::dom::DocumentWriter writer;
+  for (int i = 0; i < 5; ++i)
+    {
+      std::string s("stale content");
+      writer.write(doc, s);
+      ASSERT_EQ(expected, s);
+
+      std::ostringstream os;
+      writer.write(doc, os);
+      ASSERT_EQ(expected, os.str());
+    }
+}
+
+TEST_P(XercesTest, DocumentWriterParameters)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+
+  ome::common::xml::dom::WriteParameters p;
+  p.prettyPrint=true;
+  p.xmlDeclaration=false;
+
+  std::string expected_default;
+  ome::common::xml::dom::writeDocument(doc, expected_default);
+  std::string expected_p;
+  ome::common::xml::dom::writeDocument(doc, expected_p, p);
+  ASSERT_NE(expected_default, expected_p);
+
+  xml::dom::DocumentWriter writer;
+  std::string s;
+  writer.write(doc, s);
+  ASSERT_EQ(expected_default, s);
+
+  writer.setParameters(p);
+  ASSERT_TRUE(writer.getParameters().prettyPrint);
+  ASSERT_FALSE(writer.getParameters().xmlDeclaration);
+  writer.write(doc, s);
+  ASSERT_EQ(expected_p, s);
+
+  writer.setParameters(ome::common::xml::dom::WriteParameters());
+  writer.write(doc, s);
+  ASSERT_EQ(expected_default, s);
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkDocumentWriter)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+
+  const int iterations = 500;
+
+  std::string s;
+
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    {
+      ome::common::xml::dom::writeDocument(doc, s);
+      ASSERT_FALSE(s.empty());
+    }
+  timer.report("writeDocument", iterations, "documents");
+
+  xml::dom::DocumentWriter writer;
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    {
+      writer.write(doc, s);
+      ASSERT_FALSE(s.empty());
+    }
+  timer.report("DocumentWriter", iterations, "documents");
+}
+
+namespace
+{
+
+  // Visit all attributes of an element and its descendants.
+  template<typename F>
+  void
+  visit_attributes(const xercesc::DOMElement *element,
+                   F&                         func)
+  {
+    const xercesc::DOMNamedNodeMap *attrs = element->getAttributes();
+    for (XMLSize_t i = 0; i < attrs->getLength(); ++i)
+      {
+        const xercesc::DOMNode *attr = attrs->item(i);
+        func(attr->getNodeName(), attr->getNodeValue());
+      }
+    for (const xercesc::DOMElement *child = element->getFirstElementChild();
+         child != 0;
+         child = child->getNextElementSibling())
+      visit_attributes(child, func);
+  }
+
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkStringAttributes)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+  const xercesc::DOMElement *root = doc.get()->getDocumentElement();
+
+  const int iterations = 200;
+  std::size_t count = 0;
+  std::size_t bytes = 0;
+
+  // Names and values used as std::string only.
+  auto narrow = [&](const XMLCh *name, const XMLCh *value)
+    {
+      std::string n(xml::String(name).str());
+      std::string v(xml::String(value).str());
+      bytes += n.size() + v.size();
+      ++count;
+    };
+
+  // Names and values used in both forms.
+  auto both = [&](const XMLCh *name, const XMLCh *value)
+    {
+      xml::String n(name);
+      xml::String v(value);
+      bytes += n.str().size() + v.str().size();
+      bytes += xercesc::XMLString::stringLen(n) + xercesc::XMLString::stringLen(v);
+      ++count;
+    };
+
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    visit_attributes(root, narrow);
+  timer.report("String (std::string)", count, "attributes");
+
+  count = 0;
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    visit_attributes(root, both);
+  timer.report("String (std::string and XMLCh *)", count, "attributes");
+
+  ASSERT_NE(0U, bytes);
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkTranscodeAttributes)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  // Attribute names and values from a real document.
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+  std::vector<std::string> narrow;
+  std::vector<std::vector<XMLCh>> wide;
+  std::size_t bytes = 0;
+  auto collect = [&](const XMLCh *name, const XMLCh *value)
+    {
+      for (const XMLCh *str : { name, value })
+        {
+          narrow.push_back(xml::String(str).str());
+          wide.push_back(std::vector<XMLCh>(str, str + xercesc::XMLString::stringLen(str) + 1));
+          bytes += narrow.back().size();
+        }
+    };
+  visit_attributes(doc.get()->getDocumentElement(), collect);
+  ASSERT_FALSE(narrow.empty());
+
+  const int iterations = 200;
+
+  const double mib = (bytes * iterations) / (1024.0 * 1024.0);
+
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    for (const auto& str : narrow)
+      {
+        XMLCh *out = xml::String::transcode(str.c_str());
+        xercesc::XMLString::release(&out);
+      }
+  timer.report("String::transcode (UTF-8 to UTF-16)", mib, "MiB");
+
+  for (int i = 0; i < iterations; ++i)
+    for (const auto& str : narrow)
+      {
+        xercesc::TranscodeFromStr tc(reinterpret_cast<const XMLByte *>(str.c_str()), str.size(), "UTF-8");
+        ASSERT_TRUE(tc.str() != 0);
+      }
+  timer.report("TranscodeFromStr (UTF-8 to UTF-16)", mib, "MiB");
+
+  for (int i = 0; i < iterations; ++i)
+    for (const auto& str : wide)
+      {
+        char *out = xml::String::transcode(&str[0]);
+        xercesc::XMLString::release(&out);
+      }
+  timer.report("String::transcode (UTF-16 to UTF-8)", mib, "MiB");
+
+  for (int i = 0; i < iterations; ++i)
+    for (const auto& str : wide)
+      {
+        xercesc::TranscodeToStr tc(&str[0], "UTF-8");
+        ASSERT_TRUE(tc.str() != 0);
+      }
+  timer.report("TranscodeToStr (UTF-16 to UTF-8)", mib, "MiB");
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkNameLookup)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+  std::vector<xml::dom::Element> elements;
+  std::vector<xercesc::DOMElement *> pending(1, doc.get()->getDocumentElement());
+  while (!pending.empty())
+    {
+      xercesc::DOMElement *e = pending.back();
+      pending.pop_back();
+      elements.push_back(xml::dom::Element(e, false));
+      for (xercesc::DOMElement *child = e->getFirstElementChild();
+           child != 0;
+           child = child->getNextElementSibling())
+        pending.push_back(child);
+    }
+
+  const int iterations = 500;
+  std::size_t found = 0;
+
+  const double lookups = static_cast<double>(iterations) * elements.size();
+
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    for (auto& e : elements)
+      if (e.hasAttribute("ID"))
+        ++found;
+  timer.report("hasAttribute(std::string)", lookups, "lookups");
+
+  static const xml::Name id("ID");
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    for (auto& e : elements)
+      if (e.hasAttribute(id))
+        ++found;
+  timer.report("hasAttribute(Name)", lookups, "lookups");
+
+  std::cout << "Found " << found / (2 * iterations) << " ID attributes per pass" << std::endl;
+}
+
+namespace
+{
+
+  // Visit all elements using the DOM wrappers.
+  void
+  traverse(xml::dom::Element& element,
+           std::size_t&       count)
+  {
+    ++count;
+    xml::String name(element.getTagName());
+    xml::dom::NodeList children(element.getChildNodes());
+    for (auto&& node : children)
+      {
+        if (node.getNodeType() == xercesc::DOMNode::ELEMENT_NODE)
+          {
+            xml::dom::Element child(node.get(), false);
+            traverse(child, count);
+          }
+      }
+  }
+
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkTraversal)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+
+  const int iterations = 200;
+  std::size_t count = 0;
+
+  std::size_t before = allocations;
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    {
+      xml::dom::Element root(doc.getDocumentElement());
+      traverse(root, count);
+    }
+  double seconds = timer.seconds();
+  std::size_t allocated = allocations - before;
+
+  std::cout << "Traversal: " << count / seconds << " elements/s, "
+            << static_cast<double>(allocated) / count << " allocations/element" << std::endl;
+}
+
+namespace
+{
+
+  // Visit all elements using non-owning references.
+  void
+  traverse(xml::dom::ElementRef element,
+           std::size_t&         count)
+  {
+    ++count;
+    xml::String name(element.getTagName());
+    for (xml::dom::ElementRef child = element.getFirstElementChild();
+         child;
+         child = child.getNextElementSibling())
+      traverse(child, count);
+  }
+
+}
+
+TEST_P(XercesTest, NodeRefTraversal)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+  xml::dom::Element root(doc.getDocumentElement());
+
+  std::size_t expected = 0;
+  traverse(root, expected);
+
+  std::size_t count = 0;
+  std::size_t before = allocations;
+  traverse(xml::dom::ElementRef(root), count);
+  std::size_t allocated = allocations - before;
+
+  ASSERT_EQ(expected, count);
+  ASSERT_EQ(0U, allocated);
+
+  xml::dom::NodeRef node(root);
+  ASSERT_TRUE(node == xml::dom::NodeRef(root.get()));
+  ASSERT_EQ(xercesc::DOMNode::ELEMENT_NODE, node.getNodeType());
+
+  xml::dom::ElementRef first(root.getFirstElementChild());
+  if (first)
+    {
+      ASSERT_TRUE(first.getParentElement() == xml::dom::ElementRef(root));
+      ASSERT_TRUE(xml::dom::NodeRef(first).getParentNode() == node);
+      ASSERT_TRUE(xml::dom::ElementRef(xml::dom::NodeRef(first)) == first);
+
+      xml::dom::Element wrapped(first);
+      ASSERT_EQ(first.getTagName(), wrapped.getTagName());
+    }
+
+  xml::dom::ElementRef null;
+  ASSERT_FALSE(null);
+  ASSERT_THROW(null.getTagName(), std::logic_error);
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkNodeRefTraversal)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+
+  const int iterations = 200;
+
+  std::size_t wrapper_count = 0;
+  std::size_t before = allocations;
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    {
+      xml::dom::Element root(doc.getDocumentElement());
+      traverse(root, wrapper_count);
+    }
+  double wrapper_time = timer.seconds();
+  std::size_t wrapper_allocated = allocations - before;
+
+  std::size_t ref_count = 0;
+  before = allocations;
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    {
+      xml::dom::ElementRef root(doc.getDocumentElement());
+      traverse(root, ref_count);
+    }
+  double ref_time = timer.seconds();
+  std::size_t ref_allocated = allocations - before;
+
+  ASSERT_EQ(wrapper_count, ref_count);
+
+  std::cout << "Wrapper traversal: " << wrapper_count / wrapper_time << " elements/s, "
+            << static_cast<double>(wrapper_allocated) / wrapper_count << " allocations/element\n"
+            << "ElementRef traversal: " << ref_count / ref_time << " elements/s, "
+            << static_cast<double>(ref_allocated) / ref_count << " allocations/element" << std::endl;
+}
+
+TEST_P(XercesTest, ElementRange)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+  xml::dom::Element root(doc.getDocumentElement());
+
+  static const xml::Name ns("http://www.openmicroscopy.org/Schemas/OME/2012-06");
+  static const xml::Name image("Image");
+  static const xml::Name pixels("Pixels");
+  static const xml::Name channel("Channel");
+  static const xml::Name prefixed_pixels("OME:Pixels");
+
+  std::size_t before = allocations;
+
+  std::size_t count = 0;
+  for (auto child : root.children())
+    {
+      ASSERT_TRUE(child.getParentElement() == xml::dom::ElementRef(root));
+      ++count;
+    }
+  ASSERT_EQ(root.getChildElementCount(), count);
+
+  xml::dom::ElementRef img(root.childElementsNS(ns, image).front());
+  ASSERT_TRUE(img);
+  ASSERT_TRUE(img == root.childElements(image).front());
+
+  // Pixels uses a namespace prefix, so only matches by namespace and
+  // local name, or by the prefixed tag name.
+  ASSERT_TRUE(img.childElements(pixels).empty());
+  xml::dom::ElementRef pix(img.childElementsNS(ns, pixels).front());
+  ASSERT_TRUE(pix);
+  ASSERT_TRUE(pix == img.childElements(prefixed_pixels).front());
+
+  auto channels = pix.childElementsNS(ns, channel);
+  ASSERT_EQ(2, std::distance(channels.begin(), channels.end()));
+
+  std::size_t allocated = allocations - before;
+  ASSERT_EQ(0U, allocated);
+
+  ASSERT_TRUE(xml::dom::ElementRef().children().empty());
+
+  // Temporary Names are kept alive by the range, including copies
+  // which outlive the original.
+  auto expected = channels.begin();
+  for (auto chan : pix.childElementsNS(xml::Name("http://www.openmicroscopy.org/Schemas/OME/2012-06"),
+                                       xml::Name("Channel")))
+    {
+      ASSERT_TRUE(expected != channels.end());
+      ASSERT_TRUE(chan == *expected++);
+    }
+  ASSERT_TRUE(expected == channels.end());
+
+  count = 0;
+  for (auto child : root.childElements(xml::Name("Image")))
+    {
+      ASSERT_TRUE(child == img);
+      ++count;
+    }
+  ASSERT_EQ(1U, count);
+
+  xml::dom::ElementRange copy(xml::dom::ElementRef(root).children());
+  {
+    xml::dom::ElementRange temporary(img.childElements(xml::Name("OME:Pixels")));
+    copy = temporary;
+  }
+  ASSERT_TRUE(copy.front() == pix);
+}
+
+namespace
+{
+
+  // Generate a large OME-XML document without a schema.
+  std::string
+  make_metadata(std::size_t images)
+  {
+    std::ostringstream os;
+    os << "<?xml version=\"1.0\"?>\n"
+       << "<OME xmlns=\"http://www.openmicroscopy.org/Schemas/OME/2016-06\">\n";
+    for (std::size_t i = 0; i < images; ++i)
+      {
+        os << "  <Image ID=\"Image:" << i << "\" Name=\"image" << i << "\">\n"
+           << "    <AcquisitionDate>2010-03-02T10:01:15</AcquisitionDate>\n"
+           << "    <Pixels ID=\"Pixels:" << i << "\" DimensionOrder=\"XYZCT\" Type=\"uint8\""
+           << " SizeX=\"512\" SizeY=\"512\" SizeZ=\"10\" SizeC=\"3\" SizeT=\"5\">\n";
+        for (std::size_t c = 0; c < 3; ++c)
+          os << "      <Channel ID=\"Channel:" << i << ':' << c << "\" SamplesPerPixel=\"1\"/>\n";
+        for (std::size_t p = 0; p < 150; ++p)
+          os << "      <TiffData IFD=\"" << p << "\" PlaneCount=\"1\"/>\n";
+        os << "    </Pixels>\n"
+           << "  </Image>\n";
+      }
+    os << "</OME>\n";
+    return os.str();
+  }
+
+  const xml::Name& ome_ns(xml::Name::intern("http://www.openmicroscopy.org/Schemas/OME/2016-06"));
+  const xml::Name& image_name(xml::Name::intern("Image"));
+  const xml::Name& pixels_name(xml::Name::intern("Pixels"));
+  const xml::Name& channel_name(xml::Name::intern("Channel"));
+  const xml::Name& id_name(xml::Name::intern("ID"));
+  const xml::Name& sizex_name(xml::Name::intern("SizeX"));
+
+  // Summary of extracted metadata.
+  struct Metadata
+  {
+    std::size_t images;
+    std::size_t channels;
+    std::size_t idlength;
+    std::size_t sizex;
+  };
+
+  // Extract metadata by iterating child nodes and wrapping elements.
+  Metadata
+  extract_wrapped(xml::dom::Element& root)
+  {
+    Metadata m = {0, 0, 0, 0};
+    xml::dom::NodeList images(root.getChildNodes());
+    for (auto inode : images)
+      {
+        if (inode.getNodeType() != xercesc::DOMNode::ELEMENT_NODE)
+          continue;
+        xml::dom::Element image(inode.get(), false);
+        if (!(image_name == image->getLocalName()))
+          continue;
+        ++m.images;
+        m.idlength += std::strlen(image.getAttribute(id_name).c_str());
+        xml::dom::NodeList pixels(image.getChildNodes());
+        for (auto pnode : pixels)
+          {
+            if (pnode.getNodeType() != xercesc::DOMNode::ELEMENT_NODE)
+              continue;
+            xml::dom::Element pix(pnode.get(), false);
+            if (!(pixels_name == pix->getLocalName()))
+              continue;
+            m.sizex += std::stoul(pix.getAttribute(sizex_name).str());
+            xml::dom::NodeList channels(pix.getChildNodes());
+            for (auto cnode : channels)
+              {
+                if (cnode.getNodeType() != xercesc::DOMNode::ELEMENT_NODE)
+                  continue;
+                xml::dom::Element chan(cnode.get(), false);
+                if (channel_name == chan->getLocalName())
+                  ++m.channels;
+              }
+          }
+      }
+    return m;
+  }
+
+  // Extract metadata using child element ranges.
+  Metadata
+  extract_ranges(xml::dom::ElementRef root)
+  {
+    Metadata m = {0, 0, 0, 0};
+    for (auto image : root.childElementsNS(ome_ns, image_name))
+      {
+        ++m.images;
+        m.idlength += std::strlen(image.getAttribute(id_name).c_str());
+        for (auto pix : image.childElementsNS(ome_ns, pixels_name))
+          {
+            m.sizex += std::stoul(pix.getAttribute(sizex_name).str());
+            for (auto chan : pix.childElementsNS(ome_ns, channel_name))
+              {
+                static_cast<void>(chan);
+                ++m.channels;
+              }
+          }
+      }
+    return m;
+  }
+
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkMetadataExtraction)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::ParseParameters parse;
+  parse.validationScheme = xercesc::XercesDOMParser::Val_Never;
+  parse.doSchema = false;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(make_metadata(2000), resolver, parse));
+  xml::dom::Element root(doc.getDocumentElement());
+
+  const int iterations = 20;
+
+  Metadata wrapped = {0, 0, 0, 0};
+  std::size_t before = allocations;
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    wrapped = extract_wrapped(root);
+  double wrapped_time = timer.seconds();
+  std::size_t wrapped_allocated = allocations - before;
+
+  Metadata ranges = {0, 0, 0, 0};
+  before = allocations;
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    ranges = extract_ranges(root);
+  double ranges_time = timer.seconds();
+  std::size_t ranges_allocated = allocations - before;
+
+  ASSERT_EQ(2000U, ranges.images);
+  ASSERT_EQ(wrapped.images, ranges.images);
+  ASSERT_EQ(wrapped.channels, ranges.channels);
+  ASSERT_EQ(wrapped.idlength, ranges.idlength);
+  ASSERT_EQ(wrapped.sizex, ranges.sizex);
+
+  std::cout << "Metadata extraction (NodeList): " << (iterations * wrapped.images) / wrapped_time << " images/s, "
+            << static_cast<double>(wrapped_allocated) / (iterations * wrapped.images) << " allocations/image\n"
+            << "Metadata extraction (ElementRange): " << (iterations * ranges.images) / ranges_time << " images/s, "
+            << static_cast<double>(ranges_allocated) / (iterations * ranges.images) << " allocations/image" << std::endl;
+}
+
+TEST_P(XercesTest, Query)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(params.filename, resolver));
+  xml::dom::Element root(doc.getDocumentElement());
+
+  xml::dom::Query sizex("/OME/Image/Pixels/@SizeX");
+  ASSERT_TRUE(sizex.absolute());
+  ASSERT_TRUE(sizex.selectsAttribute());
+  std::vector<xml::String> values(sizex.values(doc));
+  ASSERT_EQ(1U, values.size());
+  ASSERT_EQ(std::string("18"), values[0].str());
+
+  ASSERT_EQ(std::string("18x24y1z5t1c8b-text"),
+            xml::dom::Query("/OME/Image/@Name").selectValue(doc).str());
+  ASSERT_EQ(2U, xml::dom::Query("//Channel").select(doc).size());
+  ASSERT_EQ(2U, xml::dom::Query("/OME/Image[@ID='Image:0']/Pixels/Channel").select(doc).size());
+  ASSERT_EQ(0U, xml::dom::Query("/OME/Image[@ID='Image:1']/Pixels/Channel").select(doc).size());
+  ASSERT_EQ(1U, xml::dom::Query("//*[@SizeX][@Type='uint8']").select(doc).size());
+  ASSERT_EQ(doc.getElementsByTagName("*").size(),
+            xml::dom::Query("//*").select(doc).size());
+
+  xml::dom::Query::namespace_map ns = {{"Bin", "http://www.openmicroscopy.org/Schemas/BinaryFile/2012-06"},
+                                       {"OME", "http://www.openmicroscopy.org/Schemas/OME/2012-06"}};
+  ASSERT_EQ(doc.getElementsByTagName("Bin:BinData").size(),
+            xml::dom::Query("//Bin:BinData", ns).select(doc).size());
+  ASSERT_EQ(0U, xml::dom::Query("//OME:BinData", ns).select(doc).size());
+  ASSERT_EQ(static_cast<std::size_t>(doc->getElementsByTagNameNS(xml::String(ns["Bin"]), xml::String("*"))->getLength()),
+            xml::dom::Query("//Bin:*", ns).select(doc).size());
+  ASSERT_EQ(1U, xml::dom::Query("/OME:*", ns).select(doc).size());
+  ASSERT_EQ(0U, xml::dom::Query("/Bin:*", ns).select(doc).size());
+
+  // Relative queries are evaluated from the context element;
+  // absolute queries from its document.
+  xml::dom::ElementRef image(xml::dom::Query("/OME/Image").selectFirst(doc));
+  ASSERT_TRUE(image);
+  ASSERT_EQ(2U, xml::dom::Query("Pixels/Channel").select(image).size());
+  ASSERT_EQ(2U, xml::dom::Query(".//Channel").select(image).size());
+  ASSERT_TRUE(xml::dom::Query("/OME").selectFirst(image) == xml::dom::ElementRef(root));
+
+  xml::dom::Query channels("//Channel");
+  std::size_t count = 0;
+  std::size_t before = allocations;
+  channels.forEach(doc, [&count](xml::dom::ElementRef) { ++count; });
+  std::size_t allocated = allocations - before;
+  ASSERT_EQ(2U, count);
+  ASSERT_EQ(0U, allocated);
+
+  ASSERT_THROW(xml::dom::Query(""), std::runtime_error);
+  ASSERT_THROW(xml::dom::Query("/OME["), std::runtime_error);
+  ASSERT_THROW(xml::dom::Query("/OME/@ID/Image"), std::runtime_error);
+  ASSERT_THROW(xml::dom::Query("//Bin:BinData"), std::runtime_error);
+  ASSERT_THROW(xml::dom::Query("//Bin:*"), std::runtime_error);
+  ASSERT_THROW(xml::dom::Query("//*:BinData", ns), std::runtime_error);
+  ASSERT_THROW(xml::dom::Query("//Bin:Bin*", ns), std::runtime_error);
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkQuery)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::dom::ParseParameters parse;
+  parse.validationScheme = xercesc::XercesDOMParser::Val_Never;
+  parse.doSchema = false;
+
+  xml::dom::Document doc(ome::common::xml::dom::createDocument(make_metadata(2000), resolver, parse));
+
+  const int iterations = 20;
+
+  // Sum of /OME/Image/Pixels/@SizeX.
+  std::size_t tag_sum = 0;
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    {
+      xml::dom::NodeList pixels(doc.getElementsByTagName("Pixels"));
+      for (auto node : pixels)
+        {
+          xml::dom::Element e(node.get(), false);
+          tag_sum += std::stoul(e.getAttribute("SizeX").str());
+        }
+    }
+  double tag_time = timer.seconds();
+
+  std::size_t query_sum = 0;
+  const xml::dom::Query sizex("/OME/Image/Pixels/@SizeX");
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    {
+      sizex.forEach(doc, [&](xml::dom::ElementRef e)
+                    {
+                      query_sum += std::stoul(sizex.value(e).str());
+                    });
+    }
+  double query_time = timer.seconds();
+
+  ASSERT_EQ(tag_sum, query_sum);
+  ASSERT_EQ(iterations * 2000U * 512U, query_sum);
+
+  std::cout << "SizeX (getElementsByTagName): " << iterations / tag_time << " queries/s\n"
+            << "SizeX (Query): " << iterations / query_time << " queries/s" << std::endl;
+
+  // Channels of a single Image.
+  std::size_t tag_channels = 0;
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    {
+      xml::dom::NodeList images(doc.getElementsByTagName("Image"));
+      for (auto node : images)
+        {
+          xml::dom::Element image(node.get(), false);
+          if (image.getAttribute("ID").str() == "Image:1000")
+            tag_channels += image.getElementsByTagName("Channel").size();
+        }
+    }
+  tag_time = timer.seconds();
+
+  std::size_t query_channels = 0;
+  const xml::dom::Query channels("/OME/Image[@ID='Image:1000']/Pixels/Channel");
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    channels.forEach(doc, [&](xml::dom::ElementRef) { ++query_channels; });
+  query_time = timer.seconds();
+
+  ASSERT_EQ(tag_channels, query_channels);
+  ASSERT_EQ(iterations * 3U, query_channels);
+
+  std::cout << "Image channels (getElementsByTagName): " << iterations / tag_time << " queries/s\n"
+            << "Image channels (Query): " << iterations / query_time << " queries/s" << std::endl;
+}
+
+TEST_P(XercesTest, GrammarPoolPreload)
+{
+  const XercesTestParameters& params = GetParam();
+
+  xml::GrammarPool pool(resolver);
+  ASSERT_TRUE(pool.locked());
+  ASSERT_GT(pool.size(), 0U);
+  ASSERT_THROW(pool.loadGrammar("http://www.openmicroscopy.org/Schemas/OME/2012-06/ome.xsd", resolver),
+               std::runtime_error);
+
+  xml::dom::DocumentParser parser(resolver, pool);
+  for (int i = 0; i < 3; ++i)
+    {
+      xml::dom::Document doc;
+      if (params.valid)
+        {
+          ASSERT_NO_THROW(doc = parser.parse(boost::filesystem::path(params.filename)));
+          ASSERT_TRUE(doc != nullptr);
+        }
+      else
+        {
+          ASSERT_THROW(doc = parser.parse(boost::filesystem::path(params.filename)), std::runtime_error);
+          ASSERT_TRUE(doc == nullptr);
+        }
+    }
+}
+
+TEST_P(XercesTest, GrammarPoolFromParse)
+{
+  const XercesTestParameters& params = GetParam();
+
+  xml::GrammarPool pool;
+  ASSERT_FALSE(pool.locked());
+  ASSERT_EQ(0U, pool.size());
+
+  if (params.valid)
+    {
+      {
+        xml::dom::DocumentParser parser(resolver, pool);
+        ASSERT_NO_THROW(parser.parse(boost::filesystem::path(params.filename)));
+      }
+      ASSERT_GT(pool.size(), 0U);
+
+      pool.lock();
+      xml::dom::DocumentParser parser(resolver, pool);
+      ASSERT_NO_THROW(parser.parse(boost::filesystem::path(params.filename)));
+    }
+}
+
+TEST_P(XercesTest, GrammarPoolUnregistered)
+{
+  xml::GrammarPool pool;
+
+  ASSERT_THROW(pool.loadGrammar("http://example.com/unregistered.xsd", resolver),
+               std::runtime_error);
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkGrammarPool)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  std::string data;
+
+  std::ifstream in(params.filename.c_str());
+  ASSERT_TRUE(!!in);
+  data.assign(std::istreambuf_iterator<char>(in),
+              std::istreambuf_iterator<char>());
+
+  const int iterations = 500;
+
+  {
+    xml::dom::DocumentParser parser(resolver);
+    benchmark_timer timer;
+    for (int i = 0; i < iterations; ++i)
+      {
+        xml::dom::Document doc(parser.parse(data));
+        ASSERT_TRUE(doc);
+      }
+    timer.report("DocumentParser", iterations, "documents");
+  }
+
+  benchmark_timer timer;
+  xml::GrammarPool pool(resolver);
+  std::cout << "GrammarPool preload: " << timer.milliseconds() << " ms" << std::endl;
+
+  {
+    xml::dom::DocumentParser parser(resolver, pool);
+    timer.restart();
+    for (int i = 0; i < iterations; ++i)
+      {
+        xml::dom::Document doc(parser.parse(data));
+        ASSERT_TRUE(doc);
+      }
+    timer.report("DocumentParser with GrammarPool", iterations, "documents");
+  }
+}
+
+TEST_P(XercesTest, ParserCacheThreads)
+{
+  const XercesTestParameters& params = GetParam();
+
+  std::string data;
+
+  std::ifstream in(params.filename.c_str());
+  ASSERT_TRUE(!!in);
+  data.assign(std::istreambuf_iterator<char>(in),
+              std::istreambuf_iterator<char>());
+
+  xml::GrammarPool pool(resolver);
+  xml::dom::ParserCache cache(resolver, pool);
+
+  const unsigned int nthreads = 4;
+  std::vector<int> results(nthreads, 0);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < nthreads; ++t)
+    {
+      threads.emplace_back([&, t]()
+        {
+          for (int i = 0; i < 10; ++i)
+            {
+              try
+                {
+                  if (cache.parse(data))
+                    ++results[t];
+                }
+              catch (const std::runtime_error&)
+                {
+                }
+            }
+        });
+    }
+  for (auto& thread : threads)
+    thread.join();
+
+  for (unsigned int t = 0; t < nthreads; ++t)
+    ASSERT_EQ(params.valid ? 10 : 0, results[t]);
+  ASSERT_EQ(nthreads, cache.size());
+}
+
+TEST_P(XercesTest, ParserCacheRelease)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  xml::GrammarPool pool(resolver);
+  xml::dom::ParserCache cache(resolver, pool);
+
+  xml::dom::Document doc(cache.parse(boost::filesystem::path(params.filename)));
+  ASSERT_EQ(1U, cache.size());
+  cache.release();
+  ASSERT_EQ(0U, cache.size());
+  ASSERT_TRUE(doc.getDocumentElement());
+  cache.release();
+  ASSERT_EQ(0U, cache.size());
+
+  // Short-lived threads releasing their parsers don't grow the cache.
+  for (unsigned int t = 0; t < 4; ++t)
+    {
+      std::thread thread([&]()
+        {
+          cache.parse(boost::filesystem::path(params.filename));
+          cache.release();
+        });
+      thread.join();
+    }
+  ASSERT_EQ(0U, cache.size());
+
+  ASSERT_TRUE(cache.parse(boost::filesystem::path(params.filename)));
+  ASSERT_EQ(1U, cache.size());
+}
+
+TEST_P(XercesTest, ParserCacheUnlockedPool)
+{
+  xml::GrammarPool pool;
+
+  ASSERT_THROW(xml::dom::ParserCache cache(resolver, pool), std::logic_error);
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkParserCacheThreads)
+{
+  const XercesTestParameters& params = GetParam();
+
+  if (!params.valid)
+    return;
+
+  std::string data;
+
+  std::ifstream in(params.filename.c_str());
+  ASSERT_TRUE(!!in);
+  data.assign(std::istreambuf_iterator<char>(in),
+              std::istreambuf_iterator<char>());
+
+  xml::GrammarPool pool(resolver);
+  xml::dom::ParserCache cache(resolver, pool);
+
+  const int iterations = 500;
+
+  unsigned int max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  for (unsigned int nthreads = 1U; nthreads <= max_threads; nthreads *= 2U)
+    {
+      std::vector<std::thread> threads;
+      benchmark_timer timer;
+      for (unsigned int t = 0; t < nthreads; ++t)
+        {
+          threads.emplace_back([&]()
+            {
+              for (int i = 0; i < iterations; ++i)
+                cache.parse(data);
+            });
+        }
+      for (auto& thread : threads)
+        thread.join();
+      double seconds = timer.seconds();
+      std::cout << "ParserCache (" << nthreads << " threads): "
+                << (nthreads * iterations) / seconds << " documents/s" << std::endl;
+    }
+}
+
+TEST_P(XercesTest, EntityResolverThreads)
+{
+  const std::vector<std::string> ids(resolver.getEntityIds());
+  ASSERT_FALSE(ids.empty());
+
+  std::atomic<std::size_t> failures(0);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < 8; ++t)
+    {
+      threads.emplace_back([&]()
+        {
+          for (int i = 0; i < 20; ++i)
+            {
+              for (const auto& id : ids)
+                {
+                  std::unique_ptr<xercesc::InputSource> source(resolver.getSource(id));
+                  if (!source)
+                    ++failures;
+                }
+            }
+        });
+    }
+  // Register additional entities while the lookups are running.
+  threads.emplace_back([&]()
+    {
+      for (int i = 0; i < 20; ++i)
+        {
+          std::ostringstream id;
+          id << "urn:ome-common-test:entity-" << i;
+          resolver.registerEntity(id.str(),
+                                  boost::filesystem::path(PROJECT_SOURCE_DIR "/test/ome-common/data/schema/external/xml.xsd"));
+          std::unique_ptr<xercesc::InputSource> source(resolver.getSource(id.str()));
+          if (!source)
+            ++failures;
+        }
+    });
+  for (auto& thread : threads)
+    thread.join();
+
+  ASSERT_EQ(0U, failures);
+  ASSERT_EQ(ids.size() + 20U, resolver.getEntityIds().size());
+  ASSERT_TRUE(resolver.getSource("urn:ome-common-test:unregistered") == nullptr);
+}
+
+TEST_P(XercesTest, EntityResolverSnapshot)
+{
+  const boost::filesystem::path schema(PROJECT_SOURCE_DIR "/test/ome-common/data/schema/external/xml.xsd");
+
+  std::unique_ptr<xml::EntityResolver> r1(new xml::EntityResolver);
+  xml::EntityResolver r2;
+  r1->registerEntity("urn:ome-common-test:r1", schema);
+  r2.registerEntity("urn:ome-common-test:r2", schema);
+
+  // Each thread caches one snapshot; alternating resolvers must not
+  // mix them up.
+  for (int i = 0; i < 2; ++i)
+    {
+      ASSERT_TRUE(std::unique_ptr<xercesc::InputSource>(r1->getSource("urn:ome-common-test:r1")) != nullptr);
+      ASSERT_TRUE(r1->getSource("urn:ome-common-test:r2") == nullptr);
+      ASSERT_TRUE(std::unique_ptr<xercesc::InputSource>(r2.getSource("urn:ome-common-test:r2")) != nullptr);
+      ASSERT_TRUE(r2.getSource("urn:ome-common-test:r1") == nullptr);
+    }
+
+  // Registration by another thread replaces this thread's cached
+  // snapshot.
+  ASSERT_TRUE(r1->getSource("urn:ome-common-test:later") == nullptr);
+  std::thread([&]() { r1->registerEntity("urn:ome-common-test:later", schema); }).join();
+  ASSERT_TRUE(std::unique_ptr<xercesc::InputSource>(r1->getSource("urn:ome-common-test:later")) != nullptr);
+
+  // A new resolver (possibly at the same address) does not see the
+  // snapshot cached for a destroyed one.
+  r1.reset(new xml::EntityResolver);
+  ASSERT_TRUE(r1->getSource("urn:ome-common-test:r1") == nullptr);
+  ASSERT_TRUE(r1->getEntityIds().empty());
+}
+
+TEST_P(XercesTest, EntityResolverUTF16)
+{
+  for (const auto& id : resolver.getEntityIds())
+    {
+      xml::String wide(id);
+      std::unique_ptr<xercesc::InputSource> narrow_source(resolver.getSource(id));
+      std::unique_ptr<xercesc::InputSource> wide_source(resolver.getSource(static_cast<const XMLCh *>(wide)));
+      ASSERT_TRUE(narrow_source != nullptr);
+      ASSERT_TRUE(wide_source != nullptr);
+      ASSERT_EQ(xml::String(narrow_source->getSystemId()), xml::String(wide_source->getSystemId()));
+
+      // Both sources read the same shared buffer.
+      std::unique_ptr<xercesc::BinInputStream> narrow_stream(narrow_source->makeStream());
+      std::unique_ptr<xercesc::BinInputStream> wide_stream(wide_source->makeStream());
+      XMLByte narrow_bytes[256];
+      XMLByte wide_bytes[256];
+      XMLSize_t narrow_count = narrow_stream->readBytes(narrow_bytes, sizeof(narrow_bytes));
+      XMLSize_t wide_count = wide_stream->readBytes(wide_bytes, sizeof(wide_bytes));
+      ASSERT_GT(narrow_count, 0U);
+      ASSERT_EQ(narrow_count, wide_count);
+      ASSERT_TRUE(std::equal(narrow_bytes, narrow_bytes + narrow_count, wide_bytes));
+    }
+
+  ASSERT_TRUE(resolver.getSource(static_cast<const XMLCh *>(nullptr)) == nullptr);
+  ASSERT_TRUE(resolver.getSource(static_cast<const XMLCh *>(xml::String("urn:ome-common-test:unregistered"))) == nullptr);
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkEntityResolverLookup)
+{
+  const std::vector<std::string> ids(resolver.getEntityIds());
+  std::vector<xml::String> wide_ids(ids.begin(), ids.end());
+
+  // Load all entities before timing.
+  for (const auto& id : ids)
+    std::unique_ptr<xercesc::InputSource>(resolver.getSource(id));
+
+  const int iterations = 20000;
+
+  std::size_t before = allocations;
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    for (const auto& id : ids)
+      std::unique_ptr<xercesc::InputSource>(resolver.getSource(id));
+  double narrow_time = timer.seconds();
+  std::size_t narrow_allocated = allocations - before;
+
+  before = allocations;
+  timer.restart();
+  for (int i = 0; i < iterations; ++i)
+    for (const auto& id : wide_ids)
+      std::unique_ptr<xercesc::InputSource>(resolver.getSource(static_cast<const XMLCh *>(id)));
+  double wide_time = timer.seconds();
+  std::size_t wide_allocated = allocations - before;
+
+  double lookups = static_cast<double>(iterations) * ids.size();
+  std::cout << "EntityResolver lookup (std::string): " << lookups / narrow_time << " lookups/s, "
+            << narrow_allocated / lookups << " allocations/lookup\n"
+            << "EntityResolver lookup (XMLCh): " << lookups / wide_time << " lookups/s, "
+            << wide_allocated / lookups << " allocations/lookup" << std::endl;
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkEntityResolverThreads)
+{
+  const std::vector<std::string> ids(resolver.getEntityIds());
+
+  // Load all entities before timing.
+  for (const auto& id : ids)
+    std::unique_ptr<xercesc::InputSource>(resolver.getSource(id));
+
+  const int iterations = 2000;
+
+  unsigned int max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  for (unsigned int nthreads = 1U; nthreads <= max_threads; nthreads *= 2U)
+    {
+      std::vector<std::thread> threads;
+      benchmark_timer timer;
+      for (unsigned int t = 0; t < nthreads; ++t)
+        {
+          threads.emplace_back([&]()
+            {
+              for (int i = 0; i < iterations; ++i)
+                for (const auto& id : ids)
+                  std::unique_ptr<xercesc::InputSource>(resolver.getSource(id));
+            });
+        }
+      for (auto& thread : threads)
+        thread.join();
+      double seconds = timer.seconds();
+      std::cout << "EntityResolver (" << nthreads << " threads): "
+                << (nthreads * iterations * ids.size()) / seconds << " lookups/s" << std::endl;
+    }
+
+  // Lookups of unregistered IDs create no input source, so only
+  // measure reading the snapshot.  For comparison, atomic_load of a
+  // single shared_ptr by every thread (one lock and reference count
+  // per lookup) is also measured.
+  const std::string missing("urn:ome-common-test:unregistered");
+  const int lookup_iterations = 1000000;
+  std::shared_ptr<const std::string> shared(std::make_shared<const std::string>(missing));
+  for (unsigned int nthreads = 1U; nthreads <= max_threads; nthreads *= 2U)
+    {
+      std::atomic<std::size_t> found(0);
+      std::vector<std::thread> threads;
+      benchmark_timer timer;
+      for (unsigned int t = 0; t < nthreads; ++t)
+        {
+          threads.emplace_back([&]()
+            {
+              for (int i = 0; i < lookup_iterations; ++i)
+                if (resolver.getSource(missing))
+                  ++found;
+            });
+        }
+      for (auto& thread : threads)
+        thread.join();
+      double resolver_seconds = timer.seconds();
+
+      threads.clear();
+      timer.restart();
+      for (unsigned int t = 0; t < nthreads; ++t)
+        {
+          threads.emplace_back([&]()
+            {
+              for (int i = 0; i < lookup_iterations; ++i)
+                if (std::atomic_load(&shared)->empty())
+                  ++found;
+            });
+        }
+      for (auto& thread : threads)
+        thread.join();
+      double atomic_seconds = timer.seconds();
+
+      ASSERT_EQ(0U, found);
+      std::cout << "EntityResolver snapshot (" << nthreads << " threads): "
+                << (nthreads * lookup_iterations) / resolver_seconds << " lookups/s; "
+                << "shared_ptr atomic_load: "
+                << (nthreads * lookup_iterations) / atomic_seconds << " loads/s" << std::endl;
+    }
+}
+
+TEST_P(XercesTest, EntityResolverPreload)
+{
+  const std::vector<std::string> ids(resolver.getEntityIds());
+  ASSERT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+
+  xml::EntityResolver::PreloadStatistics stats(resolver.preload(2));
+  EXPECT_EQ(ids.size(), stats.loaded);
+  EXPECT_EQ(0U, stats.failed);
+  EXPECT_LE(stats.threads, 2U);
+  if (!ids.empty())
+    {
+      EXPECT_LT(0U, stats.bytes);
+      EXPECT_LT(0, stats.elapsed.count());
+    }
+
+  // All loaded; nothing further to do.
+  stats = resolver.preload();
+  EXPECT_EQ(0U, stats.loaded);
+  EXPECT_EQ(0U, stats.failed);
+  EXPECT_EQ(0U, stats.bytes);
+
+  for (const auto& id : ids)
+    {
+      std::unique_ptr<xercesc::InputSource> source(resolver.getSource(id));
+      EXPECT_TRUE(source.get() != nullptr);
+    }
+
+  xml::EntityResolver catalog;
+  catalog.registerCatalog(boost::filesystem::path(PROJECT_SOURCE_DIR "/test/ome-common/data/schema/catalog.xml"), true);
+  stats = catalog.preload();
+  EXPECT_EQ(0U, stats.loaded);
+}
+
+TEST_P(XercesTest, EntityResolverMemory)
+{
+  const std::string id("urn:ome-common-test:memory.xsd");
+  std::shared_ptr<const std::string> data(std::make_shared<const std::string>("<?xml version=\"1.0\"?>\n<schema/>\n"));
+
+  xml::EntityResolver r;
+  r.registerEntity(id, data);
+  // Identical content may be registered again.
+  r.registerEntity(id, std::make_shared<const std::string>(*data));
+  ASSERT_THROW(r.registerEntity(id, std::make_shared<const std::string>("<schema/>")), std::runtime_error);
+  ASSERT_THROW(r.registerEntity(id, std::shared_ptr<const std::string>()), std::runtime_error);
+  ASSERT_THROW(r.registerEntity(id, boost::filesystem::path(PROJECT_SOURCE_DIR "/test/ome-common/data/schema/external/xml.xsd")), std::runtime_error);
+
+  std::unique_ptr<xercesc::InputSource> source(r.getSource(id));
+  ASSERT_TRUE(source != nullptr);
+  ASSERT_EQ(xml::String(id), xml::String(source->getSystemId()));
+
+  std::unique_ptr<xercesc::BinInputStream> stream(source->makeStream());
+  XMLByte bytes[256];
+  XMLSize_t count = stream->readBytes(bytes, sizeof(bytes));
+  ASSERT_EQ(data->size(), count);
+  ASSERT_TRUE(std::equal(data->begin(), data->end(), reinterpret_cast<const char *>(bytes)));
+
+  // Nothing to load from disk.
+  xml::EntityResolver::PreloadStatistics stats(r.preload());
+  EXPECT_EQ(0U, stats.loaded);
+  EXPECT_EQ(0U, stats.failed);
+}
+
+namespace
+{
+
+  // Check that schemas embedded from the test catalog validate
+  // exactly as the catalog read at run time.
+  void
+  check_embedded_schemas(const XercesTestParameters& params,
+                         const xml::EntityResolver&  catalog,
+                         xml::EntityResolver&        embedded)
+  {
+    if (params.resolver != XercesTestParameters::Resolver::CATALOG)
+      return;
+
+    ASSERT_EQ(catalog.getEntityIds(), embedded.getEntityIds());
+
+    xml::dom::Document doc;
+    if (params.valid)
+      {
+        ASSERT_NO_THROW(doc = ome::common::xml::dom::createDocument(boost::filesystem::path(params.filename), embedded));
+        ASSERT_TRUE(doc != nullptr);
+      }
+    else
+      {
+        ASSERT_THROW(doc = ome::common::xml::dom::createDocument(boost::filesystem::path(params.filename), embedded), std::runtime_error);
+      }
+  }
+
+}
+
+TEST_P(XercesTest, EntityResolverEmbedded)
+{
+  xml::EntityResolver r;
+  std::size_t count = r.registerEmbeddedSchemas();
+
+#ifdef OME_HAVE_EMBEDDED_SCHEMAS
+  ASSERT_LT(0U, count);
+#else
+  ASSERT_EQ(0U, count);
+#endif
+
+  const std::vector<std::string> ids(r.getEntityIds());
+  ASSERT_EQ(count, ids.size());
+  for (const auto& id : ids)
+    {
+      std::unique_ptr<xercesc::InputSource> source(r.getSource(id));
+      ASSERT_TRUE(source != nullptr);
+    }
+
+  // Registering again is harmless.
+  ASSERT_EQ(count, r.registerEmbeddedSchemas());
+  ASSERT_EQ(ids, r.getEntityIds());
+
+  // If the test catalog was embedded in the library, the embedded
+  // schemas alone must validate exactly as the catalog read at run
+  // time.
+  if (std::find(ids.begin(), ids.end(),
+                "http://www.openmicroscopy.org/Schemas/OME/2012-06/ome.xsd") != ids.end())
+    check_embedded_schemas(GetParam(), resolver, r);
+}
+
+#ifdef OME_HAVE_EMBEDDED_TEST_SCHEMAS
+TEST_P(XercesTest, EntityResolverEmbeddedTestCatalog)
+{
+  // The library was built without embedded schemas, so the table
+  // generated from the test catalog is linked into this test
+  // instead; register it as registerEmbeddedSchemas() would.
+  ASSERT_LT(0U, xml::detail::embedded_schema_count);
+
+  xml::EntityResolver r;
+  for (std::size_t i = 0; i < xml::detail::embedded_schema_count; ++i)
+    {
+      const xml::detail::embedded_schema& schema(xml::detail::embedded_schemas[i]);
+      const char *begin = reinterpret_cast<const char *>(schema.data);
+      ASSERT_EQ('\0', begin[schema.size]);
+      r.registerEntity(schema.id,
+                       std::make_shared<const std::string>(begin, begin + schema.size));
+    }
+
+  check_embedded_schemas(GetParam(), resolver, r);
+}
+#endif // OME_HAVE_EMBEDDED_TEST_SCHEMAS
+
+namespace
+{
+
+  void
+  write_catalog(const boost::filesystem::path&                         file,
+                const std::vector<std::pair<std::string, std::string>>& entries)
+  {
+    std::ofstream out(file.string().c_str());
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<catalog xmlns=\"urn:oasis:names:tc:entity:xmlns:xml:catalog\">\n";
+    for (const auto& entry : entries)
+      out << "  <uri name=\"" << entry.first << "\" uri=\"" << entry.second << "\"/>\n";
+    out << "</catalog>\n";
+  }
+
+}
+
+TEST_P(XercesTest, EntityResolverCatalogCache)
+{
+  const boost::filesystem::path dir(PROJECT_BINARY_DIR "/test/ome-common/catalog-cache");
+  const boost::filesystem::path catalog(dir / "catalog.xml");
+  boost::filesystem::remove_all(dir);
+  boost::filesystem::create_directories(dir);
+  boost::filesystem::copy_file(PROJECT_SOURCE_DIR "/test/ome-common/data/schema/external/xml.xsd", dir / "xml.xsd");
+  boost::filesystem::copy_file(PROJECT_SOURCE_DIR "/test/ome-common/data/schema/external/XMLSchema.xsd", dir / "XMLSchema.xsd");
+
+  write_catalog(catalog, {{"urn:ome-common-test:xml.xsd", "xml.xsd"}});
+
+  xml::EntityResolver r1;
+  r1.registerCatalog(catalog);
+  const std::vector<std::string> ids1(r1.getEntityIds());
+  ASSERT_EQ(1U, ids1.size());
+
+  // Cached; identical registrations are harmless.
+  r1.registerCatalog(catalog);
+  ASSERT_EQ(ids1, r1.getEntityIds());
+  xml::EntityResolver r2;
+  r2.registerCatalog(catalog);
+  ASSERT_EQ(ids1, r2.getEntityIds());
+
+  // A changed catalog is parsed again.
+  write_catalog(catalog, {{"urn:ome-common-test:xml.xsd", "xml.xsd"},
+                          {"urn:ome-common-test:XMLSchema.xsd", "XMLSchema.xsd"}});
+  xml::EntityResolver r3;
+  r3.registerCatalog(catalog);
+  ASSERT_EQ(2U, r3.getEntityIds().size());
+
+  // Conflicting entries are not registered.
+  write_catalog(catalog, {{"urn:ome-common-test:other.xsd", "xml.xsd"},
+                          {"urn:ome-common-test:xml.xsd", "XMLSchema.xsd"}});
+  ASSERT_THROW(r1.registerCatalog(catalog), std::runtime_error);
+  ASSERT_EQ(ids1, r1.getEntityIds());
+
+  // A rewrite of the same size, within the same second, is detected.
+  boost::filesystem::copy_file(dir / "xml.xsd", dir / "a.xsd");
+  boost::filesystem::copy_file(dir / "xml.xsd", dir / "b.xsd");
+  write_catalog(catalog, {{"urn:ome-common-test:same.xsd", "a.xsd"}});
+  boost::uintmax_t size = boost::filesystem::file_size(catalog);
+  std::time_t mtime = boost::filesystem::last_write_time(catalog);
+  xml::EntityResolver r4;
+  r4.registerCatalog(catalog);
+  write_catalog(catalog, {{"urn:ome-common-test:same.xsd", "b.xsd"}});
+  boost::filesystem::last_write_time(catalog, mtime);
+  ASSERT_EQ(size, boost::filesystem::file_size(catalog));
+  xml::EntityResolver r5;
+  r5.registerCatalog(catalog);
+  std::unique_ptr<xercesc::InputSource> source(r5.getSource(std::string("urn:ome-common-test:same.xsd")));
+  ASSERT_TRUE(source != nullptr);
+  ASSERT_EQ(xml::String(boost::filesystem::canonical(dir / "b.xsd").string()),
+            xml::String(source->getSystemId()));
+
+  // Clearing the cache does not affect existing registrations.
+  xml::EntityResolver::clearCatalogCache();
+  ASSERT_EQ(1U, r5.getEntityIds().size());
+  xml::EntityResolver r6;
+  r6.registerCatalog(catalog);
+  ASSERT_EQ(r5.getEntityIds(), r6.getEntityIds());
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkRegisterCatalog)
+{
+  const boost::filesystem::path catalog(PROJECT_SOURCE_DIR "/test/ome-common/data/schema/catalog.xml");
+  const int iterations = 1000;
+
+  benchmark_timer timer;
+  for (int i = 0; i < iterations; ++i)
+    {
+      xml::EntityResolver r;
+      r.registerCatalog(catalog);
+    }
+  double seconds = timer.seconds();
+  std::cout << "EntityResolver::registerCatalog: "
+            << (seconds * 1.0e6) / iterations << " µs/registration" << std::endl;
+}
+
+TEST_P(XercesTest, DISABLED_BenchmarkEntityResolverPreload)
+{
+  const boost::filesystem::path catalog(PROJECT_SOURCE_DIR "/test/ome-common/data/schema/catalog.xml");
+
+  unsigned int max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  for (unsigned int nthreads = 1U; nthreads <= max_threads; nthreads *= 2U)
+    {
+      xml::EntityResolver r;
+      r.registerCatalog(catalog);
+      xml::EntityResolver::PreloadStatistics stats(r.preload(nthreads));
+      double seconds = std::chrono::duration<double>(stats.elapsed).count();
+      std::cout << "EntityResolver preload (" << stats.threads << " threads): "
+                << stats.loaded << " entities, " << stats.bytes << " bytes in "
+                << seconds * 1000.0 << " ms" << std::endl;
+    }
+}
+
 const std::vector<XercesTestParameters> params =
   {
     // { PROJECT_SOURCE_DIR "/test/ome-common/data/18x24y5z5t2c8b-text.ome", XercesTestParameters::Resolver::NONE },